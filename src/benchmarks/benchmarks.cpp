@@ -0,0 +1,160 @@
+#include "benchmarks.h"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace benchmarks = octahedron::benchmarks;
+
+using std::chrono::nanoseconds;
+
+double benchmarks::result::bytes_per_second() const noexcept {
+	if (median.count() <= 0)
+		return (0.0);
+	return (static_cast<double>(bytes) * 1e9 / static_cast<double>(median.count()));
+}
+
+double benchmarks::result::items_per_second() const noexcept {
+	if (median.count() <= 0)
+		return (0.0);
+	return (static_cast<double>(items) * 1e9 / static_cast<double>(median.count()));
+}
+
+void benchmarks::benchmark::set_bytes(uint64 bytes) noexcept {
+	res.bytes = bytes;
+}
+
+void benchmarks::benchmark::set_items(uint64 items) noexcept {
+	res.items = items;
+}
+
+void benchmarks::benchmark::fail(std::string reason, const std::source_location &where) {
+	std::filesystem::path filepath{where.file_name()};
+
+	if (reason.empty()) {
+		g_logger->log(log_level::BASIC, "{} {} ({}/{}:{})", failure, name, filepath.parent_path().stem(), filepath.filename(), where.line());
+	}
+	else {
+		g_logger->log(log_level::BASIC, "{} {} ({}/{}:{}): {}", failure, name, filepath.parent_path().stem(), filepath.filename(), where.line(), reason);
+	}
+	state = status::failure;
+}
+
+void benchmarks::benchmark::_measure(const std::function<void()> &body) {
+	if (res.iterations > 0) {
+		fail("measure() called more than once");
+		return;
+	}
+
+	const run_settings &s = *settings;
+	size_t              batch = 1;
+	auto                warmup_end = clock::now() + s.warmup;
+
+	// the warmup also finds how many iterations make a sample long enough to time
+	while (true) {
+		auto start = clock::now();
+
+		for (size_t i = 0; i < batch; ++i)
+			body();
+
+		auto end = clock::now();
+
+		if (end - start < s.min_sample_time)
+			batch *= 2;
+		else if (end >= warmup_end)
+			break;
+	}
+
+	std::vector<nanoseconds> samples;
+	auto                     measure_end = clock::now() + s.duration;
+
+	samples.reserve(s.max_samples);
+	while (samples.size() < s.max_samples && (samples.size() < s.min_samples || clock::now() < measure_end)) {
+		auto start = clock::now();
+
+		for (size_t i = 0; i < batch; ++i)
+			body();
+		samples.push_back((clock::now() - start) / batch);
+		res.iterations += batch;
+	}
+	std::ranges::sort(samples);
+	res.min = samples.front();
+	res.median = samples[samples.size() / 2];
+	res.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+}
+
+void benchmarks::benchmark::run(const run_settings &run_settings) {
+	g_logger->log(log_level::BASIC, "{} {}", starting, name);
+	settings = &run_settings;
+	try {
+		fun(*this);
+		if (state != status::failure && res.iterations == 0)
+			fail("nothing was measured");
+	} catch (const std::exception &e) {
+		g_logger->log(log_level::BASIC, "{} {}: exception `{}`", failure, name, e.what());
+		state = status::failure;
+	} catch (...) {
+		g_logger->log(log_level::BASIC, "{} {}: exception (unknown)", failure, name);
+		state = status::failure;
+	}
+	if (state != status::failure) {
+		state = status::success;
+		g_logger->log(log_level::BASIC, "{} {}: median {} {}", done, name, format_duration(res.median), format_throughput(res));
+	}
+}
+
+auto benchmarks::benchmark::get_status() const noexcept -> status {
+	return (state);
+}
+
+auto benchmarks::benchmark::get_name() const noexcept -> const std::string& {
+	return (name);
+}
+
+auto benchmarks::benchmark::get_description() const noexcept -> const std::string& {
+	return (description);
+}
+
+auto benchmarks::benchmark::get_result() const noexcept -> const result& {
+	return (res);
+}
+
+auto benchmarks::make_benchmark_suite(std::string name) -> benchmark_suite & {
+	auto &ret = g_benchmarks.emplace_back();
+
+	ret.name = std::move(name);
+	return (ret);
+}
+
+std::string benchmarks::format_duration(nanoseconds duration) {
+	auto ns = static_cast<double>(duration.count());
+
+	if (ns < 1e3)
+		return (fmt::format("{:.0f}ns", ns));
+	if (ns < 1e6)
+		return (fmt::format("{:.2f}us", ns / 1e3));
+	if (ns < 1e9)
+		return (fmt::format("{:.2f}ms", ns / 1e6));
+	return (fmt::format("{:.2f}s", ns / 1e9));
+}
+
+std::string benchmarks::format_throughput(const result &res) {
+	if (res.bytes > 0) {
+		double rate = res.bytes_per_second();
+
+		if (rate >= 1024.0 * 1024 * 1024)
+			return (fmt::format("{:.2f} GiB/s", rate / (1024.0 * 1024 * 1024)));
+		return (fmt::format("{:.2f} MiB/s", rate / (1024.0 * 1024)));
+	}
+	if (res.items > 0) {
+		double rate = res.items_per_second();
+
+		if (rate >= 1e9)
+			return (fmt::format("{:.2f} G/s", rate / 1e9));
+		if (rate >= 1e6)
+			return (fmt::format("{:.2f} M/s", rate / 1e6));
+		if (rate >= 1e3)
+			return (fmt::format("{:.2f} k/s", rate / 1e3));
+		return (fmt::format("{:.0f}/s", rate));
+	}
+	return (std::string{});
+}
@@ -0,0 +1,177 @@
+#ifndef OCTAHEDRON_BENCHMARKS_H_
+#define OCTAHEDRON_BENCHMARKS_H_
+
+#include <chrono>
+#include <concepts>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <io/logger.h>
+
+#include <fmt/color.h>
+
+namespace octahedron::benchmarks {
+
+inline const auto failure = fmt::format("[{}]", styled("FAILURE", fg(fmt::terminal_color::red)));
+inline const auto regression = fmt::format("[{}]", styled("REGRESSION", fg(fmt::terminal_color::red)));
+inline const auto improvement = fmt::format("[{}]", styled("IMPROVEMENT", fg(fmt::terminal_color::green)));
+inline const auto starting = fmt::format("[{}]", styled("STARTING", fg(fmt::terminal_color::bright_blue)));
+inline const auto done = fmt::format("[{}]", styled("DONE", fg(fmt::terminal_color::green)));
+
+using clock = std::chrono::steady_clock;
+
+/**
+ * \brief How long a benchmark runs its body, and how its samples are made.
+ */
+struct run_settings {
+	std::chrono::milliseconds warmup{50};
+	std::chrono::milliseconds duration{500};
+	size_t                    min_samples{10};
+	size_t                    max_samples{200};
+	// a sample runs the body as many times as needed to last at least this long, so the clock's resolution does not matter
+	std::chrono::microseconds min_sample_time{200};
+};
+
+struct result {
+	std::chrono::nanoseconds min{0};
+	std::chrono::nanoseconds median{0};
+	std::chrono::nanoseconds p99{0};
+	size_t                   iterations{0};
+	uint64                   bytes{0};
+	uint64                   items{0};
+
+	/**
+	 * \brief Returns the bytes processed per second at the median, or 0 if the benchmark processes no bytes.
+	 */
+	[[nodiscard]] double bytes_per_second() const noexcept;
+
+	[[nodiscard]] double items_per_second() const noexcept;
+};
+
+class benchmark {
+public:
+	enum class status {
+		not_executed,
+		success,
+		failure
+	};
+
+	benchmark() = default;
+
+	template <typename Fun>
+	benchmark(std::string n, std::string desc, Fun&& function) :
+		name{std::move(n)}, description{std::move(desc)}, fun{std::forward<Fun>(function)}
+	{}
+
+	benchmark(const benchmark &) = delete;
+	benchmark(benchmark&&) = default;
+
+	benchmark& operator=(const benchmark&) = delete;
+	benchmark& operator=(benchmark&&) = default;
+
+	~benchmark() = default;
+
+	/**
+	 * \brief Times `body`: runs it during the warmup, then in samples until the duration or the maximum number of samples is reached.
+	 *
+	 * Called once by the fixture after its setup; only what happens in `body` is timed.
+	 */
+	template <std::invocable Body>
+	void measure(Body &&body) {
+		_measure(std::function<void()>{std::ref(body)});
+	}
+
+	/**
+	 * \brief Sets how many bytes one iteration of the body processes, for the throughput.
+	 */
+	void set_bytes(uint64 bytes) noexcept;
+
+	/**
+	 * \brief Sets how many items one iteration of the body processes, for the throughput.
+	 */
+	void set_items(uint64 items) noexcept;
+
+	void fail(std::string reason = {}, const std::source_location &where = std::source_location::current());
+
+	void run(const run_settings &settings);
+
+	status get_status() const noexcept;
+
+	const std::string& get_name() const noexcept;
+
+	const std::string& get_description() const noexcept;
+
+	const result& get_result() const noexcept;
+
+private:
+	void _measure(const std::function<void()> &body);
+
+	std::string                     name = {};
+	std::string                     description = {};
+	std::function<void(benchmark&)> fun = {};
+	const run_settings             *settings = nullptr;
+	result                          res = {};
+	status                          state = status::not_executed;
+};
+
+struct benchmark_suite {
+	benchmark_suite() = default;
+
+	benchmark_suite(const benchmark_suite&) = delete;
+
+	benchmark_suite(benchmark_suite&&) = default;
+
+	benchmark_suite& operator=(const benchmark_suite&) = delete;
+
+	benchmark_suite& operator=(benchmark_suite&&) = default;
+
+	std::string            name;
+	std::vector<benchmark> benchmarks;
+
+	template <typename Fun>
+	requires (std::is_invocable_r_v<void, Fun, benchmark&>)
+	benchmark &make_benchmark(std::string n, std::string desc, Fun fun) {
+		return (benchmarks.emplace_back(std::move(n), std::move(desc), std::forward<Fun>(fun)));
+	}
+};
+
+// suites are referenced by the globals they are created into, a deque keeps them in place when more are added
+inline std::deque<benchmark_suite> g_benchmarks;
+
+inline std::optional<logger<std::ostream&>> g_logger;
+
+benchmark_suite &make_benchmark_suite(std::string name);
+
+/**
+ * \brief Formats a duration with the unit that suits it best, from nanoseconds to seconds.
+ */
+std::string format_duration(std::chrono::nanoseconds duration);
+
+/**
+ * \brief Formats the throughput of a result in bytes or items per second, or returns an empty string if it has none.
+ */
+std::string format_throughput(const result &res);
+
+/**
+ * \brief Keeps the compiler from optimizing away a value whose computation is being measured.
+ */
+template <typename T>
+inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void *sink;
+
+	sink = &value;
+#endif
+}
+
+} // namespace octahedron::benchmarks
+
+#endif
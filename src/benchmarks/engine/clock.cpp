@@ -0,0 +1,31 @@
+#include "engine/engine.h"
+
+#include <engine/clock.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+constexpr octahedron::microseconds period{500};
+} // namespace
+
+// a tick lasts the period plus how late the clock woke up, so the overshoot is what moves against a baseline
+[[maybe_unused]] benchmark &clock_precise_benchmark = g_engine_benchmarks.make_benchmark("clock precise pacing", "500us ticks paced by sleeping then yielding", [](benchmark& self) {
+	octahedron::game_clock clock{octahedron::pacing::PRECISE};
+
+	clock.update();
+	self.set_items(1);
+	self.measure([&] {
+		do_not_optimize(clock.update(period));
+	});
+});
+
+[[maybe_unused]] benchmark &clock_sleep_benchmark = g_engine_benchmarks.make_benchmark("clock sleep pacing", "500us ticks paced by a single sleep, for reference", [](benchmark& self) {
+	octahedron::game_clock clock{octahedron::pacing::SLEEP};
+
+	clock.update();
+	self.set_items(1);
+	self.measure([&] {
+		do_not_optimize(clock.update(period));
+	});
+});
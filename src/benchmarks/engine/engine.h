@@ -0,0 +1,12 @@
+#ifndef OCTAHEDRON_BENCHMARKS_ENGINE_H_
+#define OCTAHEDRON_BENCHMARKS_ENGINE_H_
+
+#include "benchmarks.h"
+
+namespace octahedron::benchmarks {
+
+inline benchmark_suite& g_engine_benchmarks = make_benchmark_suite("Engine");
+
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "engine/engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <engine/job_system.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+constexpr size_t elements = 1 << 20;
+constexpr size_t max_workers = 64;
+
+/**
+ * \brief Registers a parallel_for over `elements` values with `threads` workers, for scaling to be read across them.
+ */
+benchmark &make_parallel_for_benchmark(size_t threads) {
+	return (g_engine_benchmarks.make_benchmark(fmt::format("parallel_for {} workers", threads), "Transforming an array on the job system", [threads](benchmark& self) {
+		octahedron::job_system jobs{threads};
+		std::vector<float>     values(elements, 2.0f);
+
+		self.set_items(elements);
+		self.measure([&] {
+			jobs.parallel_for(0, values.size(), [&values](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+					values[i] = std::sqrt(values[i] * values[i] + 1.0f);
+			});
+			do_not_optimize(values);
+		});
+	}));
+}
+
+/**
+ * \brief Registers the parallel_for benchmarks, from 1 worker up to the hardware threads by powers of two, capped at `max_workers`.
+ */
+bool make_parallel_for_benchmarks() {
+	size_t hardware = std::clamp(size_t{std::thread::hardware_concurrency()}, size_t{1}, max_workers);
+
+	for (size_t threads = 1; threads < hardware; threads *= 2)
+		make_parallel_for_benchmark(threads);
+	make_parallel_for_benchmark(hardware);
+	return (true);
+}
+} // namespace
+
+[[maybe_unused]] bool parallel_for_benchmarks = make_parallel_for_benchmarks();
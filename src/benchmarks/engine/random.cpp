@@ -0,0 +1,60 @@
+#include "engine/engine.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <tools/random.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+constexpr size_t count = 1 << 16;
+} // namespace
+
+[[maybe_unused]] benchmark &mt19937_benchmark = g_engine_benchmarks.make_benchmark("mt19937_64", "Filling an array from std::mt19937_64, for reference", [](benchmark& self) {
+	std::mt19937_64                 rng{42};
+	std::vector<octahedron::uint64> out(count);
+
+	self.set_items(count);
+	self.measure([&] {
+		for (octahedron::uint64 &value : out)
+			value = rng();
+		do_not_optimize(out);
+	});
+});
+
+[[maybe_unused]] benchmark &random_stream_benchmark = g_engine_benchmarks.make_benchmark("random_stream generate", "Filling an array from a random_stream", [](benchmark& self) {
+	octahedron::random_stream       rng{42};
+	std::vector<octahedron::uint64> out(count);
+
+	self.set_items(count);
+	self.measure([&] {
+		rng.generate(std::span{out});
+		do_not_optimize(out);
+	});
+});
+
+[[maybe_unused]] benchmark &random_stream_single_benchmark = g_engine_benchmarks.make_benchmark("random_stream single", "Drawing values one at a time from a random_stream", [](benchmark& self) {
+	octahedron::random_stream       rng{42};
+	std::vector<octahedron::uint64> out(count);
+
+	self.set_items(count);
+	self.measure([&] {
+		for (octahedron::uint64 &value : out)
+			value = rng();
+		do_not_optimize(out);
+	});
+});
+
+[[maybe_unused]] benchmark &unit_vectors_benchmark = g_engine_benchmarks.make_benchmark("random_stream unit vectors", "Generating directions on the unit sphere", [](benchmark& self) {
+	octahedron::random_stream         rng{42};
+	std::vector<std::array<float, 3>> out(count);
+
+	self.set_items(count);
+	self.measure([&] {
+		rng.generate_unit_vectors(std::span{out});
+		do_not_optimize(out);
+	});
+});
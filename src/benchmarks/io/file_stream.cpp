@@ -0,0 +1,434 @@
+#include "io/io.h"
+
+#include <array>
+#include <vector>
+
+#include <engine/job_system.h>
+#include <io/buffered_stream.h>
+#include <io/gz_file_stream.h>
+#include <io/utf8_stream.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+using octahedron::open_flags;
+
+constexpr size_t file_size = 4 << 20;
+// about the size of a long demo
+constexpr size_t large_file_size = size_t{256} << 20;
+
+/**
+ * \brief Byte `i` of data that compresses about as well as map data does: runs of repeated values with some noise.
+ */
+std::byte data_byte(size_t i) {
+	return (static_cast<std::byte>((i / 13) ^ (i * 2654435761u >> 27)));
+}
+
+std::vector<std::byte> make_data(size_t size) {
+	std::vector<std::byte> ret(size);
+
+	for (size_t i = 0; i < size; ++i)
+		ret[i] = data_byte(i);
+	return (ret);
+}
+
+bool write_file(octahedron::file_system &fs, std::string_view path, std::span<const std::byte> data) {
+	auto f = fs.open(path, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+	return (f && f->write(data) == data.size());
+}
+
+bool write_gz_file(octahedron::file_system &fs, std::string_view path, std::span<const std::byte> data) {
+	auto f = fs.open_gz(path, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+	return (f && f->write(data) == data.size());
+}
+
+/**
+ * \brief Writes `size` bytes of make_data()'s data to a gzip file a block at a time, so that it is never all in memory.
+ */
+bool write_large_gz_file(octahedron::file_system &fs, std::string_view path, size_t size) {
+	auto                   f = fs.open_gz(path, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY | open_flags::PARALLEL);
+	std::vector<std::byte> block(1 << 20);
+
+	if (!f)
+		return (false);
+	for (size_t offset = 0; offset < size; offset += block.size()) {
+		size_t block_size = std::min(block.size(), size - offset);
+
+		for (size_t i = 0; i < block_size; ++i)
+			block[i] = data_byte(offset + i);
+		if (f->write({block.data(), block_size}) != block_size)
+			return (false);
+	}
+	return (true);
+}
+
+/**
+ * \brief Octree cube codes, as in .ogz maps.
+ */
+enum : char { OCTSAV_CHILDREN = 0, OCTSAV_EMPTY, OCTSAV_SOLID, OCTSAV_NORMAL };
+
+/**
+ * \brief Writes 8 cubes laid out like the octree of an .ogz map, subdividing some of them down to `depth`.
+ */
+void write_cubes(octahedron::file_stream &f, int depth, uint32_t &seed) {
+	for (int i = 0; i < 8; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+
+		uint32_t r = seed >> 8;
+
+		if (depth > 0 && (r & 3) != 0) {
+			f.put<char>(OCTSAV_CHILDREN);
+			write_cubes(f, depth - 1, seed);
+			continue;
+		}
+
+		char code = static_cast<char>(OCTSAV_EMPTY + (r >> 2) % 3);
+
+		if (r & 0x10)
+			code |= 0x40;
+		if (r & 0x20)
+			code |= 0x20;
+		f.put<char>(code);
+		if ((code & 0x7) == OCTSAV_NORMAL) {
+			for (int e = 0; e < 12; ++e)
+				f.put<uint8_t>(static_cast<uint8_t>(0x88 + ((r >> e) & 0x11)));
+		}
+		for (int t = 0; t < 6; ++t)
+			f.put<uint16_t>(static_cast<uint16_t>(1 + ((r >> t) & 7)));
+		if (code & 0x40)
+			f.put<uint16_t>(1);
+		if (code & 0x20) {
+			uint8_t mask = static_cast<uint8_t>((r >> 6) & 0x3F);
+
+			f.put<uint8_t>(mask);
+			for (int s = 0; s < 6; ++s) {
+				if (!(mask & (1 << s)))
+					continue;
+
+				uint8_t verts = static_cast<uint8_t>(1 + ((r >> s) & 3));
+
+				f.put<uint8_t>(verts);
+				for (uint8_t v = 0; v < verts; ++v) {
+					f.put<uint16_t>(static_cast<uint16_t>(r + v));
+					f.put<uint16_t>(static_cast<uint16_t>(r - v));
+				}
+			}
+		}
+	}
+}
+
+/**
+ * \brief Reads back cubes written by write_cubes() the way the map loader does, one small typed get at a time.
+ */
+template <typename S>
+size_t read_cubes(S &f) {
+	size_t cubes = 0;
+
+	for (int i = 0; i < 8; ++i) {
+		char code = f.template get<char>();
+
+		++cubes;
+		if ((code & 0x7) == OCTSAV_CHILDREN) {
+			cubes += read_cubes(f);
+			continue;
+		}
+		if ((code & 0x7) == OCTSAV_NORMAL) {
+			std::array<std::byte, 12> edges;
+
+			f.read(edges);
+		}
+		for (int t = 0; t < 6; ++t)
+			cubes += f.template get<uint16_t>() & 1;
+		if (code & 0x40)
+			cubes += f.template get<uint16_t>() & 1;
+		if (code & 0x20) {
+			uint8_t mask = f.template get<uint8_t>();
+
+			for (int s = 0; s < 6; ++s) {
+				if (!(mask & (1 << s)))
+					continue;
+
+				uint8_t verts = f.template get<uint8_t>();
+
+				for (uint8_t v = 0; v < verts; ++v)
+					cubes += (f.template get<uint16_t>() ^ f.template get<uint16_t>()) & 1;
+			}
+		}
+	}
+	return (cubes);
+}
+
+bool write_map_file(octahedron::file_system &fs, std::string_view path) {
+	auto     f = fs.open_gz(path, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+	uint32_t seed = 42;
+
+	if (!f)
+		return (false);
+	write_cubes(*f, 6, seed);
+	return (f->flush());
+}
+} // namespace
+
+[[maybe_unused]] benchmark &file_system_open_benchmark = g_io_benchmarks.make_benchmark("file_system::open", "Opening and closing a file through the search paths", [](benchmark& self) {
+	temp_dir                dir{"octahedron_open_benchmark"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_file(fs, "small.bin", make_data(64))) {
+		self.fail("failed to write the test file");
+		return;
+	}
+	self.set_items(1);
+	self.measure([&] {
+		auto f = fs.open("small.bin", open_flags::INPUT | open_flags::BINARY);
+
+		if (!f)
+			self.fail("failed to open the test file");
+		do_not_optimize(f);
+	});
+});
+
+[[maybe_unused]] benchmark &raw_typed_reads_benchmark = g_io_benchmarks.make_benchmark("raw typed reads", "get<uint32_t> straight from a file", [](benchmark& self) {
+	temp_dir                dir{"octahedron_raw_reads_benchmark"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_file(fs, "data.bin", make_data(1 << 18))) {
+		self.fail("failed to write the test file");
+		return;
+	}
+
+	auto f = fs.open("data.bin", open_flags::INPUT | open_flags::BINARY);
+
+	self.set_bytes(1 << 18);
+	self.measure([&] {
+		uint32_t sum = 0;
+
+		f->seek(0, SEEK_SET);
+		for (size_t i = 0; i < (1 << 18) / sizeof(uint32_t); ++i)
+			sum += f->get<uint32_t>();
+		do_not_optimize(sum);
+	});
+});
+
+[[maybe_unused]] benchmark &buffered_typed_reads_benchmark = g_io_benchmarks.make_benchmark("buffered typed reads", "get<uint32_t> through a buffered_stream", [](benchmark& self) {
+	temp_dir                dir{"octahedron_buffered_reads_benchmark"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_file(fs, "data.bin", make_data(1 << 18))) {
+		self.fail("failed to write the test file");
+		return;
+	}
+
+	octahedron::buffered_stream f{fs.open("data.bin", open_flags::INPUT | open_flags::BINARY)};
+
+	self.set_bytes(1 << 18);
+	self.measure([&] {
+		uint32_t sum = 0;
+
+		f.seek(0, SEEK_SET);
+		for (size_t i = 0; i < (1 << 18) / sizeof(uint32_t); ++i)
+			sum += f.get<uint32_t>();
+		do_not_optimize(sum);
+	});
+});
+
+[[maybe_unused]] benchmark &map_load_raw_benchmark = g_io_benchmarks.make_benchmark("map octree raw", "Reading an .ogz-style octree straight from a gz_file_stream", [](benchmark& self) {
+	temp_dir                dir{"octahedron_map_raw_benchmark"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_map_file(fs, "map.ogz")) {
+		self.fail("failed to write the map file");
+		return;
+	}
+	self.set_bytes(fs.open_gz("map.ogz", open_flags::INPUT | open_flags::BINARY)->size());
+	self.measure([&] {
+		auto f = fs.open_gz("map.ogz", open_flags::INPUT | open_flags::BINARY);
+
+		do_not_optimize(read_cubes(*f));
+	});
+});
+
+[[maybe_unused]] benchmark &map_load_buffered_benchmark = g_io_benchmarks.make_benchmark("map octree buffered", "Reading an .ogz-style octree through a buffered_stream", [](benchmark& self) {
+	temp_dir                dir{"octahedron_map_buffered_benchmark"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_map_file(fs, "map.ogz")) {
+		self.fail("failed to write the map file");
+		return;
+	}
+	self.set_bytes(fs.open_gz("map.ogz", open_flags::INPUT | open_flags::BINARY)->size());
+	self.measure([&] {
+		octahedron::buffered_stream f{fs.open_gz("map.ogz", open_flags::INPUT | open_flags::BINARY)};
+
+		do_not_optimize(read_cubes(f));
+	});
+});
+
+[[maybe_unused]] benchmark &mapped_read_benchmark = g_io_benchmarks.make_benchmark("mapped read", "Reading a whole memory-mapped file", [](benchmark& self) {
+	temp_dir                dir{"octahedron_mapped_benchmark"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_file(fs, "data.bin", make_data(file_size))) {
+		self.fail("failed to write the test file");
+		return;
+	}
+
+	auto                   f = fs.open("data.bin", open_flags::INPUT | open_flags::BINARY | open_flags::MAPPED);
+	std::vector<std::byte> out(file_size);
+
+	if (!f) {
+		self.fail("failed to map the test file");
+		return;
+	}
+	self.set_bytes(file_size);
+	self.measure([&] {
+		f->seek(0, SEEK_SET);
+		if (f->read(out) != out.size())
+			self.fail("short read");
+		do_not_optimize(out);
+	});
+});
+
+[[maybe_unused]] benchmark &gz_write_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream write", "Compressing to a gzip file", [](benchmark& self) {
+	temp_dir                dir{"octahedron_gz_write_benchmark"};
+	octahedron::file_system fs;
+	std::vector<std::byte>  data = make_data(file_size);
+
+	fs.set_home_dir(dir.path.string());
+	self.set_bytes(file_size);
+	self.measure([&] {
+		if (!write_gz_file(fs, "data.gz", data))
+			self.fail("failed to write the gzip file");
+	});
+});
+
+[[maybe_unused]] benchmark &gz_parallel_write_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream parallel write", "Compressing to a gzip file on every core", [](benchmark& self) {
+	temp_dir                dir{"octahedron_gz_parallel_benchmark"};
+	octahedron::file_system fs;
+	octahedron::job_system  jobs;
+	std::vector<std::byte>  data = make_data(file_size);
+
+	fs.set_home_dir(dir.path.string());
+	fs.set_job_system(&jobs);
+	self.set_bytes(file_size);
+	self.measure([&] {
+		auto f = fs.open_gz("data.gz", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY | open_flags::PARALLEL);
+
+		if (!f || f->write(data) != data.size())
+			self.fail("failed to write the gzip file");
+	});
+});
+
+[[maybe_unused]] benchmark &gz_read_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream read", "Decompressing a whole gzip file", [](benchmark& self) {
+	temp_dir                dir{"octahedron_gz_read_benchmark"};
+	octahedron::file_system fs;
+	std::vector<std::byte>  out(file_size);
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_gz_file(fs, "data.gz", make_data(file_size))) {
+		self.fail("failed to write the gzip file");
+		return;
+	}
+	self.set_bytes(file_size);
+	self.measure([&] {
+		auto f = fs.open_gz("data.gz", open_flags::INPUT | open_flags::BINARY);
+
+		if (!f || f->read(out) != out.size())
+			self.fail("failed to read the gzip file");
+		do_not_optimize(out);
+	});
+});
+
+/**
+ * \brief Times 64-byte reads at random offsets of a gzip file of `size` bytes, with or without a seek index.
+ */
+void gz_seek_benchmark(benchmark &self, size_t size, bool indexed) {
+	temp_dir                dir{fmt::format("octahedron_gz_seek_benchmark_{}_{}", size, indexed)};
+	octahedron::file_system fs;
+	octahedron::job_system  jobs;
+
+	fs.set_home_dir(dir.path.string());
+	fs.set_job_system(&jobs);
+	if (!write_large_gz_file(fs, "data.gz", size)) {
+		self.fail("failed to write the gzip file");
+		return;
+	}
+
+	octahedron::bit_set<open_flags> mode = open_flags::INPUT | open_flags::BINARY;
+
+	if (indexed)
+		mode |= open_flags::INDEXED;
+
+	auto f = fs.open_gz("data.gz", mode);
+	auto gz = dynamic_cast<octahedron::gz_file_stream*>(f.get());
+
+	if (!gz || (indexed && !gz->build_index())) {
+		self.fail("failed to open the gzip file");
+		return;
+	}
+
+	std::array<std::byte, 64> buffer;
+	octahedron::uint64        seed = 0x9E3779B97F4A7C15;
+
+	self.set_items(1);
+	self.measure([&] {
+		seed = seed * 6364136223846793005 + 1442695040888963407;
+
+		size_t pos = (seed >> 16) % (size - buffer.size());
+
+		if (!gz->seek(static_cast<ssize_t>(pos), SEEK_SET) || gz->read(buffer) != buffer.size() || buffer[0] != data_byte(pos))
+			self.fail("failed to read after a seek");
+		do_not_optimize(buffer);
+	});
+}
+
+[[maybe_unused]] benchmark &gz_indexed_seek_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream indexed seek", "Random 64-byte reads in an indexed gzip file", [](benchmark& self) {
+	gz_seek_benchmark(self, file_size, true);
+});
+
+[[maybe_unused]] benchmark &gz_unindexed_seek_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream unindexed seek", "Random 64-byte reads in a gzip file, inflating from the start", [](benchmark& self) {
+	gz_seek_benchmark(self, file_size, false);
+});
+
+[[maybe_unused]] benchmark &gz_large_indexed_seek_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream indexed seek 256 MiB", "Random 64-byte reads in a demo-sized indexed gzip file", [](benchmark& self) {
+	gz_seek_benchmark(self, large_file_size, true);
+});
+
+[[maybe_unused]] benchmark &gz_large_unindexed_seek_benchmark = g_io_benchmarks.make_benchmark("gz_file_stream unindexed seek 256 MiB", "Random 64-byte reads in a demo-sized gzip file, inflating from the start", [](benchmark& self) {
+	gz_seek_benchmark(self, large_file_size, false);
+});
+
+[[maybe_unused]] benchmark &utf8_stream_benchmark = g_io_benchmarks.make_benchmark("utf8_stream read_cube", "Decoding mostly-ASCII UTF-8 text to the cube encoding", [](benchmark& self) {
+	temp_dir                dir{"octahedron_utf8_benchmark"};
+	octahedron::file_system fs;
+	std::string             text;
+
+	fs.set_home_dir(dir.path.string());
+	// mostly ASCII with accented letters here and there, like map names and chat
+	while (text.size() < (1 << 20))
+		text += "// Octahedron map script, with the occasional \xC3\xA9, \xC3\xA0 or \xC3\xBC in names\n";
+	if (!write_file(fs, "text.txt", std::as_bytes(std::span{text}))) {
+		self.fail("failed to write the test file");
+		return;
+	}
+
+	std::array<char, 4096> chunk;
+
+	self.set_bytes(text.size());
+	self.measure([&] {
+		octahedron::utf8_stream stream(fs.open("text.txt", open_flags::INPUT | open_flags::BINARY));
+		size_t                  total = 0;
+
+		while (size_t n = stream.read_cube(chunk.data(), chunk.size()))
+			total += n;
+		do_not_optimize(total);
+	});
+});
@@ -0,0 +1,32 @@
+#ifndef OCTAHEDRON_BENCHMARKS_IO_H_
+#define OCTAHEDRON_BENCHMARKS_IO_H_
+
+#include "benchmarks.h"
+
+#include <io/file_system.h>
+
+namespace octahedron::benchmarks {
+
+inline benchmark_suite& g_io_benchmarks = make_benchmark_suite("Input/Output");
+
+/**
+ * \brief Directory the file benchmarks work in, removed with everything in it when destroyed.
+ */
+struct temp_dir {
+	explicit temp_dir(std::string_view name) :
+		path{stdfs::temp_directory_path() / name} {
+		stdfs::create_directories(path);
+	}
+
+	~temp_dir() {
+		std::error_code err;
+
+		stdfs::remove_all(path, err);
+	}
+
+	stdfs::path path;
+};
+
+}
+
+#endif
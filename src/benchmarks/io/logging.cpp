@@ -0,0 +1,90 @@
+#include "io/io.h"
+
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+#include <io/async_logger.h>
+#include <io/binary_log.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+using octahedron::log_level;
+
+constexpr int lines = 1000;
+
+/**
+ * \brief Stream buffer discarding everything, so that only the loggers are measured.
+ */
+struct null_buffer : std::streambuf {
+	int overflow(int c) override {
+		return (c);
+	}
+
+	std::streamsize xsputn(const char *, std::streamsize n) override {
+		return (n);
+	}
+};
+
+struct null_stream : octahedron::io_stream {
+	using io_stream::read;
+	using io_stream::write;
+
+	size_t read(std::span<std::byte>) override {
+		return (0);
+	}
+
+	size_t write(std::span<const std::byte> buf) override {
+		return (buf.size());
+	}
+};
+} // namespace
+
+[[maybe_unused]] benchmark &logger_benchmark = g_io_benchmarks.make_benchmark("logger", "Formatting lines on the calling thread", [](benchmark& self) {
+	null_buffer                       buffer;
+	std::ostream                      out{&buffer};
+	octahedron::logger<std::ostream&> logger{out};
+
+	self.set_items(lines);
+	self.measure([&] {
+		for (int i = 0; i < lines; ++i)
+			logger.log(log_level::INFO, "frame {} took {:.2f}ms, {} entities", i, 16.6, 512);
+	});
+});
+
+[[maybe_unused]] benchmark &async_logger_benchmark = g_io_benchmarks.make_benchmark("async_logger", "Lines from 4 threads through a background writer", [](benchmark& self) {
+	constexpr int threads = 4;
+
+	null_buffer  buffer;
+	std::ostream out{&buffer};
+	octahedron::async_logger<octahedron::logger<std::ostream&>, octahedron::log_overflow::BLOCK, 64> logger{octahedron::logger<std::ostream&>{out}};
+
+	self.set_items(threads * lines);
+	self.measure([&] {
+		{
+			std::vector<std::jthread> workers;
+
+			for (int t = 0; t < threads; ++t) {
+				workers.emplace_back([&logger, t] {
+					for (int i = 0; i < lines; ++i)
+						logger.log(log_level::INFO, "thread {} frame {} took {:.2f}ms", t, i, 16.6);
+				});
+			}
+		}
+		logger.flush();
+	});
+});
+
+[[maybe_unused]] benchmark &binary_logger_benchmark = g_io_benchmarks.make_benchmark("binary_logger", "Lines stored as raw arguments", [](benchmark& self) {
+	octahedron::binary_logger logger{std::make_unique<null_stream>()};
+
+	self.set_items(lines);
+	self.measure([&] {
+		for (int i = 0; i < lines; ++i)
+			logger.log<"frame {} took {:.2f}ms, {} entities">(log_level::INFO, i, 16.6, 512);
+		logger.flush();
+	});
+});
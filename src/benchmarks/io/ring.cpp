@@ -0,0 +1,114 @@
+#include "io/io.h"
+
+#include <array>
+#include <numeric>
+#include <thread>
+
+#include <tools/concurrent_ring.h>
+#include <tools/ring.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+constexpr size_t ring_capacity = 4096;
+constexpr size_t batch_size = 1000;
+// more than a ring's worth, so that transfers wrap around its end
+constexpr size_t transfer_size = 1 << 20;
+} // namespace
+
+[[maybe_unused]] benchmark &ring_append_read_benchmark = g_io_benchmarks.make_benchmark("ring append_range/read", "Batches through a basic_ring", [](benchmark& self) {
+	auto                             ring = std::make_unique<octahedron::ring<uint32_t, ring_capacity>>();
+	std::array<uint32_t, batch_size> in;
+	std::array<uint32_t, batch_size> out;
+
+	std::iota(in.begin(), in.end(), 0);
+	// starting off the beginning of the storage, so that batches regularly straddle the end
+	ring->append_range(std::span{in}.first(17));
+	ring->read(std::span{out}.first(17));
+	self.set_bytes(sizeof(in));
+	self.set_items(in.size());
+	self.measure([&] {
+		ring->append_range(in);
+		if (ring->read(out) != out.size())
+			self.fail("read fewer values than were appended");
+		do_not_optimize(out);
+	});
+});
+
+[[maybe_unused]] benchmark &ring_push_pop_benchmark = g_io_benchmarks.make_benchmark("ring push_back/pop_front", "Single values through a basic_ring", [](benchmark& self) {
+	auto ring = std::make_unique<octahedron::ring<uint32_t, ring_capacity>>();
+
+	self.set_items(batch_size);
+	self.measure([&] {
+		uint32_t sum = 0;
+
+		for (uint32_t i = 0; i < batch_size; ++i)
+			ring->push_back(i);
+		for (size_t i = 0; i < batch_size; ++i) {
+			sum += ring->front();
+			ring->pop_front();
+		}
+		do_not_optimize(sum);
+	});
+});
+
+[[maybe_unused]] benchmark &spsc_ring_benchmark = g_io_benchmarks.make_benchmark("spsc_ring transfer", "Batches from one thread to another through an spsc_ring", [](benchmark& self) {
+	auto ring = std::make_unique<octahedron::spsc_ring<uint64_t, ring_capacity>>();
+
+	self.set_bytes(transfer_size * sizeof(uint64_t));
+	self.set_items(transfer_size);
+	self.measure([&] {
+		std::jthread producer{[&] {
+			std::array<uint64_t, 256> buf;
+
+			std::iota(buf.begin(), buf.end(), 0);
+			for (size_t sent = 0; sent < transfer_size;) {
+				if (size_t n = ring->write(std::span{buf}.first(std::min(buf.size(), transfer_size - sent))); n > 0)
+					sent += n;
+				else
+					std::this_thread::yield();
+			}
+		}};
+		std::array<uint64_t, 256> buf;
+
+		for (size_t received = 0; received < transfer_size;) {
+			if (size_t n = ring->read(buf); n > 0)
+				received += n;
+			else
+				std::this_thread::yield();
+		}
+	});
+});
+
+[[maybe_unused]] benchmark &mpsc_ring_benchmark = g_io_benchmarks.make_benchmark("mpsc_ring transfer", "Single values from 4 threads to one through an mpsc_ring", [](benchmark& self) {
+	constexpr size_t producers = 4;
+	constexpr size_t per_producer = transfer_size / 16;
+
+	auto ring = std::make_unique<octahedron::mpsc_ring<uint64_t, ring_capacity>>();
+
+	self.set_items(producers * per_producer);
+	self.measure([&] {
+		std::vector<std::jthread> threads;
+
+		for (size_t p = 0; p < producers; ++p) {
+			threads.emplace_back([&ring] {
+				for (uint64_t i = 0; i < per_producer;) {
+					if (ring->push_back(i))
+						++i;
+					else
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		std::array<uint64_t, 256> buf;
+
+		for (size_t received = 0; received < producers * per_producer;) {
+			if (size_t n = ring->read(buf); n > 0)
+				received += n;
+			else
+				std::this_thread::yield();
+		}
+	});
+});
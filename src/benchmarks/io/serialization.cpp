@@ -0,0 +1,179 @@
+#include "io/io.h"
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include <io/byteswap.h>
+#include <io/serializer.h>
+
+using namespace octahedron::benchmarks;
+
+namespace
+{
+using octahedron::endianness;
+
+constexpr size_t values = 1 << 16;
+constexpr size_t segments = 16;
+
+struct vertex {
+	float              x;
+	float              y;
+	float              z;
+	octahedron::uint16 u;
+	octahedron::uint16 v;
+	octahedron::uint32 color;
+};
+
+static_assert(octahedron::is_memcpy_serializable<vertex, endianness::native>);
+
+
+template <typename T>
+void measure_byteswap_values(benchmark &self) {
+	std::vector<T> src(values);
+	std::vector<T> dst(values);
+
+	std::iota(src.begin(), src.end(), T{0});
+	self.set_bytes(values * sizeof(T));
+	self.measure([&] {
+		octahedron::byteswap_values(dst.data(), src.data(), values, sizeof(T));
+		do_not_optimize(dst);
+	});
+}
+
+// what byteswap_values replaces: one value at a time, left to the compiler
+template <typename T>
+void measure_byteswap_loop(benchmark &self) {
+	std::vector<T> src(values);
+	std::vector<T> dst(values);
+
+	std::iota(src.begin(), src.end(), T{0});
+	self.set_bytes(values * sizeof(T));
+	self.measure([&] {
+		for (size_t i = 0; i < values; ++i)
+			dst[i] = octahedron::byteswap(src[i]);
+		do_not_optimize(dst);
+	});
+}
+} // namespace
+
+[[maybe_unused]] benchmark &byteswap_values_benchmark = g_io_benchmarks.make_benchmark("byteswap_values", "Swapping the byte order of 32-bit values", [](benchmark& self) {
+	measure_byteswap_values<octahedron::uint32>(self);
+});
+
+[[maybe_unused]] benchmark &byteswap_values16_benchmark = g_io_benchmarks.make_benchmark("byteswap_values uint16", "Swapping the byte order of 16-bit values", [](benchmark& self) {
+	measure_byteswap_values<octahedron::uint16>(self);
+});
+
+[[maybe_unused]] benchmark &byteswap_values_float_benchmark = g_io_benchmarks.make_benchmark("byteswap_values float", "Swapping the byte order of floats", [](benchmark& self) {
+	measure_byteswap_values<float>(self);
+});
+
+[[maybe_unused]] benchmark &byteswap_loop_benchmark = g_io_benchmarks.make_benchmark("byteswap loop", "Swapping 32-bit values one at a time, for reference", [](benchmark& self) {
+	measure_byteswap_loop<octahedron::uint32>(self);
+});
+
+[[maybe_unused]] benchmark &byteswap_loop16_benchmark = g_io_benchmarks.make_benchmark("byteswap loop uint16", "Swapping 16-bit values one at a time, for reference", [](benchmark& self) {
+	measure_byteswap_loop<octahedron::uint16>(self);
+});
+
+[[maybe_unused]] benchmark &byteswap_loop_float_benchmark = g_io_benchmarks.make_benchmark("byteswap loop float", "Swapping floats one at a time, for reference", [](benchmark& self) {
+	measure_byteswap_loop<float>(self);
+});
+
+[[maybe_unused]] benchmark &put_swapped_range_benchmark = g_io_benchmarks.make_benchmark("put swapped range", "Writing a range of 32-bit values in the other byte order", [](benchmark& self) {
+	std::vector<octahedron::uint32> src(values);
+	octahedron::dynamic_buffer      out;
+
+	std::iota(src.begin(), src.end(), 0u);
+	self.set_bytes(values * sizeof(octahedron::uint32));
+	self.measure([&] {
+		out.clear();
+		if (!out.put<std::vector<octahedron::uint32>, endianness::swapped>(src))
+			self.fail("failed to write the values");
+	});
+});
+
+[[maybe_unused]] benchmark &reflected_put_benchmark = g_io_benchmarks.make_benchmark("reflected put/get", "Writing and reading back reflected structs", [](benchmark& self) {
+	constexpr size_t count = 4096;
+
+	std::vector<vertex>        in(count);
+	std::vector<vertex>        back(count);
+	octahedron::dynamic_buffer buffer;
+
+	for (size_t i = 0; i < count; ++i)
+		in[i] = {static_cast<float>(i), 1.0f, -2.0f, static_cast<octahedron::uint16>(i), 3, 0xFF00FF00u};
+	self.set_bytes(count * sizeof(vertex));
+	self.measure([&] {
+		buffer.clear();
+		for (const vertex &v : in)
+			buffer.put(v);
+		buffer.reset();
+		for (vertex &v : back)
+			buffer.get(v);
+		do_not_optimize(back);
+	});
+});
+
+[[maybe_unused]] benchmark &field_put_benchmark = g_io_benchmarks.make_benchmark("field-by-field put/get", "Writing and reading back the same structs one field at a time, for reference", [](benchmark& self) {
+	constexpr size_t count = 4096;
+
+	std::vector<vertex>        in(count);
+	std::vector<vertex>        back(count);
+	octahedron::dynamic_buffer buffer;
+
+	for (size_t i = 0; i < count; ++i)
+		in[i] = {static_cast<float>(i), 1.0f, -2.0f, static_cast<octahedron::uint16>(i), 3, 0xFF00FF00u};
+	self.set_bytes(count * sizeof(vertex));
+	self.measure([&] {
+		buffer.clear();
+		for (const vertex &v : in) {
+			buffer.put(v.x);
+			buffer.put(v.y);
+			buffer.put(v.z);
+			buffer.put(v.u);
+			buffer.put(v.v);
+			buffer.put(v.color);
+		}
+		buffer.reset();
+		for (vertex &v : back) {
+			buffer.get(v.x);
+			buffer.get(v.y);
+			buffer.get(v.z);
+			buffer.get(v.u);
+			buffer.get(v.v);
+			buffer.get(v.color);
+		}
+		do_not_optimize(back);
+	});
+});
+
+[[maybe_unused]] benchmark &chained_serializer_benchmark = g_io_benchmarks.make_benchmark("chained_serializer", "Writing values across 4KiB segments", [](benchmark& self) {
+	std::vector<std::array<unsigned char, 4096>> storage(segments);
+	std::vector<std::span<unsigned char>>        spans(storage.begin(), storage.end());
+
+	self.set_bytes(segments * 4096);
+	self.measure([&] {
+		octahedron::chained_serializer<unsigned char> out{spans};
+		octahedron::uint32                            i = 0;
+
+		// 6 bytes at a time, so that values straddle segments
+		while (out.put(octahedron::uint32{i}) && out.put(octahedron::uint16{static_cast<octahedron::uint16>(i)}))
+			++i;
+		do_not_optimize(storage);
+	});
+});
+
+[[maybe_unused]] benchmark &span_serializer_benchmark = g_io_benchmarks.make_benchmark("serializer<span>", "Writing the same values to one contiguous span, for reference", [](benchmark& self) {
+	std::vector<unsigned char> storage(segments * 4096);
+
+	self.set_bytes(segments * 4096);
+	self.measure([&] {
+		octahedron::serializer<std::span<unsigned char>> out{storage.data(), storage.size()};
+		octahedron::uint32                               i = 0;
+
+		while (out.put(octahedron::uint32{i}) && out.put(octahedron::uint16{static_cast<octahedron::uint16>(i)}))
+			++i;
+		do_not_optimize(storage);
+	});
+});
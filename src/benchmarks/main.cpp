@@ -0,0 +1,246 @@
+#include "benchmarks.h"
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace octahedron::benchmarks {
+
+struct options {
+	std::string  filter;
+	std::string  baseline;
+	std::string  save;
+	double       tolerance{0.10};
+	run_settings settings;
+};
+
+/**
+ * \brief Reads the median of every benchmark of a file written by save_results(), keyed by "suite/name".
+ *
+ * Only understands the flat objects that save_results() writes, which is all a baseline needs.
+ */
+std::map<std::string, int64> load_baseline(std::string_view text) {
+	std::map<std::string, int64> ret;
+	std::string                  suite;
+	std::string                  name;
+	std::optional<int64>         median;
+	int                          depth = 0;
+	size_t                       i = 0;
+
+	auto read_string = [&]() {
+		std::string str;
+
+		for (++i; i < text.size() && text[i] != '"'; ++i) {
+			if (text[i] == '\\' && i + 1 < text.size())
+				++i;
+			str += text[i];
+		}
+		++i;
+		return (str);
+	};
+
+	auto skip_spaces = [&]() {
+		while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\r' || text[i] == '\n'))
+			++i;
+	};
+
+	while (i < text.size()) {
+		char c = text[i];
+
+		if (c == '{' || c == '[') {
+			++depth;
+			++i;
+		} else if (c == '}' || c == ']') {
+			if (c == '}' && depth == 3 && median && !name.empty())
+				ret[suite + "/" + name] = *median;
+			if (c == '}' && depth == 3) {
+				suite.clear();
+				name.clear();
+				median.reset();
+			}
+			--depth;
+			++i;
+		} else if (c == '"') {
+			std::string key = read_string();
+
+			skip_spaces();
+			if (i >= text.size() || text[i] != ':' || depth != 3)
+				continue;
+			++i;
+			skip_spaces();
+			if (i < text.size() && text[i] == '"') {
+				std::string value = read_string();
+
+				if (key == "suite")
+					suite = std::move(value);
+				else if (key == "name")
+					name = std::move(value);
+			} else if (key == "median_ns") {
+				int64 value = 0;
+				auto [end, err] = std::from_chars(text.data() + i, text.data() + text.size(), value);
+
+				if (err == std::errc{})
+					median = value;
+				i = static_cast<size_t>(end - text.data());
+			}
+		} else
+			++i;
+	}
+	return (ret);
+}
+
+std::string escape_json(std::string_view str) {
+	std::string ret;
+
+	for (char c : str) {
+		if (c == '"' || c == '\\')
+			ret += '\\';
+		ret += c;
+	}
+	return (ret);
+}
+
+bool save_results(const std::string &path) {
+	std::ofstream out{path, std::ios::binary | std::ios::trunc};
+	bool          first = true;
+
+	if (!out)
+		return (false);
+	out << "{\n\t\"benchmarks\": [\n";
+	for (const benchmark_suite &suite : g_benchmarks) {
+		for (const benchmark &b : suite.benchmarks) {
+			if (b.get_status() != benchmark::status::success)
+				continue;
+
+			const result &res = b.get_result();
+
+			out << (first ? "" : ",\n") << fmt::format(
+				"\t\t{{\"suite\": \"{}\", \"name\": \"{}\", \"min_ns\": {}, \"median_ns\": {}, \"p99_ns\": {}, \"bytes_per_second\": {:.0f}, \"items_per_second\": {:.0f}}}",
+				escape_json(suite.name), escape_json(b.get_name()), res.min.count(), res.median.count(), res.p99.count(),
+				res.bytes_per_second(), res.items_per_second()
+			);
+			first = false;
+		}
+	}
+	out << "\n\t]\n}\n";
+	return (out.good());
+}
+
+std::optional<options> parse_options(int argc, char *argv[]) {
+	options ret;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg{argv[i]};
+		bool             has_value = i + 1 < argc;
+
+		if (arg == "--filter" && has_value)
+			ret.filter = argv[++i];
+		else if (arg == "--baseline" && has_value)
+			ret.baseline = argv[++i];
+		else if (arg == "--save" && has_value)
+			ret.save = argv[++i];
+		else if (arg == "--tolerance" && has_value)
+			ret.tolerance = std::atof(argv[++i]) / 100.0;
+		else if (arg == "--quick") {
+			ret.settings.warmup = std::chrono::milliseconds{10};
+			ret.settings.duration = std::chrono::milliseconds{100};
+		} else {
+			std::cerr << "usage: benchmarks [--filter <text>] [--baseline <file.json>] [--save <file.json>] [--tolerance <percent>] [--quick]\n";
+			return (std::nullopt);
+		}
+	}
+	return (ret);
+}
+
+}
+
+namespace benchmarks = octahedron::benchmarks;
+
+int main(int argc, char *argv[]) {
+	using benchmarks::g_logger;
+	using octahedron::log_level;
+
+	g_logger.emplace(std::cout);
+
+	auto opts = benchmarks::parse_options(argc, argv);
+
+	if (!opts)
+		return (1);
+
+	std::map<std::string, octahedron::int64> baseline;
+
+	if (!opts->baseline.empty()) {
+		std::ifstream     in{opts->baseline, std::ios::binary};
+		std::stringstream text;
+
+		if (!in) {
+			g_logger->log(log_level::BASIC, "Failed to open baseline {}", opts->baseline);
+			return (1);
+		}
+		text << in.rdbuf();
+		baseline = benchmarks::load_baseline(text.str());
+	}
+
+	for (benchmarks::benchmark_suite &suite : benchmarks::g_benchmarks) {
+		for (benchmarks::benchmark &b : suite.benchmarks) {
+			if (!opts->filter.empty() && (suite.name + "/" + b.get_name()).find(opts->filter) == std::string::npos)
+				continue;
+			b.run(opts->settings);
+		}
+	}
+
+	size_t failed = 0;
+	size_t regressions = 0;
+
+	for (const benchmarks::benchmark_suite &suite : benchmarks::g_benchmarks) {
+		bool header = false;
+
+		for (const benchmarks::benchmark &b : suite.benchmarks) {
+			static constexpr char fmt_str[] = "  {: <32}{: >10}{: >10}{: >10}  {: <14}{}";
+
+			if (b.get_status() == benchmarks::benchmark::status::not_executed)
+				continue;
+			if (!header) {
+				g_logger->log(log_level::BASIC, "\nSuite {}:", suite.name);
+				g_logger->log(log_level::BASIC, fmt_str, "", "min", "median", "p99", "throughput", "");
+				header = true;
+			}
+			if (b.get_status() == benchmarks::benchmark::status::failure) {
+				g_logger->log(log_level::BASIC, "  {: <32}{}", b.get_name(), benchmarks::failure);
+				++failed;
+				continue;
+			}
+
+			const benchmarks::result &res = b.get_result();
+			std::string               comparison;
+
+			if (auto it = baseline.find(suite.name + "/" + b.get_name()); it != baseline.end() && it->second > 0) {
+				double ratio = static_cast<double>(res.median.count()) / static_cast<double>(it->second);
+
+				comparison = fmt::format("{:+.1f}% vs baseline", (ratio - 1.0) * 100.0);
+				if (ratio > 1.0 + opts->tolerance) {
+					comparison = fmt::format("{} {}", benchmarks::regression, comparison);
+					++regressions;
+				} else if (ratio < 1.0 - opts->tolerance)
+					comparison = fmt::format("{} {}", benchmarks::improvement, comparison);
+			}
+			g_logger->log(
+				log_level::BASIC, fmt_str, b.get_name(),
+				benchmarks::format_duration(res.min), benchmarks::format_duration(res.median), benchmarks::format_duration(res.p99),
+				benchmarks::format_throughput(res), comparison
+			);
+		}
+	}
+	if (!opts->save.empty()) {
+		if (benchmarks::save_results(opts->save))
+			g_logger->log(log_level::BASIC, "\nResults saved to {}", opts->save);
+		else {
+			g_logger->log(log_level::BASIC, "\nFailed to save results to {}", opts->save);
+			++failed;
+		}
+	}
+	g_logger->log(log_level::BASIC, "\nBenchmarks completed: {} failed, {} regressions", failed, regressions);
+	return (static_cast<int>(failed + regressions));
+}
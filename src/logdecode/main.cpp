@@ -0,0 +1,74 @@
+// Prints the lines of binary logs written by octahedron::binary_logger.
+//
+// Usage: logdecode <file>...
+
+#include <cstdio>
+
+#include "io/binary_log.h"
+#include "io/file_stream.h"
+#include "io/file_system.h"
+#include "io/logger.h"
+
+namespace
+{
+std::string_view level_name(octahedron::log_level level) {
+	using octahedron::log_level;
+
+	switch (level) {
+		case log_level::BASIC: return ("BASIC");
+		case log_level::INFO: return ("INFO");
+		case log_level::WARN: return ("WARN");
+		case log_level::ERROR: return ("ERROR");
+		case log_level::DEBUG: return ("DEBUG");
+		case log_level::TRACE: return ("TRACE");
+		default: return ("?");
+	}
+}
+
+using error_logger = octahedron::logger<std::FILE*>;
+
+bool decode(octahedron::file_system &fs, error_logger &errors, const octahedron::stdfs::path &path) {
+	using octahedron::log_level;
+	using octahedron::open_flags;
+
+	fs.set_home_dir(path.parent_path().string());
+
+	auto in = fs.open(path.filename().string(), open_flags::INPUT | open_flags::BINARY);
+
+	if (!in) {
+		errors.log(log_level::ERROR, "{}: could not open", path.string());
+		return (false);
+	}
+
+	octahedron::binary_log_reader reader{*in};
+
+	if (!reader.valid()) {
+		errors.log(log_level::ERROR, "{}: not a binary log", path.string());
+		return (false);
+	}
+	while (auto line = reader.next()) {
+		auto time = std::chrono::duration<double>{line->time};
+
+		fmt::print("[{:>12.6f}] {:<5} {}\n", time.count(), level_name(line->level), line->text);
+	}
+	return (true);
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		fmt::print(stderr, "usage: {} <file>...\n", argv[0]);
+		return (1);
+	}
+
+	// no engine: reading a file needs none of its threads, and the library's own logging is dropped without one
+	octahedron::file_system fs;
+	error_logger            errors{stderr};
+	int                     ret = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!decode(fs, errors, octahedron::stdfs::absolute(argv[i])))
+			ret = 1;
+	}
+	return (ret);
+}
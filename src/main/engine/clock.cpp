@@ -0,0 +1,43 @@
+#include "clock.h"
+
+#include <atomic>
+
+#include "../tools/math.h"
+
+using namespace octahedron;
+
+namespace
+{
+std::atomic<nanoseconds::rep> g_sleep_granularity{0};
+
+nanoseconds measure_sleep_granularity() {
+	constexpr int         samples = 5;
+	constexpr nanoseconds request = microseconds{200};
+
+	nanoseconds worst{0};
+
+	// the worst of a few samples, a granularity too low would make every paced tick sleep past its deadline
+	for (int i = 0; i < samples; ++i) {
+		auto start = std::chrono::steady_clock::now();
+
+		std::this_thread::sleep_for(request);
+		worst = max(worst, nanoseconds{std::chrono::steady_clock::now() - start - request});
+	}
+	return (max(worst, nanoseconds{microseconds{50}}));
+}
+} // namespace
+
+nanoseconds octahedron::sleep_granularity() {
+	nanoseconds::rep granularity = g_sleep_granularity.load(std::memory_order::relaxed);
+
+	if (granularity == 0)
+		return (calibrate_sleep_granularity());
+	return (nanoseconds{granularity});
+}
+
+nanoseconds octahedron::calibrate_sleep_granularity() {
+	nanoseconds granularity = measure_sleep_granularity();
+
+	g_sleep_granularity.store(granularity.count(), std::memory_order::relaxed);
+	return (granularity);
+}
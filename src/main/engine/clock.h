@@ -0,0 +1,191 @@
+#ifndef OCTAHEDRON_CLOCK_H_
+#define OCTAHEDRON_CLOCK_H_
+
+#include <chrono>
+#include <thread>
+
+#include "../base.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief How clock::update waits for the minimum duration of a tick.
+ */
+enum class pacing {
+	SLEEP,  /**< sleep for the remaining time, late by up to a scheduler quantum */
+	PRECISE /**< sleep until one sleep granularity before the deadline, then yield until it */
+};
+
+/**
+ * \brief Returns by how much a short sleep overshoots on this system, measured on first call.
+ *
+ * game_engine calls it at startup so that the first paced tick does not pay for the measurement.
+ */
+nanoseconds sleep_granularity();
+
+/**
+ * \brief Measures sleep_granularity() again, for example after the timer resolution was changed.
+ */
+nanoseconds calibrate_sleep_granularity();
+
+template <typename T> requires requires { T::now(); }
+class clock {
+public:
+	using timestamp = typename T::time_point;
+	using duration = microseconds;
+	using type = T;
+
+	struct tick {
+		using clock = clock<T>;
+
+		timestamp time;
+		duration  real_diff;
+		duration  clamped_diff;
+	};
+
+	/**
+	 * \brief How late the ticks which had to wait for their minimum duration were.
+	 */
+	struct pacing_stats {
+		uint64      paced_ticks{0};
+		nanoseconds last_overshoot{0};
+		nanoseconds max_overshoot{0};
+		nanoseconds total_overshoot{0};
+
+		[[nodiscard]] nanoseconds mean_overshoot() const noexcept {
+			return (paced_ticks > 0 ? total_overshoot / static_cast<nanoseconds::rep>(paced_ticks) : nanoseconds::zero());
+		}
+	};
+
+	explicit clock(pacing mode = pacing::PRECISE) noexcept :
+		_pacing{mode} {
+	}
+
+	/**
+	 * \brief Waits until at least `min_duration` passed since the last tick, then starts a new one.
+	 *
+	 * \param max_duration upper bound of the clamped difference of the tick
+	 */
+	const tick& update(duration min_duration, duration max_duration);
+	const tick& update(duration min_duration);
+	const tick& update() noexcept;
+
+	const tick&      get_last_tick() const noexcept;
+	const timestamp& get_start_time() const noexcept;
+
+	void   set_pacing(pacing mode) noexcept;
+	pacing get_pacing() const noexcept;
+
+	const pacing_stats& get_pacing_stats() const noexcept;
+	void                reset_pacing_stats() noexcept;
+
+private:
+	void _wait_until(timestamp deadline) const;
+
+	const timestamp _start_time{T::now()};
+	tick            _last_tick{_start_time, duration::zero(), duration::zero()};
+	pacing          _pacing;
+	pacing_stats    _stats{};
+};
+
+using game_clock = clock<std::chrono::steady_clock>;
+using wall_clock = clock<std::chrono::system_clock>;
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::update(duration min_duration, duration max_duration) -> const tick& {
+	timestamp deadline = _last_tick.time + min_duration;
+	timestamp now = T::now();
+
+	if (now < deadline) {
+		_wait_until(deadline);
+		now = T::now();
+
+		nanoseconds overshoot = now - deadline;
+
+		++_stats.paced_ticks;
+		_stats.last_overshoot = overshoot;
+		_stats.total_overshoot += overshoot;
+		if (overshoot > _stats.max_overshoot)
+			_stats.max_overshoot = overshoot;
+	}
+
+	duration real_diff = duration_cast<duration>(now - _last_tick.time);
+
+	_last_tick = {
+		.time = now,
+		.real_diff = real_diff,
+		.clamped_diff = (real_diff > max_duration ? max_duration : real_diff)
+	};
+	return (_last_tick);
+}
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::update(duration min_duration) -> const tick& {
+	return (update(min_duration, duration::max()));
+}
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::update() noexcept -> const tick& {
+	timestamp now = T::now();
+	duration  real_diff = duration_cast<duration>(now - _last_tick.time);
+
+	_last_tick = {.time = now, .real_diff = real_diff, .clamped_diff = real_diff};
+	return (_last_tick);
+}
+
+template <typename T> requires requires { T::now(); }
+void clock<T>::_wait_until(timestamp deadline) const {
+	if (_pacing == pacing::SLEEP) {
+		std::this_thread::sleep_for(deadline - T::now());
+		return;
+	}
+
+	nanoseconds granularity = sleep_granularity();
+	timestamp   now = T::now();
+
+	// sleeps wake up late by up to the granularity, so they stop short of the deadline by as much
+	while (deadline - now > granularity) {
+		std::this_thread::sleep_for(deadline - now - granularity);
+		now = T::now();
+	}
+	// yielding rather than busy-waiting leaves the core to other threads, on a loaded system too
+	while (now < deadline) {
+		std::this_thread::yield();
+		now = T::now();
+	}
+}
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::get_last_tick() const noexcept -> const tick& {
+	return (_last_tick);
+}
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::get_start_time() const noexcept -> const timestamp& {
+	return (_start_time);
+}
+
+template <typename T> requires requires { T::now(); }
+void clock<T>::set_pacing(pacing mode) noexcept {
+	_pacing = mode;
+}
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::get_pacing() const noexcept -> pacing {
+	return (_pacing);
+}
+
+template <typename T> requires requires { T::now(); }
+auto clock<T>::get_pacing_stats() const noexcept -> const pacing_stats& {
+	return (_stats);
+}
+
+template <typename T> requires requires { T::now(); }
+void clock<T>::reset_pacing_stats() noexcept {
+	_stats = {};
+}
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_CLOCK_H_ */
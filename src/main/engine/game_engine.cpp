@@ -153,7 +153,8 @@ auto parse_cmd_options(int ac, char *av[]) {
 	auto options = std::to_array<cmd_option>({
 		{'g', "logfile", opt_argument_type::required, {}},
 		{'u', "home", opt_argument_type::required, {}},
-		{'k', "packagedirs", opt_argument_type::multiple, {}}
+		{'k', "packagedirs", opt_argument_type::multiple, {}},
+		{'b', "binlog", opt_argument_type::required, {}}
 	});
 	for (int i = 1; i < ac; ++i) {
 		if (av[i][0] == '-') {
@@ -297,10 +298,25 @@ void game_engine::set_log_file(std::string_view file) {
 		_logger.log(log_level::ERROR, "failed to set log file to {}", file);
 		return;
 	}
-	_log_file.target = std::move(stream);
+	_log_file.with_sink([&stream](auto &sink) { sink.target = std::move(stream); });
 	_logger.log(log_level::BASIC, "log file set to {}", file);
 }
 
+void game_engine::set_binary_log_file(std::string_view file) {
+	auto stream = _filesystem.open(file, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+	if (!stream) {
+		_logger.log(log_level::ERROR, "failed to set binary log file to {}", file);
+		return;
+	}
+	_binary_log = std::make_unique<binary_logger>(std::move(stream));
+	_logger.log(log_level::BASIC, "binary log file set to {}", file);
+}
+
+auto game_engine::get_binary_log() noexcept -> binary_logger* {
+	return (_binary_log.get());
+}
+
 void game_engine::log(bit_set<log_level> level, std::string_view line) {
 	_logger.log(log_level{level}, line);
 }
@@ -310,6 +326,7 @@ game_engine::game_engine(int argc, char *argv[]) {
 		throw exception("Another instance of the engine is already running");
 
 	g_engine = this;
+	_filesystem.set_job_system(&_jobs);
 
 	namespace v = std::views;
 
@@ -319,9 +336,13 @@ game_engine::game_engine(int argc, char *argv[]) {
 			_filesystem.set_home_dir(arguments[1].values[0]);
 	if (!arguments[0].values.empty())
 			set_log_file(arguments[0].values[0]);
+	if (!arguments[3].values.empty())
+			set_binary_log_file(arguments[3].values[0]);
 	for (std::string_view dir : arguments[1].values) {
 		_filesystem.add_package_dir(dir);
 	}
+	seed_random_streams(_get_seed_base());
+	sleep_granularity();
 }
 
 void game_engine::seedRNG() {
@@ -330,15 +351,7 @@ void game_engine::seedRNG() {
 	_mt64 = std::mt19937_64{seed};
 	_mt32 = std::mt19937{narrow_cast<uint32>(seed)};
 
-	_rng = {
-		.state{
-			generate<16>(
-				[this]() {
-					return (narrow_cast<uint16>(this->_mt64()));
-				}
-			)
-		}
-	};
+	seed_random_streams(seed);
 }
 
 auto game_engine::get_file_system() const noexcept -> const file_system& {
@@ -349,6 +362,29 @@ auto game_engine::get_file_system() noexcept -> file_system& {
 	return (_filesystem);
 }
 
+auto game_engine::get_async_file_system() noexcept -> async_file_system& {
+	return (_async_filesystem);
+}
+
+auto game_engine::get_job_system() noexcept -> job_system& {
+	return (_jobs);
+}
+
+auto game_engine::get_profiler() noexcept -> profiler& {
+	return (_profiler);
+}
+
+bool game_engine::write_profile_trace(std::string_view file) {
+	auto stream = _filesystem.open(file, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+	if (!stream || !_profiler.write_chrome_trace(*stream)) {
+		_logger.log(log_level::ERROR, "failed to write profile trace to {}", file);
+		return (false);
+	}
+	_logger.log(log_level::BASIC, "profile trace written to {}", file);
+	return (true);
+}
+
 void game_engine::_parse_args(std::span<const char *const> args) {}
 
 auto game_engine::_get_seed_base() const noexcept -> size_t {
@@ -362,6 +398,10 @@ auto game_engine::get_game_clock() const noexcept -> const game_clock& {
 	return (_game_clock);
 }
 
+auto game_engine::get_game_clock() noexcept -> game_clock& {
+	return (_game_clock);
+}
+
 auto game_engine::get_wall_clock() const noexcept -> const wall_clock& {
 	return (_day_clock);
 }
@@ -10,45 +10,22 @@
 #include <thread>
 
 #include "octahedron.h"
+#include "clock.h"
+#include "job_system.h"
+#include "profiler.h"
 
+#include "../io/async_file_system.h"
+#include "../io/async_logger.h"
+#include "../io/binary_log.h"
 #include "../io/file_stream.h"
 #include "../io/file_system.h"
 #include "../io/logger.h"
 #include "../tools/protected_ptr.h"
+#include "../tools/random.h"
 
 namespace octahedron
 {
 
-template <typename T> requires requires { T::now(); }
-class clock {
-public:
-	using timestamp = typename T::time_point;
-	using duration = microseconds;
-	using type = T;
-
-	struct tick {
-		using clock = clock<T>;
-
-		timestamp time;
-		duration  real_diff;
-		duration  clamped_diff;
-	};
-
-	const tick& update(duration min_duration, duration max_duration);
-	const tick& update(duration min_duration);
-	const tick& update() noexcept;
-
-	const tick&      get_last_tick() const noexcept;
-	const timestamp& get_start_time() const noexcept;
-
-private:
-	const timestamp _start_time{T::now()};
-	tick            _last_tick{_start_time, duration::zero(), duration::zero()};
-};
-
-using game_clock = clock<std::chrono::steady_clock>;
-using wall_clock = clock<std::chrono::system_clock>;
-
 class game_engine {
 public:
 	struct parameter {
@@ -64,10 +41,14 @@ public:
 	game_engine& operator=(game_engine &&) = delete;
 
 	const game_clock& get_game_clock() const noexcept;
+	game_clock&       get_game_clock() noexcept;
 	const wall_clock& get_wall_clock() const noexcept;
 
 	bool is_log_enabled(bit_set<log_level> logLevel) const noexcept;
 
+	/**
+	 * \brief Reseeds the engine's generators, including the random_stream of every thread, see thread_random().
+	 */
 	void seedRNG();
 
 	enum class state {
@@ -93,16 +74,47 @@ public:
 		log(level, line);
 	}
 
+	/**
+	 * \brief Starts writing binary log lines to a file, see binary_logger.
+	 */
+	void set_binary_log_file(std::string_view file);
+
+	/**
+	 * \brief Returns the binary logger, or nullptr if no binary log file was set.
+	 */
+	binary_logger* get_binary_log() noexcept;
+
+	template <string_literal Fmt, typename... Args>
+	void binary_log(bit_set<log_level> level, Args &&... args) {
+		if (_binary_log)
+			_binary_log->log<Fmt>(log_level{level}, std::forward<Args>(args)...);
+	}
+
 	const file_system& get_file_system() const noexcept;
 	file_system&       get_file_system() noexcept;
 
+	async_file_system& get_async_file_system() noexcept;
+
+	/**
+	 * \brief Returns the pool engine subsystems share for parallel work.
+	 */
+	job_system& get_job_system() noexcept;
+
+	profiler& get_profiler() noexcept;
+
+	/**
+	 * \brief Writes the zones captured by the profiler to a file, as Chrome trace event JSON.
+	 */
+	bool write_profile_trace(std::string_view file);
+
 private:
 	void   _parse_args(std::span<const char*const> args);
 	size_t _get_seed_base() const noexcept;
 
-	logger<std::unique_ptr<file_stream>>                     _log_file{nullptr};
+	async_logger<logger<std::unique_ptr<file_stream>>>      _log_file{logger<std::unique_ptr<file_stream>>{nullptr}};
 	logger<std::fstream>                                     _debug_log_file{std::fstream{}};
 	logger_system<decltype(_log_file), logger<std::fstream>> _logger{_log_file, _debug_log_file};
+	std::unique_ptr<binary_logger>                           _binary_log{nullptr};
 
 	game_clock _game_clock{};
 	wall_clock _day_clock{};
@@ -110,79 +122,14 @@ private:
 	std::mt19937    _mt32{static_cast<unsigned int>(_get_seed_base())};
 	std::mt19937_64 _mt64{_get_seed_base()};
 
-	struct well_rng_512 {
-		std::array<uint16, 16> state{};
-		uint64                 index{0};
-
-		uint64 operator()();
-	};
-
-	well_rng_512 _rng{
-		.state{
-			generate<16>(
-				[this]() {
-					return (static_cast<uint16>(this->_mt64()));
-				}
-			)
-		}
-	};
-
 	state _state{state::none};
 
-	file_system _filesystem;
+	file_system       _filesystem;
+	async_file_system _async_filesystem{_filesystem};
+	job_system        _jobs;
+	profiler          _profiler;
 };
 
-template <typename T> requires requires { T::now(); }
-auto clock<T>::update(duration min_duration, duration max_duration) -> const tick& {
-	timestamp now = T::now();
-	duration  real_diff = now - _last_tick.time;
-
-	if (real_diff < min_duration) {
-		std::this_thread::sleep_for(min_duration - real_diff);
-		now = T::now();
-		real_diff = now - _last_tick.time;
-	}
-	_last_tick = {
-		.time = now,
-		.real_diff = real_diff,
-		.clamped_diff = (max_duration > real_diff ? max_duration : real_diff)
-	};
-	return (_last_tick);
-}
-
-template <typename T> requires requires { T::now(); }
-auto clock<T>::update(duration min_duration) -> const tick& {
-	timestamp now = T::now();
-	duration  real_diff = now - _last_tick.time;
-
-	if (real_diff < min_duration) {
-		std::this_thread::sleep_for(min_duration - real_diff);
-		now = T::now();
-		real_diff = now - _last_tick.time;
-	}
-	_last_tick = {.time = now, .real_diff = real_diff, .clamped_diff = real_diff};
-	return (_last_tick);
-}
-
-template <typename T> requires requires { T::now(); }
-auto clock<T>::update() noexcept -> const tick& {
-	timestamp now = T::now();
-	duration  real_diff = now - _last_tick.time;
-
-	_last_tick = {.time = now, .real_diff = real_diff, .clamped_diff = real_diff};
-	return (_last_tick);
-}
-
-template <typename T> requires requires { T::now(); }
-auto clock<T>::get_last_tick() const noexcept -> const tick& {
-	return (_last_tick);
-}
-
-template <typename T> requires requires { T::now(); }
-auto clock<T>::get_start_time() const noexcept -> const timestamp& {
-	return (_start_time);
-}
-
 } // namespace octahedron
 
 #endif
@@ -0,0 +1,196 @@
+#include "job_system.h"
+
+#include "../tools/math.h"
+
+using namespace octahedron;
+
+namespace
+{
+struct worker_identity {
+	const job_system *system{nullptr};
+	size_t            index{0};
+};
+
+thread_local worker_identity t_worker;
+} // namespace
+
+job_system::job_system(size_t num_threads) :
+	_num_threads{num_threads > 0 ? num_threads : max(std::thread::hardware_concurrency(), 2u) - 1} {
+	_queues = std::make_unique<queue[]>(_num_threads + 1);
+	_workers.reserve(_num_threads);
+	for (size_t i = 0; i < _num_threads; ++i)
+		_workers.emplace_back([this, i](std::stop_token stop) { _work(i, stop); });
+}
+
+job_system::~job_system() {
+	// workers only stop once the queues are empty, so that nothing waiting on a job is left hanging
+	while (auto state = _find_job(current_thread_index()))
+		_run(state);
+	for (auto &worker : _workers)
+		worker.request_stop();
+	_cv.notify_all();
+	_workers.clear();
+}
+
+size_t job_system::current_thread_index() const noexcept {
+	return (t_worker.system == this ? t_worker.index : _num_threads);
+}
+
+job job_system::_submit(std::function<void()> fun, std::span<const job> dependencies) {
+	auto state = std::make_shared<job::state>();
+
+	state->fun = std::move(fun);
+	// the extra count held until every dependency is registered keeps the job from being scheduled halfway
+	state->pending.store(dependencies.size() + 1, std::memory_order::relaxed);
+	for (const job &dependency : dependencies) {
+		if (!dependency.valid()) {
+			state->pending.fetch_sub(1, std::memory_order::relaxed);
+			continue;
+		}
+
+		std::unique_lock lock{dependency._state->mutex};
+
+		if (dependency.done()) {
+			lock.unlock();
+			state->pending.fetch_sub(1, std::memory_order::acq_rel);
+		} else
+			dependency._state->continuations.push_back(state);
+	}
+	if (state->pending.fetch_sub(1, std::memory_order::acq_rel) == 1)
+		_schedule(state);
+	return (job{std::move(state)});
+}
+
+void job_system::_schedule(std::shared_ptr<job::state> state) {
+	queue &q = _queues[current_thread_index()];
+
+	{
+		std::scoped_lock lock{q.mutex};
+
+		q.jobs.push_back(std::move(state));
+	}
+	_queued.fetch_add(1);
+	// sleepers count themselves before checking _queued, so one of the two sides always sees the other
+	if (_sleeping.load() > 0 || _waiting.load() > 0) {
+		{ std::scoped_lock lock{_mutex}; }
+		_cv.notify_one();
+		// threads blocked in wait() help too, they may be all there is when every worker is waiting on a job
+		_done_cv.notify_all();
+	}
+}
+
+void job_system::_run(const std::shared_ptr<job::state> &state) {
+	try {
+		state->fun();
+	} catch (...) {
+		state->exception = std::current_exception();
+	}
+	state->fun = nullptr;
+
+	std::vector<std::shared_ptr<job::state>> continuations;
+
+	{
+		std::scoped_lock lock{state->mutex};
+
+		state->done.store(true);
+		continuations.swap(state->continuations);
+	}
+	for (auto &continuation : continuations) {
+		if (continuation->pending.fetch_sub(1, std::memory_order::acq_rel) == 1)
+			_schedule(std::move(continuation));
+	}
+	if (_waiting.load() > 0) {
+		{ std::scoped_lock lock{_mutex}; }
+		_done_cv.notify_all();
+	}
+}
+
+auto job_system::_find_job(size_t index) -> std::shared_ptr<job::state> {
+	size_t num_queues = _num_threads + 1;
+
+	if (_queued.load(std::memory_order::relaxed) == 0)
+		return (nullptr);
+	{
+		// own jobs newest first, they are the most likely to still be in cache
+		queue           &own = _queues[index];
+		std::scoped_lock lock{own.mutex};
+
+		if (!own.jobs.empty()) {
+			auto ret = std::move(own.jobs.back());
+
+			own.jobs.pop_back();
+			_queued.fetch_sub(1, std::memory_order::relaxed);
+			return (ret);
+		}
+	}
+	for (size_t i = 1; i < num_queues; ++i) {
+		queue           &victim = _queues[(index + i) % num_queues];
+		std::scoped_lock lock{victim.mutex};
+
+		if (!victim.jobs.empty()) {
+			auto ret = std::move(victim.jobs.front());
+
+			victim.jobs.pop_front();
+			_queued.fetch_sub(1, std::memory_order::relaxed);
+			return (ret);
+		}
+	}
+	return (nullptr);
+}
+
+void job_system::_work(size_t index, std::stop_token stop) {
+	t_worker = {this, index};
+	while (true) {
+		if (auto state = _find_job(index)) {
+			_run(state);
+			continue;
+		}
+
+		std::unique_lock lock{_mutex};
+
+		_sleeping.fetch_add(1);
+
+		bool woken = _cv.wait(lock, stop, [this]() { return (_queued.load() > 0); });
+
+		_sleeping.fetch_sub(1);
+		if (!woken)
+			return;
+	}
+}
+
+void job_system::wait(const job &j) {
+	size_t index = current_thread_index();
+
+	if (!j.valid())
+		return;
+	while (!j.done()) {
+		if (auto state = _find_job(index)) {
+			_run(state);
+			continue;
+		}
+
+		std::unique_lock lock{_mutex};
+
+		_waiting.fetch_add(1);
+		_done_cv.wait(lock, [this, &j]() { return (j.done() || _queued.load() > 0); });
+		_waiting.fetch_sub(1);
+	}
+	if (j._state->exception)
+		std::rethrow_exception(j._state->exception);
+}
+
+void job_system::wait(std::span<const job> jobs) {
+	std::exception_ptr exception{nullptr};
+
+	// every job is waited for before rethrowing, callers may own what they reference
+	for (const job &j : jobs) {
+		try {
+			wait(j);
+		} catch (...) {
+			if (!exception)
+				exception = std::current_exception();
+		}
+	}
+	if (exception)
+		std::rethrow_exception(exception);
+}
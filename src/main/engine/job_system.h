@@ -0,0 +1,214 @@
+#ifndef OCTAHEDRON_JOBSYSTEM_H_
+#define OCTAHEDRON_JOBSYSTEM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../base.h"
+
+namespace octahedron
+{
+
+class job_system;
+
+/**
+ * \brief Handle to a job submitted to a job_system, which can be waited on or used as a dependency of other jobs.
+ */
+class job {
+public:
+	job() = default;
+
+	[[nodiscard]] bool valid() const noexcept {
+		return (_state != nullptr);
+	}
+
+	/**
+	 * \brief Returns whether the job ran, or threw.
+	 */
+	[[nodiscard]] bool done() const noexcept {
+		return (_state->done.load(std::memory_order::acquire));
+	}
+
+private:
+	friend class job_system;
+
+	struct state {
+		std::function<void()>               fun;
+		std::atomic<size_t>                 pending{1};
+		std::atomic<bool>                   done{false};
+		std::mutex                          mutex;
+		std::vector<std::shared_ptr<state>> continuations;
+		std::exception_ptr                  exception{nullptr};
+	};
+
+	explicit job(std::shared_ptr<state> state_) :
+		_state{std::move(state_)} {
+	}
+
+	std::shared_ptr<state> _state{nullptr};
+};
+
+/**
+ * \brief Work-stealing pool running short jobs on a fixed set of worker threads.
+ *
+ * Every worker owns a deque: it pushes and pops its own jobs at the back, for locality, while idle workers steal from
+ * the front of the others'. Jobs submitted from other threads go to a shared deque which all workers steal from.
+ * Workers sleep when there is nothing to run.
+ *
+ * A job can depend on others, in which case it is only queued once they are all done. wait() and parallel_for() run
+ * queued jobs on the calling thread until what they wait for is done, so the main thread helps instead of blocking,
+ * and jobs can wait on jobs they spawned without deadlocking the pool.
+ */
+class job_system {
+public:
+	/**
+	 * \param num_threads number of worker threads, 0 for one per core minus the calling thread (at least 1)
+	 */
+	explicit job_system(size_t num_threads = 0);
+
+	/**
+	 * \brief Runs every job already submitted, then stops the workers.
+	 */
+	~job_system();
+
+	job_system(const job_system &) = delete;
+	job_system& operator=(const job_system &) = delete;
+
+	template <std::invocable F>
+	job submit(F &&fun) {
+		return (_submit(std::function<void()>{std::forward<F>(fun)}, {}));
+	}
+
+	/**
+	 * \brief Submits a job which is only queued once every job in `dependencies` is done.
+	 */
+	template <std::invocable F>
+	job submit_after(std::span<const job> dependencies, F &&fun) {
+		return (_submit(std::function<void()>{std::forward<F>(fun)}, dependencies));
+	}
+
+	template <std::invocable F>
+	job submit_after(std::initializer_list<job> dependencies, F &&fun) {
+		return (submit_after(std::span{dependencies.begin(), dependencies.size()}, std::forward<F>(fun)));
+	}
+
+	/**
+	 * \brief Runs other jobs until `j` is done, then rethrows the exception it threw if any.
+	 */
+	void wait(const job &j);
+
+	/**
+	 * \brief Waits for every job, then rethrows the first exception thrown if any.
+	 */
+	void wait(std::span<const job> jobs);
+
+	/**
+	 * \brief Calls `fun(i)` or `fun(begin, end)` over the index range [begin, end) split in chunks, and waits for all of them.
+	 *
+	 * \param grain minimum number of indices per chunk, 0 to split in a few chunks per thread
+	 */
+	template <typename F> requires(std::invocable<F&, size_t> || std::invocable<F&, size_t, size_t>)
+	void parallel_for(size_t begin, size_t end, F &&fun, size_t grain = 0) {
+		if (begin >= end)
+			return;
+
+		size_t count = end - begin;
+		size_t chunks = (thread_count() + 1) * chunks_per_thread;
+
+		if (grain > 0)
+			chunks = std::min(chunks, (count + grain - 1) / grain);
+		chunks = std::clamp<size_t>(chunks, 1, count);
+
+		auto run = [&fun](size_t first, size_t last) {
+			if constexpr (std::invocable<F&, size_t, size_t>)
+				fun(first, last);
+			else {
+				for (size_t i = first; i < last; ++i)
+					fun(i);
+			}
+		};
+
+		if (chunks == 1) {
+			run(begin, end);
+			return;
+		}
+
+		std::vector<job> jobs;
+		size_t           chunk_size = count / chunks;
+		size_t           remainder = count % chunks;
+		size_t           first = begin;
+
+		jobs.reserve(chunks - 1);
+		// the first chunks are given away, the caller keeps the last one then helps with the rest
+		for (size_t i = 0; i < chunks - 1; ++i) {
+			size_t last = first + chunk_size + (i < remainder ? 1 : 0);
+
+			jobs.push_back(submit([&run, first, last]() { run(first, last); }));
+			first = last;
+		}
+
+		std::exception_ptr exception{nullptr};
+
+		try {
+			run(first, end);
+		} catch (...) {
+			exception = std::current_exception();
+		}
+		wait(jobs);
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+
+	[[nodiscard]] size_t thread_count() const noexcept {
+		return (_num_threads);
+	}
+
+	/**
+	 * \brief Returns the index of the calling worker thread, or thread_count() for any other thread.
+	 */
+	[[nodiscard]] size_t current_thread_index() const noexcept;
+
+private:
+	static constexpr size_t chunks_per_thread = 4;
+
+	struct alignas(64) queue {
+		std::mutex                               mutex;
+		std::deque<std::shared_ptr<job::state>> jobs;
+	};
+
+	job _submit(std::function<void()> fun, std::span<const job> dependencies);
+
+	void _schedule(std::shared_ptr<job::state> state);
+
+	void _run(const std::shared_ptr<job::state> &state);
+
+	std::shared_ptr<job::state> _find_job(size_t index);
+
+	void _work(size_t index, std::stop_token stop);
+
+	// set before the workers start, which read it while _workers is still being filled
+	size_t                      _num_threads;
+	// one queue per worker, then the shared one for other threads
+	std::unique_ptr<queue[]>    _queues;
+	std::atomic<size_t>         _queued{0};
+	std::atomic<size_t>         _sleeping{0};
+	std::atomic<size_t>         _waiting{0};
+	std::mutex                  _mutex;
+	std::condition_variable_any _cv;
+	std::condition_variable     _done_cv;
+	std::vector<std::jthread>   _workers;
+};
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_JOBSYSTEM_H_ */
@@ -0,0 +1,258 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "../tools/math.h"
+
+using namespace octahedron;
+
+namespace
+{
+struct zone_registry {
+	std::mutex                    mutex;
+	std::vector<std::string_view> names;
+};
+
+zone_registry &get_registry() {
+	static zone_registry registry;
+
+	return (registry);
+}
+
+std::string_view get_zone_name(uint32 id) {
+	auto            &registry = get_registry();
+	std::scoped_lock lock{registry.mutex};
+
+	return (registry.names[id]);
+}
+
+const uint32 frame_zone = _::register_profile_zone("frame");
+
+std::atomic<uint64> g_next_profiler_id{1};
+
+struct thread_cache {
+	uint64 profiler_id{0};
+	void  *buffer{nullptr};
+};
+
+thread_local thread_cache t_cache;
+
+void append_json_string(std::string &out, std::string_view str) {
+	out += '"';
+	for (char c : str) {
+		if (c == '"' || c == '\\')
+			out += '\\';
+		out += c;
+	}
+	out += '"';
+}
+
+nanoseconds percentile(std::vector<int64> &values, size_t p) {
+	size_t index = std::min(values.size() - 1, values.size() * p / 100);
+
+	std::ranges::nth_element(values, values.begin() + static_cast<ptrdiff_t>(index));
+	return (nanoseconds{values[index]});
+}
+} // namespace
+
+/**
+ * Single-producer single-consumer ring: the owning thread pushes, end_frame() pops under the profiler's mutex.
+ */
+struct profiler::thread_buffer {
+	explicit thread_buffer(uint32 index_) :
+		index{index_} {
+	}
+
+	bool push(const event &ev) noexcept {
+		uint64 h = head.load(std::memory_order::relaxed);
+
+		if (h - tail.load(std::memory_order::acquire) >= thread_capacity)
+			return (false);
+		events[h % thread_capacity] = ev;
+		head.store(h + 1, std::memory_order::release);
+		return (true);
+	}
+
+	template <typename F>
+	void drain(F &&fun) {
+		uint64 t = tail.load(std::memory_order::relaxed);
+		uint64 h = head.load(std::memory_order::acquire);
+
+		for (; t != h; ++t)
+			fun(events[t % thread_capacity]);
+		tail.store(t, std::memory_order::release);
+	}
+
+	const uint32                 index;
+	std::unique_ptr<event[]>     events{std::make_unique_for_overwrite<event[]>(thread_capacity)};
+	alignas(64) std::atomic<uint64> head{0};
+	alignas(64) std::atomic<uint64> tail{0};
+	std::atomic<uint64>          dropped{0};
+};
+
+uint32 octahedron::_::register_profile_zone(std::string_view name) {
+	auto            &registry = get_registry();
+	std::scoped_lock lock{registry.mutex};
+
+	registry.names.push_back(name);
+	return (static_cast<uint32>(registry.names.size() - 1));
+}
+
+profiler::profiler() :
+	_id{g_next_profiler_id.fetch_add(1, std::memory_order::relaxed)} {
+}
+
+profiler::~profiler() = default;
+
+void profiler::set_enabled(bool enabled) noexcept {
+	_enabled.store(enabled, std::memory_order::relaxed);
+}
+
+void profiler::_record(uint32 zone, int64 start, int64 end) noexcept {
+	thread_buffer *buffer = _thread_buffer();
+
+	if (!buffer->push({zone, start, end}))
+		buffer->dropped.fetch_add(1, std::memory_order::relaxed);
+}
+
+auto profiler::_thread_buffer() -> thread_buffer* {
+	// a thread caches the buffer of the last profiler it recorded to, IDs are never reused unlike addresses
+	if (t_cache.profiler_id == _id)
+		return (static_cast<thread_buffer*>(t_cache.buffer));
+
+	std::scoped_lock lock{_mutex};
+	auto            &buffer = _threads.emplace_back(std::make_unique<thread_buffer>(static_cast<uint32>(_threads.size())));
+
+	t_cache = {_id, buffer.get()};
+	return (buffer.get());
+}
+
+void profiler::_collect() {
+	for (auto &buffer : _threads) {
+		buffer->drain([this, &buffer](const event &ev) {
+			if (ev.zone >= _frame_totals.size())
+				_frame_totals.resize(ev.zone + 1, -1);
+			_frame_totals[ev.zone] = max(_frame_totals[ev.zone], int64{0}) + (ev.end - ev.start);
+			if (_capturing)
+				_capture.push_back({ev, buffer->index});
+		});
+	}
+}
+
+void profiler::end_frame() {
+	int64            frame_end = now();
+	std::scoped_lock lock{_mutex};
+
+	_collect();
+	if (!enabled()) {
+		// zones recorded right before profiling was disabled are discarded with the frame
+		std::ranges::fill(_frame_totals, -1);
+		_frame_start = frame_end;
+		return;
+	}
+	if (frame_zone >= _frame_totals.size())
+		_frame_totals.resize(frame_zone + 1, -1);
+	_frame_totals[frame_zone] = frame_end - _frame_start;
+	if (_capturing)
+		_capture.push_back({{frame_zone, _frame_start, frame_end}, static_cast<uint32>(_threads.size())});
+	_frame_start = frame_end;
+	if (_history.size() < _frame_totals.size())
+		_history.resize(_frame_totals.size());
+	// zones which did not occur during the frame (-1) are left out of their history rather than counted as 0
+	for (size_t i = 0; i < _frame_totals.size(); ++i) {
+		if (_frame_totals[i] < 0)
+			continue;
+
+		zone_history &history = _history[i];
+
+		if (history.frames.size() < history_size)
+			history.frames.push_back(_frame_totals[i]);
+		else
+			history.frames[history.next] = _frame_totals[i];
+		history.next = (history.next + 1) % history_size;
+		++history.count;
+		_frame_totals[i] = -1;
+	}
+}
+
+auto profiler::get_stats() const -> std::vector<zone_stats> {
+	std::vector<zone_stats> ret;
+	std::vector<int64>      values;
+	std::scoped_lock        lock{_mutex};
+
+	for (size_t i = 0; i < _history.size(); ++i) {
+		const zone_history &history = _history[i];
+
+		if (history.frames.empty())
+			continue;
+		values = history.frames;
+
+		nanoseconds p50 = percentile(values, 50);
+		nanoseconds p99 = percentile(values, 99);
+
+		ret.push_back({
+			.name = get_zone_name(static_cast<uint32>(i)),
+			.frames = history.count,
+			.p50 = p50,
+			.p99 = p99,
+			.max = nanoseconds{*std::ranges::max_element(values)}
+		});
+	}
+	return (ret);
+}
+
+uint64 profiler::dropped() const noexcept {
+	std::scoped_lock lock{_mutex};
+	uint64           ret = 0;
+
+	for (const auto &buffer : _threads)
+		ret += buffer->dropped.load(std::memory_order::relaxed);
+	return (ret);
+}
+
+void profiler::start_capture() {
+	std::scoped_lock lock{_mutex};
+
+	_capture.clear();
+	_capturing = true;
+	_capture_start = now();
+}
+
+void profiler::stop_capture() {
+	std::scoped_lock lock{_mutex};
+
+	_collect();
+	_capturing = false;
+}
+
+bool profiler::write_chrome_trace(io_stream &out) const {
+	std::string      json;
+	std::scoped_lock lock{_mutex};
+
+	json.reserve(64 + _capture.size() * 96);
+	json += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+	for (size_t i = 0; i < _capture.size(); ++i) {
+		const captured_event &captured = _capture[i];
+
+		if (i > 0)
+			json += ",\n";
+		json += "{\"name\":";
+		append_json_string(json, get_zone_name(captured.ev.zone));
+		// timestamps are in microseconds, with the nanoseconds as decimals
+		fmt::format_to(
+			std::back_inserter(json),
+			",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+			captured.thread,
+			static_cast<double>(captured.ev.start - _capture_start) / 1000.0,
+			static_cast<double>(captured.ev.end - captured.ev.start) / 1000.0
+		);
+	}
+	json += "\n]}\n";
+
+	auto bytes = std::as_bytes(std::span{json});
+
+	return (out.write(bytes) == bytes.size());
+}
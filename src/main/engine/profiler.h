@@ -0,0 +1,180 @@
+#ifndef OCTAHEDRON_PROFILER_H_
+#define OCTAHEDRON_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "../base.h"
+#include "../io/io_stream.h"
+#include "../tools/string_literal.h"
+
+namespace octahedron
+{
+
+class profiler;
+
+namespace _
+{
+
+/**
+ * \brief Registers a zone name, returning its ID. IDs are shared by every profiler of the process.
+ */
+uint32 register_profile_zone(std::string_view name);
+
+template <string_literal Name>
+struct profile_zone_site {
+	inline static const uint32 id = register_profile_zone(Name);
+};
+
+} // namespace _
+
+/**
+ * \brief RAII marker recording the time between its construction and destruction as an occurrence of a zone.
+ */
+class profile_scope {
+public:
+	profile_scope(profiler &prof, uint32 zone) noexcept;
+
+	~profile_scope();
+
+	profile_scope(const profile_scope &) = delete;
+	profile_scope& operator=(const profile_scope &) = delete;
+
+private:
+	profiler *_profiler;
+	uint32    _zone;
+	int64     _start;
+};
+
+/**
+ * \brief Scoped-zone profiler aggregating per-frame zone times, and capturing them for Chrome's trace viewer.
+ *
+ * Zones are marked with `auto scope = prof.zone<"physics">();`. Each thread records its zones into its own ring,
+ * which only that thread writes and end_frame() drains, so recording takes no lock; when a ring is full, zones are
+ * dropped and counted. While disabled, a marker costs a single branch on a relaxed load.
+ *
+ * end_frame() adds the time spent in each zone during the frame to its history, from which get_stats() computes
+ * percentiles over the last `history_size` frames. The frame time itself is recorded as the zone "frame".
+ * Between start_capture() and stop_capture(), every zone occurrence is also kept for write_chrome_trace().
+ *
+ * Timestamps are steady_clock nanoseconds.
+ */
+class profiler {
+public:
+	static constexpr size_t history_size = 512;
+	static constexpr size_t thread_capacity = 16384;
+
+	struct zone_stats {
+		std::string_view name;
+		uint64           frames;
+		nanoseconds      p50;
+		nanoseconds      p99;
+		nanoseconds      max;
+	};
+
+	profiler();
+	~profiler();
+
+	profiler(const profiler &) = delete;
+	profiler& operator=(const profiler &) = delete;
+
+	[[nodiscard]] bool enabled() const noexcept {
+		return (_enabled.load(std::memory_order::relaxed));
+	}
+
+	void set_enabled(bool enabled) noexcept;
+
+	template <string_literal Name>
+	[[nodiscard]] profile_scope zone() noexcept {
+		return (profile_scope{*this, _::profile_zone_site<Name>::id});
+	}
+
+	/**
+	 * \brief Collects the zones recorded since the last call by every thread, and closes the frame.
+	 */
+	void end_frame();
+
+	/**
+	 * \brief Returns the percentiles of the time per frame of every zone seen in the history.
+	 */
+	[[nodiscard]] std::vector<zone_stats> get_stats() const;
+
+	/**
+	 * \brief Returns the number of zones dropped because a thread's ring was full.
+	 */
+	[[nodiscard]] uint64 dropped() const noexcept;
+
+	void start_capture();
+	void stop_capture();
+
+	/**
+	 * \brief Writes the zones captured so far as Chrome trace event JSON, see chrome://tracing or Perfetto.
+	 */
+	bool write_chrome_trace(io_stream &out) const;
+
+	[[nodiscard]] static int64 now() noexcept {
+		return (std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+private:
+	friend class profile_scope;
+
+	struct event {
+		uint32 zone;
+		int64  start;
+		int64  end;
+	};
+
+	struct thread_buffer;
+
+	struct captured_event {
+		event  ev;
+		uint32 thread;
+	};
+
+	struct zone_history {
+		std::vector<int64> frames;
+		size_t             next{0};
+		uint64             count{0};
+	};
+
+	void _record(uint32 zone, int64 start, int64 end) noexcept;
+
+	thread_buffer *_thread_buffer();
+
+	void _collect();
+
+	const uint64                                _id;
+	std::atomic<bool>                           _enabled{false};
+	mutable std::mutex                          _mutex;
+	std::vector<std::unique_ptr<thread_buffer>> _threads;
+	std::vector<int64>                          _frame_totals;
+	std::vector<zone_history>                   _history;
+	std::vector<captured_event>                 _capture;
+	bool                                        _capturing{false};
+	int64                                       _frame_start{now()};
+	int64                                       _capture_start{0};
+};
+
+inline profile_scope::profile_scope(profiler &prof, uint32 zone) noexcept :
+	_profiler{nullptr},
+	_zone{zone},
+	_start{0} {
+	if (prof.enabled()) {
+		_profiler = &prof;
+		_start = profiler::now();
+	}
+}
+
+inline profile_scope::~profile_scope() {
+	if (_profiler)
+		_profiler->_record(_zone, _start, profiler::now());
+}
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_PROFILER_H_ */
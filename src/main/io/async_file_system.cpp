@@ -0,0 +1,121 @@
+#include "async_file_system.h"
+
+#include "file_stream.h"
+#include "mapped_file_stream.h"
+#include "../tools/math.h"
+
+#include <fmt/std.h>
+
+using namespace octahedron;
+
+async_file_system::async_file_system(file_system &fs, size_t num_threads) :
+	_fs{fs} {
+	if (num_threads == 0)
+		num_threads = min(max(std::thread::hardware_concurrency(), 1u), 4u);
+	for (size_t i = 0; i < num_threads; ++i)
+		_workers.emplace_back([this](std::stop_token stop) { _work(stop); });
+}
+
+async_file_system::~async_file_system() {
+	// everything already queued is completed, so that no handle is left waiting forever
+	wait_idle();
+	for (auto &worker : _workers)
+		worker.request_stop();
+	_cv.notify_all();
+}
+
+void async_file_system::_work(std::stop_token stop) {
+	while (true) {
+		std::function<void()> task;
+
+		{
+			std::unique_lock lock{_mutex};
+
+			if (!_cv.wait(lock, stop, [this]() { return (!_queue.empty()); }))
+				return;
+			task = std::move(_queue.front());
+			_queue.pop_front();
+			++_running;
+		}
+		task();
+		{
+			std::scoped_lock lock{_mutex};
+
+			--_running;
+		}
+		_idle_cv.notify_all();
+	}
+}
+
+size_t async_file_system::pending() const {
+	std::scoped_lock lock{_mutex};
+
+	return (_queue.size() + _running);
+}
+
+void async_file_system::wait_idle() const {
+	std::unique_lock lock{_mutex};
+
+	_idle_cv.wait(lock, [this]() { return (_queue.empty() && _running == 0); });
+}
+
+auto async_file_system::read(std::string_view path, bit_set<open_flags> mode) -> async_result<bytes> {
+	auto resolved = _fs._resolve_path(path, mode);
+
+	if (!resolved) {
+		log(log_level::DEBUG, "could not resolve path {}", path);
+		return (_ready<bytes>(std::nullopt));
+	}
+	if (!(mode & open_flags::OUTPUT))
+		mode |= open_flags::MAPPED;
+	return (_submit<bytes>([this, path_ = std::move(*resolved), mode]() -> bytes {
+		auto f = _fs._open_resolved(path_, mode);
+
+		if (!f) {
+			log(log_level::DEBUG, "could not open {}", path_);
+			return {std::nullopt};
+		}
+		if (auto *mapped = dynamic_cast<mapped_file_stream*>(f.get())) {
+			auto view = mapped->view();
+
+			return {std::vector<std::byte>{view.begin(), view.end()}};
+		}
+
+		size_t size = f->size();
+
+		if (size == error_size) {
+			log(log_level::DEBUG, "could not get size of {}", path_);
+			return {std::nullopt};
+		}
+
+		std::vector<std::byte> ret(size);
+		size_t                 read = f->read(ret);
+
+		if (read == error_size) {
+			log(log_level::DEBUG, "could not read {}", path_);
+			return {std::nullopt};
+		}
+		ret.resize(read);
+		return {std::move(ret)};
+	}));
+}
+
+auto async_file_system::open(std::string_view path, bit_set<open_flags> mode) -> async_result<stream> {
+	auto resolved = _fs._resolve_path(path, mode);
+
+	if (!resolved)
+		return (_ready<stream>(nullptr));
+	return (_submit<stream>([this, path_ = std::move(*resolved), mode]() -> stream {
+		return (_fs._open_resolved(path_, mode));
+	}));
+}
+
+auto async_file_system::open_gz(std::string_view path, bit_set<open_flags> mode) -> async_result<stream> {
+	auto resolved = _fs._resolve_path(path, mode);
+
+	if (!resolved)
+		return (_ready<stream>(nullptr));
+	return (_submit<stream>([this, path_ = std::move(*resolved), mode]() -> stream {
+		return (_fs._open_gz_resolved(path_, mode));
+	}));
+}
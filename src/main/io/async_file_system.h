@@ -0,0 +1,219 @@
+#ifndef OCTAHEDRON_ASYNCFILESYSTEM_H_
+#define OCTAHEDRON_ASYNCFILESYSTEM_H_
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "file_system.h"
+#include "../base.h"
+
+namespace octahedron
+{
+
+class file_stream;
+
+/**
+ * \brief Handle to the result of an asynchronous file operation.
+ *
+ * Can be polled with ready(), waited on with get(), or awaited from a coroutine; in that case the
+ * coroutine is resumed on the I/O thread which completed the operation. An exception thrown by the
+ * operation is rethrown by get().
+ */
+template <typename T>
+class async_result {
+public:
+	async_result() = default;
+
+	[[nodiscard]] bool valid() const noexcept {
+		return (_state != nullptr);
+	}
+
+	[[nodiscard]] bool ready() const {
+		std::scoped_lock lock{_state->mutex};
+
+		return (_state->done());
+	}
+
+	void wait() const {
+		std::unique_lock lock{_state->mutex};
+
+		_state->cv.wait(lock, [this]() { return (_state->done()); });
+	}
+
+	/**
+	 * \brief Waits for the result and moves it out, or rethrows the exception the operation threw. Can only be called once.
+	 */
+	T get() {
+		wait();
+		if (_state->exception)
+			std::rethrow_exception(_state->exception);
+		return (std::move(*_state->value));
+	}
+
+	bool await_ready() const {
+		return (ready());
+	}
+
+	bool await_suspend(std::coroutine_handle<> continuation) {
+		std::scoped_lock lock{_state->mutex};
+
+		if (_state->done())
+			return (false);
+		_state->continuation = continuation;
+		return (true);
+	}
+
+	T await_resume() {
+		return (get());
+	}
+
+private:
+	friend class async_file_system;
+
+	struct state {
+		std::mutex              mutex;
+		std::condition_variable cv;
+		std::optional<T>        value{std::nullopt};
+		std::exception_ptr      exception{nullptr};
+		std::coroutine_handle<> continuation{nullptr};
+
+		bool done() const noexcept {
+			return (value.has_value() || exception != nullptr);
+		}
+	};
+
+	explicit async_result(std::shared_ptr<state> state_) :
+		_state{std::move(state_)} {
+	}
+
+	static void _set(state &s, T &&value) {
+		_complete(s, [&]() { s.value.emplace(std::move(value)); });
+	}
+
+	static void _set_exception(state &s, std::exception_ptr exception) {
+		_complete(s, [&]() { s.exception = std::move(exception); });
+	}
+
+	template <typename Fun>
+	static void _complete(state &s, Fun &&store) {
+		std::coroutine_handle<> continuation;
+
+		{
+			std::scoped_lock lock{s.mutex};
+
+			store();
+			continuation = std::exchange(s.continuation, nullptr);
+		}
+		s.cv.notify_all();
+		if (continuation)
+			continuation.resume();
+	}
+
+	std::shared_ptr<state> _state{nullptr};
+};
+
+/**
+ * \brief Issues file_system reads on a pool of I/O threads.
+ *
+ * Paths are resolved with file_system::_resolve_path on the calling thread, so the search order and
+ * open_flags are the same as for synchronous opens; only opening and reading happen on the pool.
+ * Failures resolve to an empty optional or a null stream, like their synchronous counterparts;
+ * exceptions thrown on the pool are handed to the result, and rethrown by async_result::get().
+ */
+class async_file_system {
+public:
+	using bytes = std::optional<std::vector<std::byte>>;
+	using stream = std::unique_ptr<file_stream>;
+
+	/**
+	 * \param fs file_system used for path resolution, must outlive this object
+	 * \param num_threads number of I/O threads, 0 for one per core (at most 4)
+	 */
+	explicit async_file_system(file_system &fs, size_t num_threads = 0);
+	~async_file_system();
+
+	async_file_system(const async_file_system &) = delete;
+	async_file_system& operator=(const async_file_system &) = delete;
+
+	/**
+	 * \brief Reads a whole file.
+	 */
+	async_result<bytes> read(
+		std::string_view    path,
+		bit_set<open_flags> mode = open_flags::INPUT | open_flags::BINARY
+	);
+
+	async_result<stream> open(std::string_view path, bit_set<open_flags> mode = open_flags::DEFAULT);
+
+	async_result<stream> open_gz(std::string_view path, bit_set<open_flags> mode = open_flags::DEFAULT);
+
+	/**
+	 * \brief Returns the number of operations queued or in progress.
+	 */
+	[[nodiscard]] size_t pending() const;
+
+	/**
+	 * \brief Blocks until every queued operation is done.
+	 */
+	void wait_idle() const;
+
+private:
+	template <typename T, typename Fun>
+	async_result<T> _submit(Fun &&fun);
+
+	template <typename T>
+	static async_result<T> _ready(T &&value);
+
+	void _work(std::stop_token stop);
+
+	file_system &                       _fs;
+	mutable std::mutex                  _mutex;
+	mutable std::condition_variable_any _cv;
+	mutable std::condition_variable_any _idle_cv;
+	std::deque<std::function<void()>>   _queue;
+	size_t                              _running{0};
+	std::vector<std::jthread>           _workers;
+};
+
+template <typename T, typename Fun>
+auto async_file_system::_submit(Fun &&fun) -> async_result<T> {
+	auto state = std::make_shared<typename async_result<T>::state>();
+
+	{
+		std::scoped_lock lock{_mutex};
+
+		_queue.emplace_back([state, f = std::forward<Fun>(fun)]() mutable {
+			std::optional<T> value;
+
+			try {
+				value.emplace(f());
+			} catch (...) {
+				async_result<T>::_set_exception(*state, std::current_exception());
+				return;
+			}
+			async_result<T>::_set(*state, std::move(*value));
+		});
+	}
+	_cv.notify_one();
+	return (async_result<T>{std::move(state)});
+}
+
+template <typename T>
+auto async_file_system::_ready(T &&value) -> async_result<T> {
+	auto state = std::make_shared<typename async_result<T>::state>();
+
+	state->value.emplace(std::move(value));
+	return (async_result<T>{std::move(state)});
+}
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_ASYNCFILESYSTEM_H_ */
@@ -0,0 +1,239 @@
+#ifndef OCTAHEDRON_ASYNCLOGGER_H_
+#define OCTAHEDRON_ASYNCLOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "../tools/math.h"
+#include "../tools/ring.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief What an async_logger does with a line logged while its ring is full.
+ */
+enum class log_overflow {
+	DROP,     /**< the new line is discarded */
+	BLOCK,    /**< the caller waits for the writer thread to make room */
+	OVERWRITE /**< the oldest line not yet written is discarded, like an ouroboros */
+};
+
+/**
+ * \brief Logger which hands lines to a background thread writing them to another logger.
+ *
+ * log() copies the line into a preallocated ring of fixed-size records and returns; a dedicated thread drains the ring in batches
+ * into the sink, so callers never wait on the sink's I/O (except with log_overflow::BLOCK when the ring is full).
+ * Lines longer than a record are not truncated: they are queued whole in a heap-allocated string, in step with a marker record.
+ *
+ * Prefix and suffix generators set on this logger run on the calling thread, those of the sink on the writer thread.
+ * The sink must only be accessed through with_sink() while this logger exists.
+ *
+ * \tparam Sink Logger the lines are written to
+ * \tparam Overflow What to do when the ring is full
+ * \tparam Capacity Number of records in the ring
+ * \tparam RecordSize Size of a record, including its header
+ */
+template <logger_type Sink, log_overflow Overflow = log_overflow::BLOCK, size_t Capacity = 1024, size_t RecordSize = 256>
+class async_logger : public logger_base<async_logger<Sink, Overflow, Capacity, RecordSize>> {
+public:
+	using base = logger_base<async_logger>;
+	using base::prefix_generator;
+	using base::suffix_generator;
+
+	struct record {
+		log_level level;
+		uint32    size;
+		char      text[RecordSize - sizeof(log_level) - sizeof(uint32)];
+	};
+
+	static_assert(sizeof(record) == RecordSize, "RecordSize too small or not a multiple of 4");
+
+	/**
+	 * \brief Starts the writer thread. The level of this logger is taken from the sink.
+	 */
+	explicit async_logger(Sink &&sink) :
+		_sink{std::move(sink)} {
+		this->level = _sink.level;
+		_thread = std::jthread{[this](std::stop_token stop) { _drain(stop); }};
+	}
+
+	async_logger(const async_logger &) = delete;
+	async_logger& operator=(const async_logger &) = delete;
+
+	/**
+	 * \brief Writes every pending line, then stops the writer thread.
+	 */
+	~async_logger() {
+		flush();
+		_thread.request_stop();
+		_thread.join();
+	}
+
+	void write(log_level level, std::string_view msg) {
+		record      rec;
+		std::string prefix = (prefix_generator ? prefix_generator(level, msg) : std::string{});
+		std::string suffix = (suffix_generator ? suffix_generator(level, msg) : std::string{});
+		std::string spilled;
+
+		rec.level = level;
+		rec.size = 0;
+		if (prefix.size() + msg.size() + suffix.size() <= sizeof(rec.text)) {
+			_append(rec, prefix);
+			_append(rec, msg);
+			_append(rec, suffix);
+		} else {
+			spilled.reserve(prefix.size() + msg.size() + suffix.size());
+			spilled.append(prefix).append(msg).append(suffix);
+			rec.size = spilled_size;
+		}
+
+		std::unique_lock lock{_mutex};
+
+		if (_ring->size() == Capacity) {
+			if constexpr (Overflow == log_overflow::DROP) {
+				++_dropped;
+				return;
+			} else if constexpr (Overflow == log_overflow::BLOCK) {
+				_space_cv.wait(lock, [this]() { return (_ring->size() < Capacity); });
+			} else {
+				// the ouroboros drops the oldest record, which counts as handled for flush()
+				++_dropped;
+				++_done;
+				if (_ring->front().size == spilled_size)
+					_spilled.pop_front();
+			}
+		}
+
+		// the writer only sleeps on an empty ring
+		bool was_empty = _ring->empty();
+
+		if (rec.size == spilled_size)
+			_spilled.push_back(std::move(spilled));
+		_ring->push_back(rec);
+		++_pushed;
+		lock.unlock();
+		if (was_empty)
+			_cv.notify_one();
+	}
+
+	/**
+	 * \brief Blocks until every line logged before the call is written to the sink, then flushes the sink's target if it can be.
+	 */
+	void flush() {
+		{
+			std::unique_lock lock{_mutex};
+			uint64           target = _pushed;
+
+			_done_cv.wait(lock, [this, target]() { return (_done >= target); });
+		}
+
+		std::scoped_lock lock{_sink_mutex};
+
+		if constexpr (requires { _sink.target->flush(); }) {
+			if (_sink.target)
+				_sink.target->flush();
+		} else if constexpr (requires { _sink.target.flush(); }) {
+			_sink.target.flush();
+		}
+	}
+
+	/**
+	 * \brief Calls a function with the sink, while the writer thread is not using it.
+	 */
+	template <std::invocable<Sink&> F>
+	decltype(auto) with_sink(F &&fun) {
+		std::scoped_lock lock{_sink_mutex};
+
+		return (std::invoke(std::forward<F>(fun), _sink));
+	}
+
+	/**
+	 * \brief Returns the number of lines lost to the overflow policy so far.
+	 */
+	[[nodiscard]] uint64 dropped() const noexcept {
+		return (_dropped.load(std::memory_order::relaxed));
+	}
+
+private:
+	static constexpr size_t batch_size = 32;
+	// size of the records standing for the next line of _spilled
+	static constexpr uint32 spilled_size = ~uint32{0};
+
+	static void _append(record &rec, std::string_view str) noexcept {
+		size_t n = min(str.size(), sizeof(rec.text) - rec.size);
+
+		std::memcpy(rec.text + rec.size, str.data(), n);
+		rec.size += static_cast<uint32>(n);
+	}
+
+	void _drain(std::stop_token stop) {
+		auto                     batch = std::make_unique_for_overwrite<record[]>(batch_size);
+		std::vector<std::string> spilled;
+
+		while (true) {
+			size_t count;
+
+			{
+				std::unique_lock lock{_mutex};
+
+				if (!_cv.wait(lock, stop, [this]() { return (!_ring->empty()); }))
+					return;
+				count = _ring->read({batch.get(), batch_size});
+				for (size_t i = 0; i < count; ++i) {
+					if (batch[i].size == spilled_size) {
+						spilled.push_back(std::move(_spilled.front()));
+						_spilled.pop_front();
+					}
+				}
+			}
+			_space_cv.notify_all();
+			{
+				std::scoped_lock lock{_sink_mutex};
+				size_t           next_spilled = 0;
+
+				for (size_t i = 0; i < count; ++i) {
+					if (batch[i].size == spilled_size)
+						_sink.log(batch[i].level, spilled[next_spilled++]);
+					else
+						_sink.log(batch[i].level, std::string_view{batch[i].text, batch[i].size});
+				}
+			}
+			spilled.clear();
+			{
+				std::scoped_lock lock{_mutex};
+
+				_done += count;
+			}
+			_done_cv.notify_all();
+		}
+	}
+
+	using ring_type = basic_ring<record, Capacity, Overflow == log_overflow::OVERWRITE>;
+
+	Sink                        _sink;
+	std::mutex                  _sink_mutex;
+	mutable std::mutex          _mutex;
+	std::condition_variable_any _cv;
+	std::condition_variable     _space_cv;
+	std::condition_variable     _done_cv;
+	std::unique_ptr<ring_type>  _ring{std::make_unique<ring_type>()};
+	// lines too long for a record, in the order of their records in the ring, under _mutex
+	std::deque<std::string>     _spilled;
+	uint64                      _pushed{0};
+	uint64                      _done{0};
+	std::atomic<uint64>         _dropped{0};
+	std::jthread                _thread;
+};
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_ASYNCLOGGER_H_ */
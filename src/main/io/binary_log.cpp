@@ -0,0 +1,308 @@
+#include "binary_log.h"
+
+#include <fmt/args.h>
+
+#include "file_stream.h"
+#include "../octahedron.h"
+#include "../tools/math.h"
+
+using namespace octahedron;
+
+namespace
+{
+constexpr std::array<char, 4> binary_log_magic{'O', 'C', 'T', 'L'};
+constexpr uint32              binary_log_version = 1;
+
+// ids are indices of call sites, anything past this comes from a corrupt log
+constexpr uint32 max_format_id = 1 << 16;
+// largest string or payload read from a stream whose size is unknown
+constexpr size_t max_unchecked_size = 1 << 24;
+
+enum class entry_kind : uint8 {
+	DEFINITION = 'D',
+	RECORD     = 'R'
+};
+
+struct format_registry {
+	std::mutex                     mutex;
+	std::vector<binary_log_format> formats;
+};
+
+format_registry &get_registry() {
+	static format_registry registry;
+
+	return (registry);
+}
+
+binary_log_format get_format(uint32 id) {
+	auto            &registry = get_registry();
+	std::scoped_lock lock{registry.mutex};
+
+	return (registry.formats[id]);
+}
+
+template <typename T>
+std::byte *put_raw(std::byte *out, const T &value) noexcept {
+	std::memcpy(out, &value, sizeof(T));
+	return (out + sizeof(T));
+}
+
+std::byte *put_raw(std::byte *out, std::string_view str) noexcept {
+	out = put_raw(out, static_cast<uint32>(str.size()));
+	std::memcpy(out, str.data(), str.size());
+	return (out + str.size());
+}
+
+constexpr size_t record_header_size = sizeof(entry_kind) + sizeof(uint32) + sizeof(uint32) + sizeof(uint64) + sizeof(uint32);
+
+template <typename T>
+bool get_raw(io_stream &stream, T &value) {
+	return (stream.read({reinterpret_cast<std::byte*>(&value), sizeof(T)}) == sizeof(T));
+}
+
+/**
+ * \brief Returns whether `size` bytes can still be read from the stream, checked before allocating for a size read from it.
+ */
+bool can_hold(io_stream &stream, size_t size) {
+	if (auto *seekable = dynamic_cast<seekable_stream*>(&stream)) {
+		size_t end = seekable->size();
+		size_t pos = seekable->tell();
+
+		if (end != error_size && pos != error_size)
+			return (pos <= end && size <= end - pos);
+	}
+	return (size <= max_unchecked_size);
+}
+
+bool get_raw(io_stream &stream, std::string &str) {
+	uint32 size;
+
+	if (!get_raw(stream, size) || !can_hold(stream, size))
+		return (false);
+	str.resize(size);
+	return (stream.read({reinterpret_cast<std::byte*>(str.data()), size}) == size);
+}
+
+template <typename T>
+bool take(std::span<const std::byte> &payload, T &value) {
+	if (payload.size() < sizeof(T))
+		return (false);
+	std::memcpy(&value, payload.data(), sizeof(T));
+	payload = payload.subspan(sizeof(T));
+	return (true);
+}
+
+template <typename T>
+bool push_arg(fmt::dynamic_format_arg_store<fmt::format_context> &store, std::span<const std::byte> &payload) {
+	T value;
+
+	if (!take(payload, value))
+		return (false);
+	store.push_back(value);
+	return (true);
+}
+
+bool push_string_arg(fmt::dynamic_format_arg_store<fmt::format_context> &store, std::span<const std::byte> &payload) {
+	uint32 size;
+
+	if (!take(payload, size) || payload.size() < size)
+		return (false);
+	store.push_back(std::string{reinterpret_cast<const char*>(payload.data()), size});
+	payload = payload.subspan(size);
+	return (true);
+}
+
+bool push_pointer_arg(fmt::dynamic_format_arg_store<fmt::format_context> &store, std::span<const std::byte> &payload) {
+	uint64 address;
+
+	if (!take(payload, address))
+		return (false);
+	store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(address)));
+	return (true);
+}
+
+bool push_args(fmt::dynamic_format_arg_store<fmt::format_context> &store, std::string_view signature, std::span<const std::byte> payload) {
+	for (char tag : signature) {
+		bool ok;
+
+		switch (tag) {
+			case 'b': ok = push_arg<bool>(store, payload); break;
+			case 'c': ok = push_arg<char>(store, payload); break;
+			case 'a': ok = push_arg<int8>(store, payload); break;
+			case 'h': ok = push_arg<int16>(store, payload); break;
+			case 'i': ok = push_arg<int32>(store, payload); break;
+			case 'l': ok = push_arg<int64>(store, payload); break;
+			case 'A': ok = push_arg<uint8>(store, payload); break;
+			case 'H': ok = push_arg<uint16>(store, payload); break;
+			case 'I': ok = push_arg<uint32>(store, payload); break;
+			case 'L': ok = push_arg<uint64>(store, payload); break;
+			case 'f': ok = push_arg<float>(store, payload); break;
+			case 'd': ok = push_arg<double>(store, payload); break;
+			case 'p': ok = push_pointer_arg(store, payload); break;
+			case 's': ok = push_string_arg(store, payload); break;
+			default: ok = false; break;
+		}
+		if (!ok)
+			return (false);
+	}
+	return (payload.empty());
+}
+} // namespace
+
+uint32 octahedron::_::register_binary_log_format(binary_log_format format) {
+	auto            &registry = get_registry();
+	std::scoped_lock lock{registry.mutex};
+
+	registry.formats.push_back(format);
+	return (static_cast<uint32>(registry.formats.size() - 1));
+}
+
+binary_logger::binary_logger(std::unique_ptr<io_stream> target, size_t buffer_size) :
+	_target{std::move(target)},
+	_buffer{std::make_unique_for_overwrite<std::byte[]>(max(buffer_size, record_header_size))},
+	_capacity{max(buffer_size, record_header_size)} {
+	std::byte *out = _buffer.get();
+
+	out = put_raw(out, binary_log_magic);
+	out = put_raw(out, binary_log_version);
+	_used = static_cast<size_t>(out - _buffer.get());
+}
+
+binary_logger::~binary_logger() {
+	flush();
+}
+
+void binary_logger::write(log_level level, std::string_view msg) {
+	_log(_::binary_log_site<"{}", std::string_view>::id, level, msg);
+}
+
+bool binary_logger::flush() {
+	std::scoped_lock lock{_mutex};
+
+	_flush();
+	if (auto *f = dynamic_cast<file_stream*>(_target.get()))
+		return (f->flush());
+	return (true);
+}
+
+void binary_logger::_flush() {
+	if (_target && _used > 0 && _target->write({_buffer.get(), _used}) != _used)
+		octahedron::log(log_level::DEBUG, "binary log: failed to write {} bytes", _used);
+	_used = 0;
+}
+
+void binary_logger::_reserve(size_t size) {
+	if (_used + size > _capacity)
+		_flush();
+	if (size > _capacity) {
+		_buffer = std::make_unique_for_overwrite<std::byte[]>(size);
+		_capacity = size;
+	}
+}
+
+auto binary_logger::_begin_record(uint32 id, log_level level, size_t payload_size) -> std::byte* {
+	size_t needed = record_header_size + payload_size;
+
+	if (id < _defined.size() && _defined[id]) {
+		_reserve(needed);
+	} else {
+		auto format = get_format(id);
+
+		_reserve(needed + sizeof(entry_kind) + sizeof(uint32) * 3 + format.format.size() + format.signature.size());
+		if (id >= _defined.size())
+			_defined.resize(id + 1);
+		_defined[id] = true;
+
+		std::byte *out = _buffer.get() + _used;
+
+		out = put_raw(out, entry_kind::DEFINITION);
+		out = put_raw(out, id);
+		out = put_raw(out, format.format);
+		out = put_raw(out, format.signature);
+		_used = static_cast<size_t>(out - _buffer.get());
+	}
+
+	auto       time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+	std::byte *out = _buffer.get() + _used;
+
+	out = put_raw(out, entry_kind::RECORD);
+	out = put_raw(out, id);
+	out = put_raw(out, static_cast<uint32>(level));
+	out = put_raw(out, static_cast<uint64>(time.count()));
+	out = put_raw(out, static_cast<uint32>(payload_size));
+	_used = static_cast<size_t>(out - _buffer.get()) + payload_size;
+	return (out);
+}
+
+binary_log_reader::binary_log_reader(io_stream &stream) :
+	_stream{stream} {
+	std::array<char, 4> magic;
+	uint32              version;
+
+	_valid = get_raw(_stream, magic) && magic == binary_log_magic && get_raw(_stream, version) && version == binary_log_version;
+	if (!_valid)
+		log(log_level::DEBUG, "binary log: bad header");
+}
+
+bool binary_log_reader::valid() const noexcept {
+	return (_valid);
+}
+
+bool binary_log_reader::_read_definition() {
+	uint32 id;
+	format fmt;
+
+	if (!get_raw(_stream, id) || id >= max_format_id || !get_raw(_stream, fmt.format) || !get_raw(_stream, fmt.signature))
+		return (false);
+	if (id >= _formats.size())
+		_formats.resize(id + 1);
+	_formats[id] = std::move(fmt);
+	return (true);
+}
+
+auto binary_log_reader::next() -> std::optional<line> {
+	if (!_valid)
+		return (std::nullopt);
+
+	entry_kind kind;
+
+	while (get_raw(_stream, kind)) {
+		if (kind == entry_kind::DEFINITION) {
+			if (!_read_definition())
+				break;
+			continue;
+		}
+		if (kind != entry_kind::RECORD)
+			break;
+
+		uint32 id;
+		uint32 level;
+		uint64 time;
+		uint32 size;
+
+		if (!get_raw(_stream, id) || !get_raw(_stream, level) || !get_raw(_stream, time) || !get_raw(_stream, size) ||
+				!can_hold(_stream, size))
+			break;
+
+		std::vector<std::byte> payload(size);
+
+		if (_stream.read(payload) != size || id >= _formats.size() || !_formats[id])
+			break;
+
+		fmt::dynamic_format_arg_store<fmt::format_context> store;
+		line                                               ret{log_level{level}, std::chrono::nanoseconds{time}, {}};
+
+		if (!push_args(store, _formats[id]->signature, payload)) {
+			ret.text = fmt::format("<malformed arguments for \"{}\">", _formats[id]->format);
+			return (ret);
+		}
+		try {
+			ret.text = fmt::vformat(_formats[id]->format, store);
+		} catch (const fmt::format_error &e) {
+			ret.text = fmt::format("<{} formatting \"{}\">", e.what(), _formats[id]->format);
+		}
+		return (ret);
+	}
+	_valid = false;
+	return (std::nullopt);
+}
@@ -0,0 +1,253 @@
+#ifndef OCTAHEDRON_BINARYLOG_H_
+#define OCTAHEDRON_BINARYLOG_H_
+
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "io_stream.h"
+#include "logger.h"
+#include "../tools/string_literal.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief Format string registered for binary logging, with the type signature of its arguments.
+ *
+ * The signature has one character per argument, see binary_log_arg.
+ */
+struct binary_log_format {
+	std::string_view format;
+	std::string_view signature;
+};
+
+namespace _
+{
+
+/**
+ * \brief Registers a format string, returning its ID. IDs are only meaningful within a process; log files carry the definitions.
+ */
+uint32 register_binary_log_format(binary_log_format format);
+
+template <typename T>
+struct binary_log_arg;
+
+template <typename T>
+concept binary_loggable = requires { binary_log_arg<T>::tag; };
+
+/**
+ * \brief How argument types are stored: fixed-size values are copied as-is, strings as a 32-bit length then their characters.
+ *
+ * value_type is the type the argument is formatted as when decoded.
+ */
+template <typename T> requires (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>)
+struct binary_log_arg<T> {
+	using value_type = T;
+
+	static constexpr char tag = [] {
+		if constexpr (std::is_same_v<T, bool>)
+			return ('b');
+		else if constexpr (std::is_same_v<T, char>)
+			return ('c');
+		else if constexpr (std::is_same_v<T, float>)
+			return ('f');
+		else if constexpr (std::is_same_v<T, double>)
+			return ('d');
+		else {
+			constexpr char tags[] = "ahilAHIL";
+
+			return (tags[std::countr_zero(sizeof(T)) + (std::is_unsigned_v<T> ? 4 : 0)]);
+		}
+	}();
+
+	static size_t size(T) noexcept {
+		return (sizeof(T));
+	}
+
+	static std::byte *put(std::byte *out, T value) noexcept {
+		std::memcpy(out, &value, sizeof(T));
+		return (out + sizeof(T));
+	}
+};
+
+template <typename T> requires (std::is_enum_v<T>)
+struct binary_log_arg<T> : binary_log_arg<std::underlying_type_t<T>> {
+	using value_type = std::underlying_type_t<T>;
+
+	static size_t size(T) noexcept {
+		return (sizeof(T));
+	}
+
+	static std::byte *put(std::byte *out, T value) noexcept {
+		return (binary_log_arg<std::underlying_type_t<T>>::put(out, static_cast<std::underlying_type_t<T>>(value)));
+	}
+};
+
+template <typename T> requires (std::is_pointer_v<T> && !std::is_convertible_v<T, const char*>)
+struct binary_log_arg<T> {
+	using value_type = const void*;
+
+	static constexpr char tag = 'p';
+
+	static size_t size(T) noexcept {
+		return (sizeof(uint64));
+	}
+
+	static std::byte *put(std::byte *out, T value) noexcept {
+		auto address = static_cast<uint64>(reinterpret_cast<uintptr_t>(value));
+
+		std::memcpy(out, &address, sizeof(address));
+		return (out + sizeof(address));
+	}
+};
+
+template <typename T> requires (std::is_convertible_v<const T&, std::string_view>)
+struct binary_log_arg<T> {
+	using value_type = std::string_view;
+
+	static constexpr char tag = 's';
+
+	static size_t size(const T &value) noexcept {
+		return (sizeof(uint32) + std::string_view{value}.size());
+	}
+
+	static std::byte *put(std::byte *out, const T &value) noexcept {
+		std::string_view str{value};
+		auto             length = static_cast<uint32>(str.size());
+
+		std::memcpy(out, &length, sizeof(length));
+		std::memcpy(out + sizeof(length), str.data(), str.size());
+		return (out + sizeof(length) + str.size());
+	}
+};
+
+template <string_literal Fmt, typename... Args>
+struct binary_log_site {
+	static constexpr char signature[] = {binary_log_arg<Args>::tag..., '\0'};
+
+	inline static const uint32 id = register_binary_log_format({Fmt, {signature, sizeof...(Args)}});
+};
+
+} // namespace _
+
+/**
+ * \brief Logger storing a format string ID and the raw arguments of each line, formatting being left to binary_log_reader.
+ *
+ * Lines logged with `log<"format">(level, args...)` cost a lock and a copy of the arguments into a write buffer,
+ * which is written to the target stream when full or on flush(). Arguments can be integers, floating point, enums,
+ * pointers and strings; callables are invoked first, like with the other loggers. Lines logged through the regular
+ * logger interface, for example by a logger_system, are stored as a single string argument.
+ *
+ * The first time a format is used in a stream, its string and signature are written before the line,
+ * which makes log files self-describing. Values are stored in native byte order.
+ */
+class binary_logger : public logger_base<binary_logger> {
+public:
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 65536;
+
+	using logger_base::log;
+
+	explicit binary_logger(std::unique_ptr<io_stream> target, size_t buffer_size = DEFAULT_BUFFER_SIZE);
+	~binary_logger();
+
+	binary_logger(const binary_logger &) = delete;
+	binary_logger& operator=(const binary_logger &) = delete;
+
+	template <string_literal Fmt, typename... Args>
+	void log(log_level level, Args &&... args) {
+		using site = _::binary_log_site<Fmt, std::remove_cvref_t<to_loggable<Args>>...>;
+
+		static_assert((_::binary_loggable<std::remove_cvref_t<to_loggable<Args>>> && ...), "argument type cannot be logged in binary");
+		[[maybe_unused]] constexpr fmt::format_string<typename _::binary_log_arg<std::remove_cvref_t<to_loggable<Args>>>::value_type...> check{std::string_view{Fmt}};
+
+		if (!(level & this->level))
+			return;
+		_log(site::id, level, loggable_helper<Args>{}(std::forward<Args>(args))...);
+	}
+
+	void write(log_level level, std::string_view msg);
+
+	/**
+	 * \brief Writes the buffered lines to the target stream.
+	 */
+	bool flush();
+
+private:
+	template <typename... Args>
+	void _log(uint32 id, log_level level, const Args &... args) {
+		size_t size = (size_t{0} + ... + _::binary_log_arg<std::remove_cvref_t<Args>>::size(args));
+
+		std::scoped_lock lock{_mutex};
+		std::byte       *out = _begin_record(id, level, size);
+
+		((out = _::binary_log_arg<std::remove_cvref_t<Args>>::put(out, args)), ...);
+	}
+
+	/**
+	 * \brief Appends a record header to the buffer, preceded by the format definition if needed, and reserves its payload.
+	 * \return Where to write the payload
+	 */
+	std::byte *_begin_record(uint32 id, log_level level, size_t payload_size);
+
+	/**
+	 * \brief Makes room for `size` contiguous bytes at the end of the buffer, writing it out or growing it.
+	 */
+	void _reserve(size_t size);
+
+	void _flush();
+
+	std::unique_ptr<io_stream>            _target;
+	std::mutex                            _mutex;
+	std::unique_ptr<std::byte[]>          _buffer;
+	size_t                                _capacity;
+	size_t                                _used{0};
+	std::vector<bool>                     _defined;
+	std::chrono::steady_clock::time_point _start{std::chrono::steady_clock::now()};
+};
+
+/**
+ * \brief Decodes and formats the lines of a stream written by binary_logger.
+ */
+class binary_log_reader {
+public:
+	struct line {
+		log_level                level;
+		std::chrono::nanoseconds time;
+		std::string              text;
+	};
+
+	explicit binary_log_reader(io_stream &stream);
+
+	/**
+	 * \brief Returns whether the stream starts with a valid header.
+	 */
+	[[nodiscard]] bool valid() const noexcept;
+
+	/**
+	 * \brief Reads and formats the next line.
+	 * \return The line, or nullopt at the end of the stream or on a malformed record.
+	 */
+	std::optional<line> next();
+
+private:
+	struct format {
+		std::string format;
+		std::string signature;
+	};
+
+	bool _read_definition();
+
+	io_stream                          &_stream;
+	std::vector<std::optional<format>> _formats;
+	bool                               _valid{false};
+};
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_BINARYLOG_H_ */
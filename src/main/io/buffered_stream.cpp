@@ -0,0 +1,157 @@
+#include "buffered_stream.h"
+
+#include "../tools/math.h"
+
+using namespace octahedron;
+
+buffered_stream::buffered_stream(std::unique_ptr<seekable_stream> stream, size_t buffer_size) :
+	_stream{std::move(stream)},
+	_buffer{std::make_unique_for_overwrite<std::byte[]>(max(buffer_size, size_t{1}))},
+	_capacity{max(buffer_size, size_t{1})} {
+}
+
+bool buffered_stream::_fill() {
+	_pos = 0;
+	_end = 0;
+
+	size_t read = _stream->read({_buffer.get(), _capacity});
+
+	if (read == 0 || read == error_size) {
+		_at_end = true;
+		return (false);
+	}
+	_end = read;
+	return (true);
+}
+
+void buffered_stream::_discard() {
+	if (_pos < _end)
+		_stream->seek(-static_cast<ssize_t>(_end - _pos), SEEK_CUR);
+	_pos = 0;
+	_end = 0;
+}
+
+size_t buffered_stream::_read_slow(std::span<std::byte> buf) {
+	size_t total = _end - _pos;
+
+	std::memcpy(buf.data(), _buffer.get() + _pos, total);
+	_pos = 0;
+	_end = 0;
+	while (total < buf.size()) {
+		size_t left = buf.size() - total;
+
+		if (left >= _capacity) {
+			// large reads skip the window entirely
+			size_t read = _stream->read(buf.subspan(total));
+
+			if (read == 0 || read == error_size) {
+				_at_end = true;
+				break;
+			}
+			total += read;
+			continue;
+		}
+		if (!_fill())
+			break;
+
+		size_t to_copy = min(left, _end);
+
+		std::memcpy(buf.data() + total, _buffer.get(), to_copy);
+		_pos = to_copy;
+		total += to_copy;
+	}
+	return (total);
+}
+
+bool buffered_stream::flush() {
+	if (auto *f = dynamic_cast<file_stream*>(_stream.get()))
+		return (f->flush());
+	return (true);
+}
+
+bool buffered_stream::eof() {
+	return (_pos >= _end && _at_end);
+}
+
+uint32 buffered_stream::crc32() {
+	if (auto *f = dynamic_cast<file_stream*>(_stream.get()))
+		return (f->crc32());
+	return (0);
+}
+
+size_t buffered_stream::tell() const {
+	size_t pos = _stream->tell();
+
+	if (pos == error_size)
+		return (error_size);
+	return (pos - (_end - _pos));
+}
+
+bool buffered_stream::seek(ssize_t pos, int whence) {
+	size_t stream_pos = (whence == SEEK_END ? error_size : _stream->tell());
+
+	if (stream_pos != error_size) {
+		auto window_end = static_cast<ssize_t>(stream_pos);
+		auto window_start = window_end - static_cast<ssize_t>(_end);
+		auto target = (whence == SEEK_CUR ? window_start + static_cast<ssize_t>(_pos) + pos : pos);
+
+		if (target >= window_start && target <= window_end) {
+			_pos = static_cast<size_t>(target - window_start);
+			return (true);
+		}
+		_pos = 0;
+		_end = 0;
+		_at_end = false;
+		return (target >= 0 && _stream->seek(target, SEEK_SET));
+	}
+
+	auto ahead = static_cast<ssize_t>(_end - _pos);
+
+	_pos = 0;
+	_end = 0;
+	_at_end = false;
+	if (whence == SEEK_CUR)
+		return (_stream->seek(pos - ahead, SEEK_CUR));
+	return (_stream->seek(pos, whence));
+}
+
+size_t buffered_stream::size() {
+	return (_stream->size());
+}
+
+size_t buffered_stream::write(std::span<const std::byte> buf) {
+	_discard();
+	_at_end = false;
+	return (_stream->write(buf));
+}
+
+std::optional<std::string> buffered_stream::get_next_line(size_t max_size) {
+	std::string ret;
+
+	while (ret.size() < max_size) {
+		if (_pos >= _end && !_fill())
+			return (ret);
+
+		auto   begin = reinterpret_cast<const char*>(_buffer.get() + _pos);
+		size_t to_scan = min(max_size - ret.size(), _end - _pos);
+		size_t length = 0;
+
+		while (length < to_scan && begin[length] != '\n' && begin[length] != 0)
+			++length;
+		ret.append(begin, length);
+		_pos += length;
+		if (length < to_scan) {
+			++_pos; // consume the terminator
+			return (ret);
+		}
+	}
+	return (ret);
+}
+
+auto buffered_stream::underlying() const noexcept -> seekable_stream* {
+	return (_stream.get());
+}
+
+auto buffered_stream::buffer_size() const noexcept -> size_t {
+	return (_capacity);
+}
@@ -0,0 +1,86 @@
+#ifndef OCTAHEDRON_BUFFEREDSTREAM_H_
+#define OCTAHEDRON_BUFFEREDSTREAM_H_
+
+#include <cstring>
+#include <memory>
+#include <span>
+
+#include "file_stream.h"
+#include "../base.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief File stream decorator keeping a read-ahead window over any seekable_stream.
+ *
+ * Reads that fit in the window are a bounds check and a memcpy; the underlying stream is only
+ * called to refill the window or for reads larger than it. When used through its own type,
+ * get and read are resolved statically and inline, which is what makes small typed reads cheap;
+ * through a file_stream pointer, they still go through the window, behind one virtual call.
+ *
+ * Writes are passed through to the underlying stream after discarding the read-ahead.
+ */
+class buffered_stream final : public file_stream, public io_read_interface<buffered_stream> {
+public:
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 16384;
+
+	using io_read_interface<buffered_stream>::get;
+	using io_read_interface<buffered_stream>::read;
+	using file_stream::write;
+
+	explicit buffered_stream(
+		std::unique_ptr<seekable_stream> stream,
+		size_t                           buffer_size = DEFAULT_BUFFER_SIZE
+	);
+	~buffered_stream() override = default;
+	buffered_stream(const buffered_stream &) = delete;
+
+	bool                 flush() override;
+	bool                 eof() override;
+	uint32               crc32() override;
+	[[nodiscard]] size_t tell() const override;
+	bool                 seek(ssize_t pos, int whence) override;
+	size_t               size() override;
+
+	size_t read(std::span<std::byte> buf) override {
+		if (buf.size() <= _end - _pos) [[likely]] {
+			std::memcpy(buf.data(), _buffer.get() + _pos, buf.size());
+			_pos += buf.size();
+			return (buf.size());
+		}
+		return (_read_slow(buf));
+	}
+
+	size_t write(std::span<const std::byte> buf) override;
+
+	std::optional<std::string> get_next_line(size_t max_size = (2uLL << 15)) override;
+
+	/**
+	 * \brief Returns the stream being buffered.
+	 *
+	 * Its position is ahead of this stream's by however much is left in the read-ahead window.
+	 */
+	[[nodiscard]] seekable_stream *underlying() const noexcept;
+
+	/**
+	 * \brief Returns the size of the read-ahead window.
+	 */
+	[[nodiscard]] size_t buffer_size() const noexcept;
+
+private:
+	size_t _read_slow(std::span<std::byte> buf);
+	bool   _fill();
+	void   _discard();
+
+	std::unique_ptr<seekable_stream> _stream;
+	std::unique_ptr<std::byte[]>     _buffer;
+	size_t                           _capacity;
+	size_t                           _pos{0};
+	size_t                           _end{0};
+	bool                             _at_end{false};
+};
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_BUFFEREDSTREAM_H_ */
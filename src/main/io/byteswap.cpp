@@ -0,0 +1,148 @@
+#include "byteswap.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "base.h"
+#include "tools/cpu.h"
+
+#ifdef OCTAHEDRON_SSE2
+#  include <immintrin.h>
+#endif
+
+using namespace octahedron;
+
+namespace
+{
+
+template <size_t ValueSize>
+using unsigned_integer = std::conditional_t<ValueSize == 2, uint16, std::conditional_t<ValueSize == 4, uint32, uint64>>;
+
+template <size_t ValueSize>
+void byteswap_scalar(std::byte *dst, const std::byte *src, size_t count) noexcept {
+	using T = unsigned_integer<ValueSize>;
+
+	for (size_t i = 0; i < count; ++i) {
+		T value;
+
+		std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+		if constexpr (sizeof(T) == 2)
+			value = static_cast<T>((value >> 8) | (value << 8));
+		else if constexpr (sizeof(T) == 4)
+			value = ((value >> 24) | ((value >> 8) & 0xFF00u) | ((value << 8) & 0xFF0000u) | (value << 24));
+		else
+			value = ((value >> 56) | ((value >> 40) & 0xFF00ull) | ((value >> 24) & 0xFF0000ull) | ((value >> 8) & 0xFF000000ull) |
+			         ((value << 8) & 0xFF00000000ull) | ((value << 24) & 0xFF0000000000ull) | ((value << 40) & 0xFF000000000000ull) | (value << 56));
+		std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+	}
+}
+
+void byteswap_generic(std::byte *dst, const std::byte *src, size_t count, size_t value_size) noexcept {
+	for (size_t i = 0; i < count; ++i) {
+		std::byte       *out = dst + i * value_size;
+		const std::byte *in = src + i * value_size;
+
+		if (out == in)
+			std::reverse(out, out + value_size);
+		else
+			std::reverse_copy(in, in + value_size, out);
+	}
+}
+
+void byteswap_fallback(std::byte *dst, const std::byte *src, size_t count, size_t value_size) noexcept {
+	switch (value_size) {
+		case 2:
+			byteswap_scalar<2>(dst, src, count);
+			break;
+		case 4:
+			byteswap_scalar<4>(dst, src, count);
+			break;
+		case 8:
+			byteswap_scalar<8>(dst, src, count);
+			break;
+
+		default:
+			byteswap_generic(dst, src, count, value_size);
+	}
+}
+
+#ifdef OCTAHEDRON_SSE2
+/**
+ * \brief pshufb control reversing each `value_size`-byte lane of a 16-byte block.
+ */
+template <size_t ValueSize>
+constexpr auto shuffle_mask = [] {
+	std::array<char, 16> ret{};
+
+	for (size_t i = 0; i < ret.size(); ++i)
+		ret[i] = static_cast<char>((i / ValueSize) * ValueSize + (ValueSize - 1 - i % ValueSize));
+	return (ret);
+}();
+
+template <size_t ValueSize>
+OCTAHEDRON_TARGET("ssse3")
+void byteswap_ssse3(std::byte *dst, const std::byte *src, size_t count) noexcept {
+	const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_mask<ValueSize>.data()));
+	size_t        size = count * ValueSize;
+	size_t        i = 0;
+
+	for (; i + 16 <= size; i += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(block, mask));
+	}
+	byteswap_fallback(dst + i, src + i, (size - i) / ValueSize, ValueSize);
+}
+
+template <size_t ValueSize>
+OCTAHEDRON_TARGET("avx2")
+void byteswap_avx2(std::byte *dst, const std::byte *src, size_t count) noexcept {
+	// vpshufb works within each 16-byte half, which never splits a value
+	const __m256i mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_mask<ValueSize>.data())));
+	size_t        size = count * ValueSize;
+	size_t        i = 0;
+
+	for (; i + 32 <= size; i += 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(block, mask));
+	}
+	byteswap_fallback(dst + i, src + i, (size - i) / ValueSize, ValueSize);
+}
+
+template <size_t ValueSize>
+void byteswap_vector(std::byte *dst, const std::byte *src, size_t count) noexcept {
+	static const auto impl = [] {
+		if (get_cpu_features().avx2)
+			return (&byteswap_avx2<ValueSize>);
+		if (get_cpu_features().ssse3)
+			return (&byteswap_ssse3<ValueSize>);
+		return (&byteswap_scalar<ValueSize>);
+	}();
+
+	impl(dst, src, count);
+}
+#endif
+
+} // namespace
+
+void octahedron::byteswap_values(void *dst, const void *src, size_t count, size_t value_size) noexcept {
+	auto       *out = static_cast<std::byte*>(dst);
+	const auto *in = static_cast<const std::byte*>(src);
+
+#ifdef OCTAHEDRON_SSE2
+	switch (value_size) {
+		case 2:
+			byteswap_vector<2>(out, in, count);
+			return;
+		case 4:
+			byteswap_vector<4>(out, in, count);
+			return;
+		case 8:
+			byteswap_vector<8>(out, in, count);
+			return;
+	}
+#endif
+	byteswap_fallback(out, in, count, value_size);
+}
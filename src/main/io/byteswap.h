@@ -0,0 +1,19 @@
+#ifndef OCTAHEDRON_BYTESWAP_H_
+#define OCTAHEDRON_BYTESWAP_H_
+
+#include <cstddef>
+
+namespace octahedron
+{
+
+/**
+ * \brief Reverses the byte order of `count` consecutive values of `value_size` bytes each, from `src` into `dst`.
+ *
+ * `dst` may be `src` to convert in place, but the buffers must not otherwise overlap. Sizes of 2, 4 and 8 bytes
+ * are converted 16 or 32 bytes at a time with SSSE3 or AVX2 when the CPU supports them.
+ */
+void byteswap_values(void *dst, const void *src, size_t count, size_t value_size) noexcept;
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_BYTESWAP_H_ */
@@ -1,6 +1,13 @@
 #include "encoding.h"
 
 #include <bit>
+#include <cstring>
+
+#include "tools/cpu.h"
+
+#ifdef OCTAHEDRON_SSE2
+#  include <immintrin.h>
+#endif
 
 using namespace octahedron;
 
@@ -20,3 +27,73 @@ std::string utf8_to_cube(std::u8string_view src) {
 		ret.erase(++dst, ret.end());
 	return (std::move(ret));
 }
+
+namespace
+{
+
+size_t ascii_prefix_scalar(const char8 *data, size_t size) noexcept {
+	constexpr uint64 high_bits = 0x8080808080808080ull;
+	size_t           i = 0;
+
+	for (; i + sizeof(uint64) <= size; i += sizeof(uint64)) {
+		uint64 word;
+
+		std::memcpy(&word, data + i, sizeof(word));
+		if (uint64 high = word & high_bits; high != 0) {
+			if constexpr (std::endian::native == std::endian::little)
+				return (i + std::countr_zero(high) / 8);
+			else
+				return (i + std::countl_zero(high) / 8);
+		}
+	}
+	while (i < size && static_cast<uint8>(data[i]) < 0x80)
+		++i;
+	return (i);
+}
+
+#ifdef OCTAHEDRON_SSE2
+size_t ascii_prefix_sse2(const char8 *data, size_t size) noexcept {
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+		if (int mask = _mm_movemask_epi8(block); mask != 0)
+			return (i + std::countr_zero(static_cast<unsigned>(mask)));
+	}
+	return (i + ascii_prefix_scalar(data + i, size - i));
+}
+
+OCTAHEDRON_TARGET("avx2")
+size_t ascii_prefix_avx2(const char8 *data, size_t size) noexcept {
+	size_t i = 0;
+
+	for (; i + 32 <= size; i += 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+		if (int mask = _mm256_movemask_epi8(block); mask != 0)
+			return (i + std::countr_zero(static_cast<unsigned>(mask)));
+	}
+	return (i + ascii_prefix_sse2(data + i, size - i));
+}
+#endif
+
+using ascii_prefix_fn = size_t (*)(const char8*, size_t) noexcept;
+
+ascii_prefix_fn select_ascii_prefix() noexcept {
+#ifdef OCTAHEDRON_SSE2
+	if (get_cpu_features().avx2)
+		return (&ascii_prefix_avx2);
+	return (&ascii_prefix_sse2);
+#else
+	return (&ascii_prefix_scalar);
+#endif
+}
+
+const ascii_prefix_fn ascii_prefix_impl = select_ascii_prefix();
+
+} // namespace
+
+size_t octahedron::ascii_prefix_size(std::span<char8 const> buf) noexcept {
+	return (ascii_prefix_impl(buf.data(), buf.size()));
+}
@@ -304,6 +304,13 @@ constexpr auto utf8_char_to_cube(In &&src, OutIt dst) {
 	return (utf8_char_to_cube(std::begin(src), std::end(src), dst));
 }
 
+/**
+ * \brief Returns how many bytes at the start of a buffer are ASCII, checking 16 or 32 bytes at a time when the CPU allows it.
+ *
+ * ASCII bytes are the same in UTF-8 and in the cube encoding, so such a run can be copied as-is.
+ */
+size_t ascii_prefix_size(std::span<char8 const> buf) noexcept;
+
 std::u8string cube_to_utf8(std::string_view src);
 
 std::string utf8_to_cube(std::u8string_view src);
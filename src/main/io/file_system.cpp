@@ -3,14 +3,23 @@
 #include "file_system.h"
 
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 
 #include <fmt/std.h>
 
 #include <SDL_RWops.h>
 
 #include "gz_file_stream.h"
+#include "mapped_file_stream.h"
 #include "raw_file_stream.h"
 
+#ifdef __linux__
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
 namespace octahedron {
 
 auto get_user_home_dir() -> std::optional<stdfs::path> {
@@ -69,6 +78,160 @@ auto full_path(stdfs::path str) -> std::optional<stdfs::path> {
 	return {ret};
 }
 
+/**
+ * \brief Every path found under the package directories, mapped to the first directory it is in.
+ */
+struct file_system::package_index {
+	package_index() = default;
+	package_index(const package_index &) = delete;
+
+	~package_index() {
+		_close_watch();
+	}
+
+	static std::string key(const stdfs::path &path) {
+		std::string ret = path.generic_string();
+
+		if (ret.size() > 1 && ret.back() == '/')
+			ret.pop_back();
+		#ifdef _WIN32
+		std::ranges::transform(ret, ret.begin(), [](char c) { return (static_cast<char>(std::tolower(c))); });
+		#endif
+		return (ret);
+	}
+
+	void build(std::span<const stdfs::path> dirs) {
+		constexpr auto options = stdfs::directory_options::follow_directory_symlink |
+		                         stdfs::directory_options::skip_permission_denied;
+
+		entries.clear();
+		_close_watch();
+		if (watching)
+			_open_watch();
+		for (size_t i = 0; i < dirs.size(); ++i) {
+			std::error_code err;
+
+			_watch(dirs[i]);
+			for (auto it = stdfs::recursive_directory_iterator(dirs[i], options, err);
+					 !err && it != stdfs::recursive_directory_iterator(); it.increment(err)) {
+				if (it->is_directory(err))
+					_watch(it->path());
+				// the first package directory containing a path wins
+				entries.try_emplace(key(it->path().lexically_relative(dirs[i])), i);
+			}
+			if (err)
+				log(log_level::WARN, "error while indexing package dir {}: {}", dirs[i], CLOSURE(err.message()));
+		}
+		dirty = false;
+		++stats.rebuilds;
+	}
+
+	/**
+	 * \brief Marks the index dirty if the watched directories changed since the last call.
+	 */
+	void poll() {
+		#ifdef __linux__
+		if (_watch_fd < 0)
+			return;
+
+		alignas(inotify_event) char buffer[4096];
+
+		while (::read(_watch_fd, buffer, sizeof(buffer)) > 0)
+			dirty = true;
+		#endif
+	}
+
+	std::mutex                              mutex;
+	std::unordered_map<std::string, size_t> entries;
+	path_cache_stats                        stats;
+	bool                                    dirty{true};
+	bool                                    watching{false};
+
+private:
+	void _open_watch() {
+		#ifdef __linux__
+		_watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (_watch_fd < 0)
+			log(log_level::WARN, "could not start watching package dirs");
+		#endif
+	}
+
+	void _close_watch() {
+		#ifdef __linux__
+		if (_watch_fd >= 0)
+			::close(_watch_fd);
+		_watch_fd = -1;
+		#endif
+	}
+
+	void _watch([[maybe_unused]] const stdfs::path &dir) {
+		#ifdef __linux__
+		constexpr uint32_t events = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+
+		if (_watch_fd >= 0 && inotify_add_watch(_watch_fd, dir.c_str(), events) < 0)
+			log(log_level::DEBUG, "could not watch {}", dir);
+		#endif
+	}
+
+	#ifdef __linux__
+	int _watch_fd{-1};
+	#endif
+};
+
+file_system::file_system() :
+	_index{std::make_unique<package_index>()} {
+}
+
+file_system::~file_system() = default;
+// the moved-from file system keeps an index of its own, so that it stays usable
+file_system::file_system(file_system &&other) noexcept :
+	_home_dir{std::move(other._home_dir)},
+	_package_dirs{std::move(other._package_dirs)},
+	_index{std::exchange(other._index, std::make_unique<package_index>())},
+	_jobs{std::exchange(other._jobs, nullptr)} {
+}
+
+file_system& file_system::operator=(file_system &&other) noexcept {
+	_home_dir = std::move(other._home_dir);
+	_package_dirs = std::move(other._package_dirs);
+	std::swap(_index, other._index);
+	_jobs = std::exchange(other._jobs, nullptr);
+	other.rescan();
+	return (*this);
+}
+
+void file_system::rescan() {
+	std::scoped_lock lock{_index->mutex};
+
+	_index->dirty = true;
+}
+
+bool file_system::watch_package_dirs(bool enable) {
+	#ifdef __linux__
+	std::scoped_lock lock{_index->mutex};
+
+	if (_index->watching != enable) {
+		_index->watching = enable;
+		_index->dirty = true;
+	}
+	return (true);
+	#else
+	return (!enable);
+	#endif
+}
+
+auto file_system::get_path_cache_stats() const -> path_cache_stats {
+	std::scoped_lock lock{_index->mutex};
+
+	return (_index->stats);
+}
+
+void file_system::reset_path_cache_stats() {
+	std::scoped_lock lock{_index->mutex};
+
+	_index->stats = {.rebuilds = _index->stats.rebuilds};
+}
+
 void file_system::set_home_dir(std::string_view dir) {
 	auto path = full_path(replace_home_token(dir));
 
@@ -88,6 +251,15 @@ void file_system::add_package_dir(std::string_view file) {
 		return;
 	}
 	_package_dirs.push_back(*path);
+	rescan();
+}
+
+void file_system::set_job_system(job_system *jobs) noexcept {
+	_jobs = jobs;
+}
+
+auto file_system::get_job_system() const noexcept -> job_system* {
+	return (_jobs);
 }
 
 auto file_system::get_home_dir() const noexcept -> const stdfs::path& {
@@ -116,20 +288,56 @@ auto file_system::open(
 
 	if (!_path)
 		return {nullptr};
-	if (mode & (open_flags::APPEND | open_flags::TRUNCATE))
-		_create_folders(_path->parent_path());
-	return (raw_file_stream::_open(*_path, mode));
+	return (_open_resolved(*_path, mode));
 }
 
 auto file_system::open_gz(
 	std::string_view    path,
 	bit_set<open_flags> mode
 ) -> std::unique_ptr<file_stream> {
-	auto raw_file = open(path, mode);
+	auto _path = _resolve_path(path, mode);
+
+	if (!_path)
+		return {nullptr};
+	return (_open_gz_resolved(*_path, mode));
+}
+
+auto file_system::_open_resolved(
+	const stdfs::path & path,
+	bit_set<open_flags> mode
+) -> std::unique_ptr<file_stream> {
+	if (mode & (open_flags::APPEND | open_flags::TRUNCATE))
+		_create_folders(path.parent_path());
+	if (mode & open_flags::MAPPED && !(mode & open_flags::OUTPUT)) {
+		if (auto mapped = mapped_file_stream::_open(path, mode))
+			return (mapped);
+		log(log_level::TRACE, "could not map {}, falling back to a raw file stream", path);
+	}
+	return (raw_file_stream::_open(path, mode));
+}
+
+auto file_system::_open_gz_resolved(
+	const stdfs::path & path,
+	bit_set<open_flags> mode
+) -> std::unique_ptr<file_stream> {
+	auto raw_file = _open_resolved(path, mode);
 
 	if (!raw_file)
 		return {nullptr};
-	return (gz_file_stream::_from_raw_stream(std::move(raw_file), mode));
+
+	auto ret = gz_file_stream::_from_raw_stream(std::move(raw_file), mode, _jobs);
+
+	// a seek index saved next to the file saves rebuilding it
+	if (ret && mode & open_flags::INDEXED && mode & open_flags::INPUT) {
+		stdfs::path index_path{path};
+
+		index_path += ".idx";
+		if (_is_accessible(index_path)) {
+			if (auto index = raw_file_stream::_open(index_path, open_flags::INPUT | open_flags::BINARY))
+				ret->load_index(*index);
+		}
+	}
+	return (ret);
 }
 
 SDL_RWops *file_system::openSDLRWops(
@@ -207,16 +415,37 @@ std::optional<stdfs::path> file_system::_resolve_path(
 	if (search_mode & open_flags::OUTPUT)
 		return {std::nullopt};
 	// package directories have second priority
-	for (const stdfs::path &dir : get_package_dirs()) {
-		if (auto path = stdfs::absolute(dir / given); _is_accessible(path, search_mode))
-			return {path};
-	}
+	if (auto path = _find_in_packages(given))
+		return {path};
 	// path relative to the working directory has lowest priority
 	if (_is_accessible(given, search_mode))
 		return {given};
 	return {std::nullopt};
 }
 
+auto file_system::_find_in_packages(const stdfs::path &path) const -> std::optional<stdfs::path> {
+	if (_package_dirs.empty())
+		return {std::nullopt};
+	// the index only holds what is below the package directories, not the directories themselves
+	if (path.empty() || path == ".") {
+		if (auto ret = stdfs::absolute(_package_dirs.front() / path); _is_accessible(ret))
+			return {ret};
+		return {std::nullopt};
+	}
+
+	std::scoped_lock lock{_index->mutex};
+
+	_index->poll();
+	if (_index->dirty)
+		_index->build(_package_dirs);
+	if (auto it = _index->entries.find(package_index::key(path)); it != _index->entries.end()) {
+		++_index->stats.hits;
+		return {stdfs::absolute(_package_dirs[it->second] / path)};
+	}
+	++_index->stats.misses;
+	return {std::nullopt};
+}
+
 bool file_system::remove(std::string_view path) {
 	auto full_path = _resolve_path(path, open_flags::OUTPUT);
 
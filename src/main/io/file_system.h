@@ -5,6 +5,7 @@
 
 #include <array>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <ranges>
 #include <string>
@@ -43,6 +44,9 @@ struct OpenFlags {
 		TRUNCATE  = bitflag(4),
 		BINARY    = bitflag(16),
 		TEMPORARY = bitflag(17),
+		MAPPED    = bitflag(18),
+		PARALLEL  = bitflag(19),
+		INDEXED   = bitflag(20),
 
 		DEFAULT     = INPUT,
 		MASK_CREATE = APPEND | TRUNCATE
@@ -72,12 +76,48 @@ stdfs::path cleanup_path(stdfs::path str);
 std::optional<stdfs::path> full_path(stdfs::path str);
 
 class file_stream;
+class job_system;
 
 class file_system {
 public:
+	struct path_cache_stats {
+		size_t hits{0};     // lookups answered by the package index
+		size_t misses{0};   // lookups of paths in none of the package directories
+		size_t rebuilds{0}; // number of times the index was built
+	};
+
+	file_system();
+	~file_system();
+	file_system(file_system &&) noexcept;
+	file_system& operator=(file_system &&) noexcept;
+
 	void set_home_dir(std::string_view dir);
 	void add_package_dir(std::string_view dir);
 
+	/**
+	 * \brief Sets the job system gz streams opened with open_flags::PARALLEL deflate on, which must outlive them.
+	 */
+	void        set_job_system(job_system *jobs) noexcept;
+	job_system* get_job_system() const noexcept;
+
+	/**
+	 * \brief Drops the package directory index, it is rebuilt on the next lookup.
+	 *
+	 * Needed after files are added to or removed from package directories behind our back, unless
+	 * watch_package_dirs() is enabled.
+	 */
+	void rescan();
+
+	/**
+	 * \brief Invalidates the package directory index automatically when the directories change.
+	 *
+	 * Only available where the OS supports it (inotify); returns false otherwise.
+	 */
+	bool watch_package_dirs(bool enable);
+
+	path_cache_stats get_path_cache_stats() const;
+	void             reset_path_cache_stats();
+
 	const stdfs::path&           get_home_dir() const noexcept;
 	std::span<const stdfs::path> get_package_dirs() const noexcept;
 
@@ -109,9 +149,25 @@ public:
 		bit_set<open_flags> mode = open_flags::DEFAULT
 	) const;
 
+	// open a path previously returned by _resolve_path; only touch the file system itself, so
+	// they can be called from any thread
+	std::unique_ptr<file_stream> _open_resolved(
+		const stdfs::path & path,
+		bit_set<open_flags> mode = open_flags::DEFAULT
+	);
+
+	std::unique_ptr<file_stream> _open_gz_resolved(
+		const stdfs::path & path,
+		bit_set<open_flags> mode = open_flags::DEFAULT
+	);
+
 private:
-	stdfs::path              _home_dir{stdfs::current_path()};
-	std::vector<stdfs::path> _package_dirs{};
+	struct package_index;
+
+	stdfs::path                    _home_dir{stdfs::current_path()};
+	std::vector<stdfs::path>       _package_dirs{};
+	std::unique_ptr<package_index> _index;
+	job_system                    *_jobs{nullptr};
 
 	bool _is_accessible(
 		const stdfs::path & path,
@@ -119,6 +175,8 @@ private:
 	) const;
 
 	bool _create_folders(const stdfs::path &path);
+
+	std::optional<stdfs::path> _find_in_packages(const stdfs::path &path) const;
 };
 } // namespace octahedron
 
@@ -1,16 +1,155 @@
 #include "gz_file_stream.h"
+#include "engine/job_system.h"
 #include "tools/math.h"
 #include <fmt/ranges.h>
 
 #include <cassert>
+#include <deque>
+#include <optional>
 
 #include <zlib.h>
 
 using namespace octahedron;
 
+namespace
+{
+struct deflated_block {
+	std::vector<Bytef> output;
+	uint32             crc{0};
+	size_t             size{0};
+	bool               ok{false};
+};
+
+/**
+ * \brief Deflates one block of a parallel gzip stream as raw deflate data.
+ *
+ * Blocks other than the last end on a sync flush, which leaves the output byte-aligned so that the
+ * next block's data can simply be appended; the last one ends the deflate stream.
+ */
+deflated_block deflate_block(
+	const std::vector<Bytef> &input,
+	const std::vector<Bytef> &dictionary,
+	int                       compression,
+	bool                      last
+) {
+	deflated_block ret{.crc = static_cast<uint32>(::crc32(0, input.data(), narrow_cast<uInt>(input.size()))), .size = input.size()};
+	z_stream       stream{};
+
+	if (deflateInit2(&stream, compression, Z_DEFLATED, -MAX_WBITS, min(MAX_MEM_LEVEL, 8), Z_DEFAULT_STRATEGY) != Z_OK)
+		return (ret);
+	if (!dictionary.empty())
+		deflateSetDictionary(&stream, dictionary.data(), narrow_cast<uInt>(dictionary.size()));
+	ret.output.resize(deflateBound(&stream, input.size()) + 16);
+	stream.next_in = const_cast<Bytef*>(input.data());
+	stream.avail_in = narrow_cast<uInt>(input.size());
+	stream.next_out = ret.output.data();
+	stream.avail_out = narrow_cast<uInt>(ret.output.size());
+
+	int flush = (last ? Z_FINISH : Z_SYNC_FLUSH);
+	int err;
+
+	do {
+		if (stream.avail_out == 0) {
+			size_t used = ret.output.size();
+
+			ret.output.resize(used * 2);
+			stream.next_out = ret.output.data() + used;
+			stream.avail_out = narrow_cast<uInt>(used);
+		}
+		err = deflate(&stream, flush);
+	} while (err == Z_OK && (last || stream.avail_out == 0));
+	if (last)
+		ret.ok = (err == Z_STREAM_END);
+	else
+		ret.ok = ((err == Z_OK || err == Z_BUF_ERROR) && stream.avail_in == 0);
+	ret.output.resize(stream.total_out);
+	deflateEnd(&stream);
+	return (ret);
+}
+} // namespace
+
+class gz_file_stream::_parallel_deflate {
+public:
+	_parallel_deflate(int compression_, job_system *jobs) :
+		compression{compression_},
+		_jobs{jobs} {
+	}
+
+	/**
+	 * \brief Queues the block being filled for compression, and starts a new one.
+	 *
+	 * Without a job system, the block is deflated right away on the calling thread.
+	 */
+	void submit(bool last) {
+		std::vector<Bytef> next_dictionary;
+		size_t             tail = min(input.size(), WINDOW_SIZE);
+
+		next_dictionary.assign(input.end() - static_cast<ptrdiff_t>(tail), input.end());
+
+		auto &pending = _results.emplace_back();
+
+		pending.block = std::make_shared<deflated_block>();
+		if (_jobs) {
+			pending.task = _jobs->submit(
+				[out = pending.block, in = std::move(input), dict = std::move(dictionary), level = compression, last]() {
+					*out = deflate_block(in, dict, level, last);
+				}
+			);
+		} else
+			*pending.block = deflate_block(input, dictionary, compression, last);
+		input.clear();
+		input.reserve(PARALLEL_BLOCK_SIZE);
+		dictionary = std::move(next_dictionary);
+	}
+
+	/**
+	 * \brief Returns the oldest block if it is done, or waits for it if `wait` is true.
+	 */
+	std::optional<deflated_block> pop(bool wait) {
+		if (_results.empty())
+			return {std::nullopt};
+
+		auto &front = _results.front();
+
+		if (front.task.valid()) {
+			if (!wait && !front.task.done())
+				return {std::nullopt};
+			_jobs->wait(front.task);
+		}
+
+		deflated_block ret = std::move(*front.block);
+
+		_results.pop_front();
+		return {std::move(ret)};
+	}
+
+	[[nodiscard]] size_t pending() const noexcept {
+		return (_results.size());
+	}
+
+	[[nodiscard]] size_t max_pending() const noexcept {
+		return ((_jobs ? _jobs->thread_count() + 1 : 1) * 2);
+	}
+
+	std::vector<Bytef> input{};
+	std::vector<Bytef> dictionary{};
+	size_t             total_in{0};
+	int                compression;
+
+private:
+	struct pending_block {
+		job                             task{};
+		std::shared_ptr<deflated_block> block{nullptr};
+	};
+
+	job_system               *_jobs;
+	std::deque<pending_block> _results;
+};
+
 std::unique_ptr<gz_file_stream> gz_file_stream::_from_raw_stream(
 	std::unique_ptr<file_stream> &&stream,
 	bit_set<open_flags>            mode,
+	job_system                    *jobs,
 	int                            compression
 ) {
 	auto ret = std::make_unique<gz_file_stream>();
@@ -24,6 +163,9 @@ std::unique_ptr<gz_file_stream> gz_file_stream::_from_raw_stream(
 			log(log_level::DEBUG, "could not start gz inflate: {}", zError(err));
 			return {nullptr};
 		}
+	} else if (mode & open_flags::OUTPUT && mode & open_flags::PARALLEL) {
+		ret->_parallel = std::make_unique<_parallel_deflate>(compression, jobs);
+		ret->_parallel->input.reserve(PARALLEL_BLOCK_SIZE);
 	} else if (mode & open_flags::OUTPUT) {
 		if (int err = deflateInit2(
 				&ret->_z_stream,
@@ -49,7 +191,13 @@ std::unique_ptr<gz_file_stream> gz_file_stream::_from_raw_stream(
 }
 
 gz_file_stream::~gz_file_stream() {
-	if (_mode & open_flags::OUTPUT) {
+	if (_mode & open_flags::OUTPUT && _parallel) {
+		if (!_submit_block(true) || !_drain(true))
+			log(log_level::ERROR, "error while saving gz file");
+		if (!_raw_stream->put<endianness::little>(_crc) ||
+				!_raw_stream->put<endianness::little>(static_cast<uint32>(_parallel->total_in)))
+			log(log_level::DEBUG, "could not write gz trailer");
+	} else if (_mode & open_flags::OUTPUT) {
 		int err = Z_OK;
 
 		while (err == Z_OK) {
@@ -60,7 +208,7 @@ gz_file_stream::~gz_file_stream() {
 		if (err != Z_STREAM_END)
 			log(log_level::ERROR, "error while saving gz file: {}", zError(err));
 		if (!_raw_stream->put<endianness::little>(_crc) ||
-				!_raw_stream->put<endianness::little>(_z_stream.total_in))
+				!_raw_stream->put<endianness::little>(static_cast<uint32>(_z_stream.total_in)))
 			log(log_level::DEBUG, "could not write gz trailer");
 	}
 }
@@ -78,12 +226,13 @@ size_t gz_file_stream::_fetch(size_t size) {
 }
 
 size_t gz_file_stream::read(std::span<std::byte> buf) {
-	const auto data = reinterpret_cast<Bytef*>(buf.data());
-	uint32     read_size;
-
 	if (!(_mode & open_flags::INPUT) || buf.empty())
 		return (0);
-	_z_stream.next_out = data;
+
+	// with an index, stop at every deflate block boundary so that checkpoints can be taken there
+	int flush = (_mode & open_flags::INDEXED ? Z_BLOCK : Z_NO_FLUSH);
+
+	_z_stream.next_out = reinterpret_cast<Bytef*>(buf.data());
 	_z_stream.avail_out = narrow_cast<uint32>(buf.size());
 	while (_z_stream.avail_out > 0) {
 		if (!_z_stream.avail_in) {
@@ -92,21 +241,65 @@ size_t gz_file_stream::read(std::span<std::byte> buf) {
 				break;
 			}
 		}
-		int err = inflate(&_z_stream, Z_NO_FLUSH);
+
+		Bytef *out = _z_stream.next_out;
+		int    err = inflate(&_z_stream, flush);
+		auto   produced = narrow_cast<uint32>(_z_stream.next_out - out);
+
+		_crc = ::crc32(_crc, out, produced);
+		if (_mode & open_flags::INDEXED)
+			_update_index({reinterpret_cast<std::byte*>(out), produced});
 		if (err != Z_OK) {
-			if (err == Z_STREAM_END) {
-				read_size = narrow_cast<uint32>(buf.size() - _z_stream.avail_out);
-				_crc = ::crc32(_crc, data, read_size);
+			if (err == Z_STREAM_END)
 				_at_eof();
-				return (read_size);
-			}
-			_end_read();
+			else
+				_end_read();
 			break;
 		}
 	}
-	read_size = narrow_cast<uint32>(buf.size() - _z_stream.avail_out);
-	_crc = ::crc32(_crc, data, read_size);
-	return (read_size);
+	return (buf.size() - _z_stream.avail_out);
+}
+
+void gz_file_stream::_remember(std::span<const std::byte> output) {
+	if (!_window)
+		_window = std::make_unique<window>();
+	if (output.size() >= WINDOW_SIZE) {
+		memcpy(_window->data(), output.data() + output.size() - WINDOW_SIZE, WINDOW_SIZE);
+		_window_pos = 0;
+	} else {
+		size_t first = min(output.size(), WINDOW_SIZE - _window_pos);
+
+		memcpy(_window->data() + _window_pos, output.data(), first);
+		memcpy(_window->data(), output.data() + first, output.size() - first);
+		_window_pos = (_window_pos + output.size()) % WINDOW_SIZE;
+	}
+}
+
+void gz_file_stream::_update_index(std::span<const std::byte> output) {
+	// keep the last 32 KiB of output around, it is the dictionary of the next checkpoint
+	_remember(output);
+
+	// only at the end of a deflate block which is not the last one
+	if (!(_z_stream.data_type & 128) || (_z_stream.data_type & 64))
+		return;
+
+	size_t last = (_index.empty() ? 0 : _index.back().out);
+
+	if (_z_stream.total_out < last + INDEX_SPAN)
+		return;
+
+	size_t      window_size = min(static_cast<size_t>(_z_stream.total_out), WINDOW_SIZE);
+	size_t      start = (_window_pos + WINDOW_SIZE - window_size) % WINDOW_SIZE;
+	size_t      first = min(window_size, WINDOW_SIZE - start);
+	checkpoint &point = _index.emplace_back();
+
+	point.out = _z_stream.total_out;
+	point.in = _raw_stream->tell() - _z_stream.avail_in;
+	point.bits = _z_stream.data_type & 7;
+	point.crc = _crc;
+	point.window.resize(window_size);
+	memcpy(point.window.data(), _window->data() + start, first);
+	memcpy(point.window.data() + first, _window->data(), window_size - first);
 }
 
 size_t gz_file_stream::_read_raw(std::span<std::byte> buf) {
@@ -129,7 +322,7 @@ void gz_file_stream::_at_eof() {
 		return;
 	constexpr bit_set<log_level> level = log_level::WARN | log_level::DEBUG;
 
-	if (_z_stream.avail_in || _fetch()) {
+	if (!_z_stream.avail_in && !_fetch()) {
 		log(level, "failed to fetch trailer bytes of gzip file");
 		return;
 	}
@@ -183,7 +376,16 @@ bool gz_file_stream::_write_header() {
 		uint8                 operating_system{3}; // Unix
 	};
 
-	if (_raw_stream->put(header{}) != sizeof(header)) {
+	header h{};
+
+	// written field by field, the struct itself is padded
+	if (!_raw_stream->put_all<endianness::little>(
+				h.magic,
+				h.file_flags,
+				h.timestamp,
+				h.comp_flags,
+				h.operating_system
+			)) {
 		log(log_level::DEBUG, "failed to write gz header");
 		return (false);
 	}
@@ -238,6 +440,8 @@ size_t gz_file_stream::write(std::span<const std::byte> buf) {
 
 	if (buf.empty())
 		return (0);
+	if (_parallel)
+		return (_write_parallel(buf));
 
 	auto data = reinterpret_cast<const Bytef*>(buf.data());
 
@@ -255,12 +459,52 @@ size_t gz_file_stream::write(std::span<const std::byte> buf) {
 		}
 	}
 	_crc = ::crc32(_crc, data, buf.size() - _z_stream.avail_in);
-	return size_t();
+	return (buf.size() - _z_stream.avail_in);
+}
+
+size_t gz_file_stream::_write_parallel(std::span<const std::byte> buf) {
+	auto   data = reinterpret_cast<const Bytef*>(buf.data());
+	size_t left = buf.size();
+
+	while (left > 0) {
+		size_t to_copy = min(left, PARALLEL_BLOCK_SIZE - _parallel->input.size());
+
+		_parallel->input.insert(_parallel->input.end(), data, data + to_copy);
+		_parallel->total_in += to_copy;
+		data += to_copy;
+		left -= to_copy;
+		if (_parallel->input.size() == PARALLEL_BLOCK_SIZE && !_submit_block(false)) {
+			log(log_level::DEBUG, "failed to write parallel gz block");
+			break;
+		}
+	}
+	return (buf.size() - left);
+}
+
+bool gz_file_stream::_submit_block(bool last) {
+	_parallel->submit(last);
+	return (_drain(false));
+}
+
+bool gz_file_stream::_drain(bool wait_all) {
+	// blocks are written in order; only wait when asked to, or to bound the memory in flight
+	while (auto block = _parallel->pop(wait_all || _parallel->pending() > _parallel->max_pending())) {
+		if (!block->ok) {
+			log(log_level::DEBUG, "failed to deflate {} bytes for gz file", block->size);
+			return (false);
+		}
+		if (_raw_stream->write(block->output.data(), block->output.size()) != block->output.size())
+			return (false);
+		_crc = ::crc32_combine(_crc, block->crc, static_cast<z_off_t>(block->size));
+	}
+	return (true);
 }
 
 size_t gz_file_stream::tell() const {
 	if (_mode & open_flags::INPUT)
 		return (_z_stream.total_out);
+	if (_mode & open_flags::OUTPUT && _parallel)
+		return (_parallel->total_in);
 	if (_mode & open_flags::OUTPUT)
 		return (_z_stream.total_in);
 	return (error_size);
@@ -274,71 +518,284 @@ size_t gz_file_stream::size_raw() const {
 	return (_raw_stream->size());
 }
 
+size_t gz_file_stream::size() {
+	if (_mode & open_flags::OUTPUT)
+		return (tell());
+	if (!(_mode & open_flags::INPUT))
+		return (error_size);
+	if (_size != error_size)
+		return (_size);
+
+	// ISIZE, the last 4 bytes of the file, holds the uncompressed size modulo 2^32
+	size_t raw_pos = _raw_stream->tell();
+	uint32 isize;
+
+	if (raw_pos == error_size || !_raw_stream->seek(-4, SEEK_END) || !_raw_stream->get<endianness::little>(isize)) {
+		_raw_stream->seek(raw_pos, SEEK_SET);
+		return (error_size);
+	}
+	if (!_raw_stream->seek(raw_pos, SEEK_SET)) {
+		log(log_level::DEBUG, "failed to seek back after reading the gzip trailer");
+		return (error_size);
+	}
+
+	// the size is the first one matching ISIZE past what is known to inflate, which is only certain when the rest
+	// of the raw stream is too small to inflate to 4 GiB or more
+	size_t known_out = _z_stream.total_out;
+	size_t known_in = raw_pos - _z_stream.avail_in;
+
+	if (!_index.empty() && _index.back().out > known_out) {
+		known_out = _index.back().out;
+		known_in = _index.back().in;
+	}
+	if (size_t raw_size = size_raw(); raw_size - min(known_in, raw_size) >= (uint64{1} << 32) / MAX_DEFLATE_RATIO)
+		return (error_size);
+	_size = known_out + static_cast<uint32>(isize - static_cast<uint32>(known_out));
+	return (_size);
+}
+
+size_t gz_file_stream::compute_size() {
+	if (size_t ret = size(); ret != error_size || !(_mode & open_flags::INPUT))
+		return (ret);
+
+	size_t                      pos = tell();
+	std::array<std::byte, 4096> buffer;
+
+	if (!_index.empty() && _index.back().out > _z_stream.total_out && !_restore(_index.back()))
+		return (error_size);
+	while (read(buffer) == buffer.size());
+	if (!(_mode & open_flags::INPUT))
+		return (error_size);
+
+	size_t end = _z_stream.total_out;
+
+	if (!seek(pos, SEEK_SET)) {
+		log(log_level::DEBUG, "failed to seek back to {} after inflating the whole gzip stream", pos);
+		return (error_size);
+	}
+	_size = end;
+	return (_size);
+}
+
 bool gz_file_stream::seek(ssize_t pos, int whence) {
-	if (!(_mode & (open_flags::INPUT | open_flags::OUTPUT)))
+	if (_mode & open_flags::OUTPUT) // only as a no-op
+		return (whence == SEEK_SET ? pos >= 0 && to_unsigned(pos) == tell() : pos == 0);
+	if (!(_mode & open_flags::INPUT))
 		return (false);
 
-	constexpr auto seek_end = [](gz_file_stream *me, ssize_t pos) {
-		if (pos > 0)
-			pos = 0;
+	size_t target_pos;
 
-		size_t                     my_pos = me->tell();
-		size_t                     to_skip = me->size() - abs(pos);
-		std::array<std::byte, 512> buffer;
+	switch (whence) {
+		case SEEK_SET:
+			target_pos = (pos < 0 ? 0 : to_unsigned(pos));
+			break;
 
-		while (to_skip > 0) {
-			size_t to_read = min(to_skip, 512u);
+		case SEEK_CUR:
+			if (pos < 0 && to_unsigned(-pos) > _z_stream.total_out)
+				target_pos = 0;
+			else
+				target_pos = _z_stream.total_out + pos;
+			break;
 
-			if (me->read({buffer.data(), to_read}) != to_read) {
-				log(log_level::DEBUG, "error while skipping bytes for gz seek_end");
-				me->_end_read();
+		case SEEK_END: {
+			// reaching the end takes inflating up to it anyway
+			size_t end = compute_size();
+
+			if (end == error_size)
 				return (false);
-			}
-			to_skip -= to_read;
+			if (pos >= 0)
+				target_pos = end;
+			else
+				target_pos = (to_unsigned(-pos) > end ? 0 : end + pos);
+			break;
 		}
+
+		default:
+			return (false);
+	}
+
+	if (target_pos == _z_stream.total_out)
 		return (true);
-	};
 
-	if (whence == SEEK_END)
-		return (seek_end(this, pos));
+	// closest checkpoint before the target, if it saves re-inflating anything
+	auto it = std::ranges::upper_bound(_index, target_pos, std::less{}, &checkpoint::out);
 
-	size_t target_pos;
+	if (it != _index.begin() && (target_pos < _z_stream.total_out || std::prev(it)->out > _z_stream.total_out)) {
+		if (!_restore(*std::prev(it)))
+			return (false);
+	} else if (target_pos < _z_stream.total_out && !_rewind())
+		return (false);
 
-	if (whence == SEEK_CUR) {
-		if (pos < 0 && (-pos) > _z_stream.total_out)
-			target_pos = 0;
-		else
-			target_pos = _z_stream.total_out + pos;
-	} else /* whence == SEEK_SET */
-		target_pos = (pos < 0 ? 0 : to_unsigned(pos));
+	std::array<std::byte, 4096> buffer;
 
-	if (target_pos == _z_stream.total_out)
-		return (true);
+	while (_z_stream.total_out < target_pos) {
+		size_t to_read = min(target_pos - _z_stream.total_out, buffer.size());
 
-	std::array<std::byte, 512> buffer;
+		if (read({buffer.data(), to_read}) != to_read) {
+			log(log_level::DEBUG, "error while skipping bytes for gz seek");
+			return (false);
+		}
+	}
+	return (true);
+}
 
-	if (target_pos < _z_stream.total_out) {
-		_z_stream.avail_in = 0;
-		_z_stream.next_in = nullptr;
-		inflateReset(&_z_stream);
-		_crc = ::crc32(0, nullptr, 0);
+bool gz_file_stream::_rewind() {
+	_z_stream.avail_in = 0;
+	_z_stream.next_in = nullptr;
+	if (inflateReset(&_z_stream) != Z_OK)
+		return (false);
+	_window_pos = 0;
+	_crc = ::crc32(0, nullptr, 0);
+	return (_raw_stream->seek(_header_size, SEEK_SET));
+}
+
+bool gz_file_stream::_restore(const checkpoint &p) {
+	_z_stream.avail_in = 0;
+	_z_stream.next_in = nullptr;
+	if (inflateReset(&_z_stream) != Z_OK)
+		return (false);
+	if (!_raw_stream->seek(p.in - (p.bits ? 1 : 0), SEEK_SET))
+		return (false);
+	if (p.bits) {
+		if (!_fetch())
+			return (false);
+
+		int byte = *_z_stream.next_in;
+
+		++_z_stream.next_in;
+		--_z_stream.avail_in;
+		inflatePrime(&_z_stream, p.bits, byte >> (8 - p.bits));
 	}
-	size_t to_skip = target_pos - _z_stream.total_out;
-	size_t to_read = min(to_skip, buffer.size());
+	inflateSetDictionary(&_z_stream, p.window.data(), narrow_cast<uInt>(p.window.size()));
+	_z_stream.total_out = p.out;
+	_crc = p.crc;
+	_window_pos = 0;
+	_remember({reinterpret_cast<const std::byte*>(p.window.data()), p.window.size()});
+	return (true);
+}
 
-	if (read({buffer.data(), to_read}) != to_read) {
-		log(log_level::DEBUG, "error while skipping bytes for gz seek");
-		_end_read();
+bool gz_file_stream::build_index() {
+	if (!(_mode & open_flags::INPUT))
 		return (false);
+
+	size_t                      pos = tell();
+	bool                        indexed = _mode & open_flags::INDEXED;
+	std::array<std::byte, 4096> buffer;
+
+	// checkpoints need the output history, which is only kept while indexing
+	if (!indexed || (!_index.empty() && _index.back().out > _z_stream.total_out)) {
+		if (!(_index.empty() ? _rewind() : _restore(_index.back())))
+			return (false);
+	}
+	_mode |= open_flags::INDEXED;
+	while (read(buffer) == buffer.size());
+	if (!indexed)
+		_mode &= ~open_flags::INDEXED;
+	return ((_mode & open_flags::INPUT) && seek(pos, SEEK_SET));
+}
+
+bool gz_file_stream::save_index(io_stream &out) const {
+	io_result ret = out.put_all<endianness::little>(
+		INDEX_MAGIC,
+		INDEX_VERSION,
+		static_cast<uint64>(size_raw()),
+		static_cast<uint64>(_index.size())
+	);
+
+	for (const checkpoint &p : _index) {
+		ret += out.put_all<endianness::little>(
+			static_cast<uint64>(p.out),
+			static_cast<uint64>(p.in),
+			static_cast<uint8>(p.bits),
+			p.crc,
+			static_cast<uint32>(p.window.size())
+		);
+		ret += out.put(p.window);
 	}
+	return (ret);
+}
+
+bool gz_file_stream::load_index(io_stream &in) {
+	uint32 magic;
+	uint32 version;
+	uint64 raw_size;
+	uint64 count;
+
+	if (!in.getAll<endianness::little>(magic, version, raw_size, count) || magic != INDEX_MAGIC ||
+			version != INDEX_VERSION) {
+		log(log_level::DEBUG, "bad gz index header");
+		return (false);
+	}
+	if (raw_size != size_raw()) {
+		log(log_level::DEBUG, "gz index is for a different file: size {}, expected {}", raw_size, size_raw());
+		return (false);
+	}
+
+	// each checkpoint takes at least this much of the sidecar, on top of its window
+	constexpr size_t record_size = 2 * sizeof(uint64) + sizeof(uint8) + 2 * sizeof(uint32);
+
+	if (auto *seekable = dynamic_cast<seekable_stream*>(&in)) {
+		size_t size = seekable->size();
+		size_t pos = seekable->tell();
+
+		if (size != error_size && pos != error_size && (pos > size || count > (size - pos) / record_size)) {
+			log(log_level::DEBUG, "gz index claims {} checkpoints, more than it can hold", count);
+			return (false);
+		}
+	}
+
+	// grown as checkpoints are read, so that a count the stream could not be checked against costs nothing
+	std::vector<checkpoint> index;
+
+	for (uint64 i = 0; i < count; ++i) {
+		checkpoint &p = index.emplace_back();
+		uint64      out;
+		uint64      in_;
+		uint8       bits;
+		uint32      window_size;
+
+		if (!in.getAll<endianness::little>(out, in_, bits, p.crc, window_size) || window_size > WINDOW_SIZE ||
+				bits > 7) {
+			log(log_level::DEBUG, "truncated gz index");
+			return (false);
+		}
+		p.window.resize(window_size);
+		if (in.read(p.window.data(), window_size) != window_size) {
+			log(log_level::DEBUG, "truncated gz index");
+			return (false);
+		}
+		// seeks binary search the checkpoints, and restore them from the raw stream
+		if ((index.size() > 1 && out <= index[index.size() - 2].out) || in_ > size_raw() ||
+				in_ < _header_size + (bits ? 1 : 0)) {
+			log(log_level::DEBUG, "bad gz index checkpoint {}: offset {} from raw offset {}", i, out, in_);
+			return (false);
+		}
+		p.out = out;
+		p.in = in_;
+		p.bits = bits;
+	}
+	_index = std::move(index);
 	return (true);
 }
 
-uint32 gz_file_stream::crc32() const noexcept {
+uint32 gz_file_stream::crc32() {
+	if (_parallel) {
+		auto &input = _parallel->input;
+
+		_drain(true);
+		return (::crc32(_crc, input.data(), narrow_cast<uInt>(input.size())));
+	}
 	return (_crc);
 }
 
 bool gz_file_stream::flush(bool full) {
+	if (_parallel) {
+		if (!_parallel->input.empty() && !_submit_block(false))
+			return (false);
+		if (!_drain(true))
+			return (false);
+		return (!full || _raw_stream->flush());
+	}
 	if (full)
 		deflate(&_z_stream, Z_SYNC_FLUSH);
 	if (_z_stream.next_out && _z_stream.avail_out < BUFFER_SIZE) {
@@ -364,6 +821,12 @@ bool gz_file_stream::eof() {
 int gz_file_stream::_end_write() {
 	octa_assert(_mode & open_flags::OUTPUT);
 
+	if (_parallel) {
+		_parallel.reset();
+		_mode &= ~open_flags::OUTPUT;
+		return (Z_OK);
+	}
+
 	if (int ret = deflateEnd(&_z_stream); ret != Z_OK) {
 		if (ret == Z_DATA_ERROR)
 			_mode &= ~open_flags::OUTPUT;
@@ -1,6 +1,8 @@
 #ifndef OCTAHEDRON_GZFILESTREAM_H_
 #define OCTAHEDRON_GZFILESTREAM_H_
 
+#include <vector>
+
 #include <zlib.h>
 
 #include "file_stream.h"
@@ -10,6 +12,20 @@
 namespace octahedron
 {
 
+class job_system;
+
+/**
+ * \brief Gzip stream over a file_stream.
+ *
+ * When opened for output with open_flags::PARALLEL, input is cut into blocks that are deflated as
+ * jobs of the file_system's job system and written in order, pigz-style. Each block is primed with the tail of the
+ * previous one and ends on a sync flush, so the output is still a single gzip member. Without a
+ * job system, the blocks are deflated on the writing thread.
+ *
+ * When opened for input with open_flags::INDEXED, inflate checkpoints are recorded every
+ * INDEX_SPAN bytes of output as the file is read, zran-style, and seeks restart from the closest
+ * one instead of from the start of the file. The index can be saved to and loaded from a sidecar.
+ */
 class gz_file_stream : public file_stream {
 public:
 	~gz_file_stream() override;
@@ -18,18 +34,40 @@ public:
 	size_t               write(std::span<const std::byte> buf) override;
 	[[nodiscard]] size_t tell() const override;
 	bool                 seek(ssize_t pos, int whence) override;
+	/**
+	 * \brief Uncompressed size of the stream, or error_size if it cannot be known without inflating.
+	 *
+	 * For input, it is read from the gzip trailer, which only holds it modulo 4 GiB. This is only enough when the
+	 * part of the file not inflated or indexed yet is too small to hold 4 GiB or more of data, see compute_size().
+	 */
+	size_t               size() override;
 	bool                 flush() override;
 	bool                 eof() override;
-	[[nodiscard]] uint32 crc32() const noexcept;
+	[[nodiscard]] uint32 crc32() override;
+
+	/**
+	 * \brief Uncompressed size of the stream, inflating the rest of it to count it when size() cannot tell.
+	 *
+	 * That costs as much as reading the whole file, the result is kept. SEEK_END uses it.
+	 */
+	size_t compute_size();
 
 	[[nodiscard]] size_t tell_raw() const;
 	[[nodiscard]] size_t size_raw() const;
 
 	bool flush(bool full);
 
+	/**
+	 * \brief Reads the rest of the file to complete the seek index, then seeks back.
+	 */
+	bool build_index();
+
+	bool save_index(io_stream &out) const;
+	bool load_index(io_stream &in);
+
 private:
-	friend std::unique_ptr<file_stream> file_system::open_gz(
-		std::string_view    path,
+	friend std::unique_ptr<file_stream> file_system::_open_gz_resolved(
+		const stdfs::path & path,
 		bit_set<open_flags> mode
 	);
 
@@ -53,9 +91,29 @@ private:
 	static constexpr size_t BUFFER_SIZE = 16384;
 	using buffer = std::array<Bytef, BUFFER_SIZE>;
 
+	static constexpr size_t PARALLEL_BLOCK_SIZE = 131072;
+	static constexpr size_t WINDOW_SIZE = 32768;
+	static constexpr size_t INDEX_SPAN = 1048576;
+	static constexpr uint32 INDEX_MAGIC = 0x58495a47; // "GZIX"
+	static constexpr uint32 INDEX_VERSION = 1;
+	static constexpr size_t MAX_DEFLATE_RATIO = 1032; // most a deflate stream can expand
+
+	using window = std::array<Bytef, WINDOW_SIZE>;
+
+	struct checkpoint {
+		size_t             out{0};  // offset in the uncompressed data
+		size_t             in{0};   // offset in the raw stream of the first full byte of the next block
+		int                bits{0}; // bits of the previous byte belonging to the next block
+		uint32             crc{0};  // crc32 of the uncompressed data up to `out`
+		std::vector<Bytef> window{};
+	};
+
+	class _parallel_deflate;
+
 	static std::unique_ptr<gz_file_stream> _from_raw_stream(
 		std::unique_ptr<file_stream> &&stream,
 		bit_set<open_flags>            mode,
+		job_system                    *jobs = nullptr,
 		int                            compression = 9
 	);
 
@@ -67,6 +125,13 @@ private:
 	void   _skip_raw(size_t size);
 	bool   _write_header();
 	bool   _read_header();
+	size_t _write_parallel(std::span<const std::byte> buf);
+	bool   _submit_block(bool last);
+	bool   _drain(bool wait_all);
+	void   _remember(std::span<const std::byte> output);
+	void   _update_index(std::span<const std::byte> output);
+	bool   _rewind();
+	bool   _restore(const checkpoint &p);
 
 	template <typename T> requires(std::is_scalar_v<T>)
 	bool _read_raw(T &value) {
@@ -81,6 +146,13 @@ private:
 	bit_set<open_flags>          _mode{0};
 	uint32                       _crc{0};
 	size_t                       _header_size{0};
+	size_t                       _size{error_size};
+
+	std::unique_ptr<_parallel_deflate> _parallel{nullptr};
+
+	std::vector<checkpoint> _index{};
+	std::unique_ptr<window> _window{nullptr};
+	size_t                  _window_pos{0};
 };
 
 }
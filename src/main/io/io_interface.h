@@ -1,11 +1,15 @@
 #ifndef OCTAHEDRON_IO_INTERFACE_H_
 #define OCTAHEDRON_IO_INTERFACE_H_
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <span>
 
 #include <boost/pfr.hpp>
 
 #include "base.h"
+#include "byteswap.h"
 
 namespace octahedron
 {
@@ -111,6 +115,22 @@ template <endianness Endian = endianness::swapped>
 		return (swap(value, std::make_index_sequence<sizeof(T)>()));
 }
 
+template <endianness Endian = endianness::swapped>
+[[nodiscard]] constexpr auto byteswap(auto value) noexcept requires(
+	std::is_floating_point_v<decltype(value)> &&
+	requires { typename integer_s<sizeof(value)>::type; }
+) {
+	using T = decltype(value);
+	using bits = std::make_unsigned_t<integer<sizeof(T)>>;
+
+	return (std::bit_cast<T>(byteswap<Endian>(std::bit_cast<bits>(value))));
+}
+
+/**
+ * \brief Size of the stack buffer ranges are converted through when written in a non-native byte order.
+ */
+inline constexpr size_t byteswap_block_size = 4096;
+
 template <typename T>
 concept writeable = requires(T &t, std::span<const std::byte> data) {
 	{
@@ -128,53 +148,101 @@ concept readable = requires(T &t, std::span<std::byte> data) {
 template <typename T>
 struct io_helper;
 
-/*template <typename T>
-struct pfr_helper;
-
 template <typename T>
-requires(std::is_scalar_v<T>)
-struct pfr_helper<T>
-{
-		constexpr static inline bool valid = true;
+concept has_io_helper = requires { sizeof(io_helper<T>); };
+
+/**
+ * \brief Compile-time layout of a type serialized by reflection through boost::pfr.
+ *
+ * `valid` is whether every field can be serialized, `packed_size` the size of the fields once packed together
+ * (0 when unknown), and `bytes_only` whether every field is a single byte, making the type independent of endianness.
+ * Scalars, arrays of valid types, types with an io_helper and aggregates of valid fields are valid.
+ */
+template <typename T>
+struct pfr_helper {
+	static constexpr bool   valid = false;
+	static constexpr size_t packed_size = 0;
+	static constexpr bool   bytes_only = false;
 };
 
-template <typename T>
-struct pfr_helper
-{
-		template <size_t... Ns>
-		consteval static bool is_pfr_valid_fun(std::index_sequence<Ns...>)
-		{
-			constexpr auto impl = []<size_t N>() consteval -> bool
-			{
-				if constexpr (requires { std::declval<boost::pfr::tuple_element_t<N, T>>(); })
-				{
-					using type = boost::pfr::tuple_element_t<N, T>;
-
-					return (pfr_helper<type>::valid);
-				}
-				else
-					return (false);
-			};
+template <typename T> requires(std::is_scalar_v<T> && !std::is_pointer_v<T>)
+struct pfr_helper<T> {
+	static constexpr bool   valid = true;
+	static constexpr size_t packed_size = sizeof(T);
+	static constexpr bool   bytes_only = (sizeof(T) == 1);
+};
 
-			return (impl.template operator()<Ns>() && ...);
-		}
+template <typename T, size_t N>
+struct pfr_helper<T[N]> {
+	static constexpr bool   valid = pfr_helper<T>::valid;
+	static constexpr size_t packed_size = N * pfr_helper<T>::packed_size;
+	static constexpr bool   bytes_only = pfr_helper<T>::bytes_only;
+};
 
-		consteval static bool is_pfr_valid_fun()
-		{
-			if constexpr (requires {
-											{
-												boost::pfr::tuple_size_v<T>
-											} -> std::convertible_to<size_t>;
-										})
-			{
-				return (is_pfr_valid_fun(std::make_index_sequence<boost::pfr::tuple_size_v<T>>()));
-			}
-			else
-				return (false);
-		}
+template <typename T, size_t N>
+struct pfr_helper<std::array<T, N>> : pfr_helper<T[N]> {};
+
+template <typename T> requires(has_io_helper<T>)
+struct pfr_helper<T> {
+	static constexpr bool   valid = true;
+	static constexpr size_t packed_size = 0;
+	static constexpr bool   bytes_only = false;
+};
 
-		constexpr static inline bool valid = is_pfr_valid_fun();
-};*/
+template <typename T> requires(
+	std::is_aggregate_v<T> &&
+	!std::is_array_v<T> &&
+	!std::ranges::range<T> &&
+	!has_io_helper<T>)
+struct pfr_helper<T> {
+private:
+	static constexpr size_t num_fields = boost::pfr::tuple_size_v<T>;
+
+	template <size_t... Ns>
+	static consteval bool _valid(std::index_sequence<Ns...>) {
+		return ((pfr_helper<boost::pfr::tuple_element_t<Ns, T>>::valid && ...));
+	}
+
+	template <size_t... Ns>
+	static consteval size_t _packed_size(std::index_sequence<Ns...>) {
+		if constexpr (((pfr_helper<boost::pfr::tuple_element_t<Ns, T>>::packed_size > 0) && ...))
+			return ((size_t{0} + ... + pfr_helper<boost::pfr::tuple_element_t<Ns, T>>::packed_size));
+		else
+			return (0);
+	}
+
+	template <size_t... Ns>
+	static consteval bool _bytes_only(std::index_sequence<Ns...>) {
+		return ((pfr_helper<boost::pfr::tuple_element_t<Ns, T>>::bytes_only && ...));
+	}
+
+public:
+	static constexpr bool   valid = (num_fields > 0) && _valid(std::make_index_sequence<num_fields>());
+	static constexpr size_t packed_size = _packed_size(std::make_index_sequence<num_fields>());
+	static constexpr bool   bytes_only = _bytes_only(std::make_index_sequence<num_fields>());
+};
+
+template <typename T>
+constexpr inline bool is_pfr_valid = pfr_helper<T>::valid;
+
+/**
+ * \brief Whether the bytes of a T in memory are exactly its serialized form in byte order Endian, so it can be read or written with a single memcpy.
+ *
+ * T must be trivially copyable with no padding, and either be serialized in the native byte order or only hold single bytes.
+ * Padding is ruled out either by std::has_unique_object_representations, which does not need to reflect T (and so accepts
+ * C array fields, which boost::pfr cannot), or by the packed size of its fields being its size.
+ */
+template <typename T, endianness Endian>
+constexpr inline bool is_memcpy_serializable = [] {
+	if constexpr (!std::is_trivially_copyable_v<T> || std::is_pointer_v<T> || has_io_helper<T>)
+		return (false);
+	else if constexpr (Endian != endianness::native)
+		return (pfr_helper<T>::valid && pfr_helper<T>::bytes_only && pfr_helper<T>::packed_size == sizeof(T));
+	else if constexpr (std::has_unique_object_representations_v<T>)
+		return (true);
+	else
+		return (pfr_helper<T>::valid && pfr_helper<T>::packed_size == sizeof(T));
+}();
 
 struct io_result {
 	constexpr operator bool() const {
@@ -195,17 +263,6 @@ constexpr io_result operator+(io_result a, io_result b) noexcept {
 	return {a.value + b.value, a.expected_size + b.expected_size};
 }
 
-/* template <typename T>
-constexpr bool is_pfr_valid =
-	(std::is_aggregate_v<T> || std::is_scalar_v<T>) && pfr_helper<T>::valid;
-
-constexpr auto teststest = is_pfr_valid<test>;
-
-using tyestt = boost::pfr::tuple_element_t<0, test>;
-
-static_assert(pfr_helper<test>::is_pfr_valid_fun(std::make_index_sequence<boost::pfr::tuple_size_v<test>>()) == true);
-static_assert(is_pfr_valid<invalid> == false);*/
-
 template <typename T>
 struct io_write_interface {
 	io_write_interface() {
@@ -251,11 +308,32 @@ struct io_write_interface {
 			size_t           size = std::size(values) * value_size;
 
 			return {static_cast<T*>(this)->write({data, size}), size};
+		} else if constexpr (is_contiguous_data<U>) {
+			// swap a block at a time into a staging buffer, the source range is const
+			constexpr size_t                                value_size = sizeof(value_type);
+			constexpr size_t                                block_count = byteswap_block_size / value_size;
+			std::array<std::byte, block_count * value_size> block;
+			const value_type                               *data = std::ranges::data(values);
+			size_t                                          count = std::ranges::size(values);
+			io_result                                       total{0, 0};
+
+			for (size_t i = 0; i < count; i += block_count) {
+				size_t n = std::min(block_count, count - i);
+
+				byteswap_values(block.data(), data + i, n, value_size);
+
+				io_result written{static_cast<T*>(this)->write({block.data(), n * value_size}), n * value_size};
+
+				total += written;
+				if (!written)
+					return (total);
+			}
+			return (total);
 		} else {
 			io_result total{0, 0};
 
 			for (auto v : values) {
-				io_result inserted = put(values);
+				io_result inserted = put<value_type, Endian>(v);
 
 				total += inserted;
 				if (!inserted)
@@ -281,16 +359,18 @@ struct io_write_interface {
 	template <typename U, endianness Endian = {}> requires(
 		!std::is_scalar_v<std::remove_reference_t<U>> &&
 		!std::ranges::range<std::remove_cvref_t<U>>)
-	io_result                             put(const U &value) {
+	io_result put(const U &value) {
 		if constexpr (requires(io_helper<U> t) { t.put(this, std::as_const(value)); }) {
 			return (io_helper<U>().put(this, value));
+		} else if constexpr (is_memcpy_serializable<U, Endian>) {
+			auto data = reinterpret_cast<const std::byte*>(&value);
+
+			return {static_cast<T*>(this)->write(data, sizeof(U)), sizeof(U)};
 		}
 		// vvv IF THIS FAILS --- SPECIALIZE THIS ^^^
-		else if constexpr (std::is_scalar_v<U> || std::is_aggregate_v<U>) {
+		else if constexpr (pfr_helper<U>::valid) {
 			constexpr auto num_fields = boost::pfr::tuple_size_v<U>;
 
-			static_assert(num_fields > 0, "Cannot serialize an empty object");
-
 			constexpr auto        impl = []<size_t... Ns>(
 				io_write_interface *self,
 				const U &           v,
@@ -302,8 +382,8 @@ struct io_write_interface {
 					// const_cast here is a workaround for breaking in boost::pfr::add_cv_like
 					const auto &field = boost::pfr::get<N>(const_cast<U&>(v_));
 
-					if constexpr (is_endian_dependent<field_type>)
-						return (self->template put<Endian>(field));
+					if constexpr (requires { self->template put<field_type, Endian>(field); })
+						return (self->template put<field_type, Endian>(field));
 					else
 						return (self->put(field));
 				};
@@ -316,9 +396,9 @@ struct io_write_interface {
 			return (impl(this, value, std::make_index_sequence<num_fields>()));
 		} else {
 			static_assert(
-				std::is_scalar_v<U> || std::is_aggregate_v<U>,
-				"type must be either scalar and aggregate for implicit serialization via boost::pfr "
-				"or octahedron::IOHelper<U>().get(IOReadable*, U&) must be valid"
+				pfr_helper<U>::valid,
+				"type must be an aggregate of serializable fields for implicit serialization via boost::pfr "
+				"or octahedron::io_helper<U>().put(io_write_interface<T>*, const U&) must be valid"
 			);
 			return {};
 		}
@@ -341,14 +421,14 @@ struct io_write_interface {
 
 	template <endianness Endian, typename U> requires(
 		is_endian_dependent<std::remove_reference_t<U>> &&
-		sizeof(T) < sizeof(void*) * 4)
+		sizeof(U) <= sizeof(void*) * 4)
 	auto put(U v) {
 		return (put<U, Endian>(std::forward<U>(v)));
 	}
 
 	template <endianness Endian, typename U> requires(
 		is_endian_dependent<std::remove_reference_t<U>> &&
-		sizeof(T) > sizeof(void*) * 4)
+		sizeof(U) > sizeof(void*) * 4)
 	auto put(const U &v) {
 		return (put<const U&, Endian>(v));
 	}
@@ -379,8 +459,8 @@ template <typename T>
 struct io_read_interface {
 	template <typename U, endianness Endian = {}> requires(std::is_enum_v<U>)
 	io_result get(U &value) {
-		std::underlying_type_t v;
-		io_result              ret = get<Endian>(v);
+		std::underlying_type_t<U> v;
+		io_result                 ret = get<std::underlying_type_t<U>, Endian>(v);
 
 		value = static_cast<std::remove_reference_t<decltype(value)>>(v);
 		return (ret);
@@ -419,13 +499,15 @@ struct io_read_interface {
 
 		if constexpr (requires(io_helper<type> t) { t.get(this, value); }) {
 			return (io_helper<type>().get(this, value));
+		} else if constexpr (is_memcpy_serializable<type, Endian>) {
+			auto data = reinterpret_cast<std::byte*>(&value);
+
+			return {static_cast<T*>(this)->read(data, sizeof(type)), sizeof(type)};
 		}
 		// vvv IF THIS FAILS --- SPECIALIZE THIS ^^^
-		else if constexpr (std::is_scalar_v<type> || std::is_aggregate_v<type>) {
+		else if constexpr (pfr_helper<type>::valid) {
 			constexpr auto num_fields = boost::pfr::tuple_size_v<type>;
 
-			static_assert(num_fields > 0, "Cannot serialize an empty object");
-
 			constexpr auto impl =
 				[]<size_t... Ns>(
 				io_read_interface *self,
@@ -440,8 +522,8 @@ struct io_read_interface {
 
 					auto &field = boost::pfr::get<N>(v_);
 
-					if constexpr (is_endian_dependent<field_type>)
-						return (self->template get<Endian>(field));
+					if constexpr (requires { self->template get<field_type, Endian>(field); })
+						return (self->template get<field_type, Endian>(field));
 					else
 						return (self->get(field));
 				};
@@ -453,9 +535,9 @@ struct io_read_interface {
 			return (impl(this, value, std::make_index_sequence<num_fields>()));
 		} else {
 			static_assert(
-				std::is_scalar_v<type> || std::is_aggregate_v<type>,
-				"type must be either scalar and aggregate for implicit serialization via boost::pfr "
-				"or octahedron::IOHelper<U>().put(IOReadable*, const U&) must be valid"
+				pfr_helper<type>::valid,
+				"type must be an aggregate of serializable fields for implicit serialization via boost::pfr "
+				"or octahedron::io_helper<U>().get(io_read_interface<T>*, U&) must be valid"
 			);
 			return {};
 		}
@@ -473,11 +555,19 @@ struct io_read_interface {
 			size_t size = std::size(values) * value_size;
 
 			return {static_cast<T*>(this)->read(data, size), size};
+		} else if constexpr (is_contiguous_data<decltype(values)>) {
+			// read everything, then swap the complete values in place
+			auto   data = std::ranges::data(values);
+			size_t size = std::size(values) * value_size;
+			size_t read = static_cast<T*>(this)->read(reinterpret_cast<std::byte*>(data), size);
+
+			byteswap_values(data, data, read / value_size, value_size);
+			return {read, size};
 		} else {
 			io_result total{0, 0};
 
 			for (auto &v : values) {
-				io_result inserted = get<Endian>(v);
+				io_result inserted = get<value_type, Endian>(v);
 
 				total += inserted;
 				if (!inserted)
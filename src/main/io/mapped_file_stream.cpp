@@ -0,0 +1,189 @@
+#include "mapped_file_stream.h"
+
+#include "../tools/math.h"
+
+#include <fmt/std.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+using namespace octahedron;
+
+std::unique_ptr<mapped_file_stream> mapped_file_stream::_open(
+	const stdfs::path & path,
+	bit_set<open_flags> mode
+) {
+	if (mode & (open_flags::OUTPUT | open_flags::APPEND | open_flags::TRUNCATE)) {
+		log(log_level::DEBUG, "cannot open a mapped stream for writing: {}", path);
+		return (nullptr);
+	}
+
+	std::unique_ptr<mapped_file_stream> ret{new mapped_file_stream{}};
+
+	#ifdef _WIN32
+	HANDLE file = CreateFileW(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr
+	);
+	if (file == INVALID_HANDLE_VALUE)
+		return (nullptr);
+	ret->_file_handle = file;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size))
+		return (nullptr);
+	if (file_size.QuadPart == 0) // empty files cannot be mapped, but are valid streams
+		return (ret);
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		log(log_level::DEBUG, "could not create file mapping for {}", path);
+		return (nullptr);
+	}
+	ret->_mapping_handle = mapping;
+
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		log(log_level::DEBUG, "could not map view of file {}", path);
+		return (nullptr);
+	}
+	ret->_data = {static_cast<const std::byte*>(data), static_cast<size_t>(file_size.QuadPart)};
+	#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return (nullptr);
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return (nullptr);
+	}
+	if (st.st_size == 0) { // empty files cannot be mapped, but are valid streams
+		::close(fd);
+		return (ret);
+	}
+
+	void *data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // the mapping keeps its own reference to the file
+	if (data == MAP_FAILED) {
+		log(log_level::DEBUG, "could not map file {}", path);
+		return (nullptr);
+	}
+	::madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+	ret->_data = {static_cast<const std::byte*>(data), static_cast<size_t>(st.st_size)};
+	#endif
+	return (ret);
+}
+
+mapped_file_stream::~mapped_file_stream() {
+	_unmap();
+}
+
+void mapped_file_stream::_unmap() noexcept {
+	#ifdef _WIN32
+	if (!_data.empty())
+		UnmapViewOfFile(_data.data());
+	if (_mapping_handle)
+		CloseHandle(_mapping_handle);
+	if (_file_handle)
+		CloseHandle(_file_handle);
+	_mapping_handle = nullptr;
+	_file_handle = nullptr;
+	#else
+	if (!_data.empty())
+		::munmap(const_cast<std::byte*>(_data.data()), _data.size());
+	#endif
+	_data = {};
+	_pos = 0;
+}
+
+bool mapped_file_stream::flush() {
+	return (true);
+}
+
+bool mapped_file_stream::eof() {
+	return (_pos >= _data.size());
+}
+
+size_t mapped_file_stream::tell() const {
+	return (_pos);
+}
+
+bool mapped_file_stream::seek(ssize_t pos, int whence) {
+	ssize_t base;
+
+	switch (whence) {
+		case SEEK_SET:
+			base = 0;
+			break;
+
+		case SEEK_CUR:
+			base = static_cast<ssize_t>(_pos);
+			break;
+
+		case SEEK_END:
+			base = static_cast<ssize_t>(_data.size());
+			break;
+
+		default:
+			return (false);
+	}
+	if (pos < -base)
+		return (false);
+	// like fseek, seeking past the end is allowed; reads will simply return 0
+	_pos = static_cast<size_t>(base + pos);
+	return (true);
+}
+
+size_t mapped_file_stream::size() {
+	return (_data.size());
+}
+
+size_t mapped_file_stream::read(std::span<std::byte> buf) {
+	if (_pos >= _data.size())
+		return (0);
+
+	size_t to_read = min(buf.size(), _data.size() - _pos);
+
+	std::memcpy(buf.data(), _data.data() + _pos, to_read);
+	_pos += to_read;
+	return (to_read);
+}
+
+size_t mapped_file_stream::write(std::span<const std::byte>) {
+	return (error_size);
+}
+
+std::optional<std::string> mapped_file_stream::get_next_line(size_t max_size) {
+	if (_pos >= _data.size())
+		return {std::nullopt};
+
+	auto   begin = reinterpret_cast<const char*>(_data.data() + _pos);
+	size_t to_scan = min(max_size, _data.size() - _pos);
+	auto   newline = static_cast<const char*>(std::memchr(begin, '\n', to_scan));
+	size_t length = (newline ? static_cast<size_t>(newline - begin) + 1 : to_scan);
+
+	_pos += length;
+	return {std::string{begin, length}};
+}
+
+auto mapped_file_stream::view() const noexcept -> std::span<const std::byte> {
+	return (_data);
+}
+
+auto mapped_file_stream::remaining() const noexcept -> std::span<const std::byte> {
+	if (_pos >= _data.size())
+		return {};
+	return (_data.subspan(_pos));
+}
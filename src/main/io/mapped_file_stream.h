@@ -0,0 +1,73 @@
+#ifndef OCTAHEDRON_MAPPEDFILESTREAM_H_
+#define OCTAHEDRON_MAPPEDFILESTREAM_H_
+
+#include <span>
+
+#include "file_stream.h"
+#include "../base.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief Read-only file stream serving reads directly from a memory mapping of the file.
+ *
+ * Opened through file_system::open with open_flags::MAPPED. Small reads are a bounds check and a
+ * memcpy, without going through libc; view() gives zero-copy access to the whole file.
+ */
+class mapped_file_stream final : public file_stream {
+public:
+	using io_stream::read;
+	using io_stream::write;
+
+	~mapped_file_stream() override;
+	mapped_file_stream(const mapped_file_stream &) = delete;
+
+	bool                 flush() override;
+	bool                 eof() override;
+	[[nodiscard]] size_t tell() const override;
+	bool                 seek(ssize_t pos, int whence) override;
+	size_t               size() override;
+
+	size_t read(std::span<std::byte> buf) override;
+	size_t write(std::span<const std::byte> buf) override;
+
+	std::optional<std::string> get_next_line(size_t max_size) override;
+
+	/**
+	 * \brief Returns a view of the whole mapped file. Valid for the lifetime of the stream.
+	 */
+	[[nodiscard]] std::span<const std::byte> view() const noexcept;
+
+	/**
+	 * \brief Returns a view of the mapped file from the current position to the end.
+	 */
+	[[nodiscard]] std::span<const std::byte> remaining() const noexcept;
+
+protected:
+	mapped_file_stream() = default;
+
+private:
+	friend std::unique_ptr<file_stream> file_system::_open_resolved(
+		const stdfs::path & path,
+		bit_set<open_flags> mode
+	);
+
+	static std::unique_ptr<mapped_file_stream> _open(
+		const stdfs::path & path,
+		bit_set<open_flags> mode
+	);
+
+	void _unmap() noexcept;
+
+	std::span<const std::byte> _data{};
+	size_t                     _pos{0};
+	#ifdef _WIN32
+	void *_file_handle{nullptr};
+	void *_mapping_handle{nullptr};
+	#endif
+};
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_MAPPEDFILESTREAM_H_ */
@@ -33,7 +33,7 @@ std::unique_ptr<raw_file_stream> raw_file_stream::_open(
 }
 
 bool raw_file_stream::flush() {
-	return (fflush(_file) != 0);
+	return (fflush(_file) == 0);
 }
 
 bool raw_file_stream::eof() {
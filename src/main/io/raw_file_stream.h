@@ -87,8 +87,13 @@ protected:
 	raw_file_stream(raw_file_stream &&) = default;
 
 private:
-	friend std::unique_ptr<file_stream> file_system::open(
-		std::string_view    path,
+	friend std::unique_ptr<file_stream> file_system::_open_resolved(
+		const stdfs::path & path,
+		bit_set<open_flags> mode
+	);
+
+	friend std::unique_ptr<file_stream> file_system::_open_gz_resolved(
+		const stdfs::path & path,
 		bit_set<open_flags> mode
 	);
 
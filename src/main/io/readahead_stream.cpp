@@ -0,0 +1,232 @@
+#include "readahead_stream.h"
+
+#include <cstring>
+
+#include <zlib.h>
+
+#include "../tools/math.h"
+
+using namespace octahedron;
+
+namespace
+{
+
+/**
+ * \brief Pushes a value to a ring whose capacity is never exceeded, then wakes up the other side.
+ */
+template <typename T, size_t Capacity>
+void push_notify(spsc_ring<T, Capacity> &ring, T value, std::atomic<uint32> &events) {
+	ring.push_back(std::move(value));
+	events.fetch_add(1);
+	events.notify_one();
+}
+
+/**
+ * \brief Pops a value from a ring, waiting for the other side to push one, or for a stop request.
+ */
+template <typename T, size_t Capacity>
+std::optional<T> pop_wait(spsc_ring<T, Capacity> &ring, std::atomic<uint32> &events, const std::stop_token &stop = {}) {
+	while (true) {
+		// loaded before checking, so that a push or a stop in between makes the wait return at once
+		uint32 seen = events.load();
+
+		if (stop.stop_requested())
+			return (std::nullopt);
+		if (auto value = ring.pop_front())
+			return (value);
+		events.wait(seen);
+	}
+}
+
+}
+
+readahead_stream::readahead_stream(std::unique_ptr<file_stream> stream, size_t block_size) :
+	_stream{std::move(stream)},
+	_block_size{max(block_size, size_t{1})} {
+	for (auto &buffer : _buffers)
+		buffer = std::make_unique_for_overwrite<std::byte[]>(_block_size);
+	_reset();
+}
+
+readahead_stream::~readahead_stream() {
+	_stop();
+}
+
+void readahead_stream::_reset() {
+	while (_filled.pop_front())
+		;
+	while (_free.pop_front())
+		;
+	for (auto &buffer : _buffers)
+		_free.push_back(buffer.get());
+	_produced_end = false;
+	_held = nullptr;
+	_data = nullptr;
+	_pos = 0;
+	_end = 0;
+	_at_end = false;
+	_offset = _stream->tell();
+	_crc = _stream->crc32();
+}
+
+void readahead_stream::_launch() {
+	// a producer that reached the end is not joined until the next seek, so this does not start it again
+	if (_thread.joinable() || _produced_end)
+		return;
+	_thread = std::jthread{[this](std::stop_token stop) { _produce(stop); }};
+}
+
+void readahead_stream::_stop() {
+	if (_thread.joinable()) {
+		_thread.request_stop();
+		_free_events.fetch_add(1);
+		_free_events.notify_all();
+		_thread.join();
+	}
+}
+
+void readahead_stream::_produce(std::stop_token stop) {
+	while (auto data = pop_wait(_free, _free_events, stop)) {
+		size_t read = _stream->read({*data, _block_size});
+
+		if (read == error_size)
+			read = 0;
+		if (read == 0)
+			_produced_end = true;
+		push_notify(_filled, block{*data, read}, _filled_events);
+		if (read == 0)
+			return;
+	}
+}
+
+bool readahead_stream::_next_block() {
+	if (_at_end)
+		return (false);
+	if (_held) {
+		push_notify(_free, _held, _free_events);
+		_held = nullptr;
+	}
+	_launch();
+
+	block b = *pop_wait(_filled, _filled_events);
+
+	// the end marker is never released, _reset() gives all the buffers back
+	if (b.size == 0) {
+		_at_end = true;
+		_pos = 0;
+		_end = 0;
+		return (false);
+	}
+	_held = b.data;
+	_data = b.data;
+	_pos = 0;
+	_end = b.size;
+	return (true);
+}
+
+size_t readahead_stream::read(std::span<std::byte> buf) {
+	size_t total = 0;
+
+	while (total < buf.size()) {
+		if (_pos >= _end && !_next_block())
+			break;
+
+		size_t to_copy = min(buf.size() - total, _end - _pos);
+
+		std::memcpy(buf.data() + total, _data + _pos, to_copy);
+		_pos += to_copy;
+		total += to_copy;
+	}
+	_crc = ::crc32(_crc, reinterpret_cast<const Bytef*>(buf.data()), narrow_cast<uInt>(total));
+	_offset += total;
+	return (total);
+}
+
+bool readahead_stream::_skip(size_t count) {
+	while (count > 0) {
+		if (_pos >= _end && !_next_block())
+			return (false);
+
+		size_t to_skip = min(count, _end - _pos);
+
+		_crc = ::crc32(_crc, reinterpret_cast<const Bytef*>(_data + _pos), narrow_cast<uInt>(to_skip));
+		_pos += to_skip;
+		_offset += to_skip;
+		count -= to_skip;
+	}
+	return (true);
+}
+
+size_t readahead_stream::write(std::span<const std::byte>) {
+	return (error_size);
+}
+
+bool readahead_stream::flush() {
+	return (true);
+}
+
+bool readahead_stream::eof() {
+	return (_pos >= _end && _at_end);
+}
+
+uint32 readahead_stream::crc32() {
+	return (_crc);
+}
+
+size_t readahead_stream::tell() const {
+	return (_offset);
+}
+
+bool readahead_stream::seek(ssize_t pos, int whence) {
+	ssize_t target;
+
+	switch (whence) {
+		case SEEK_SET:
+			target = pos;
+			break;
+
+		case SEEK_CUR:
+			target = static_cast<ssize_t>(_offset) + pos;
+			break;
+
+		case SEEK_END: {
+			size_t end = size();
+
+			if (end == error_size)
+				return (false);
+			target = static_cast<ssize_t>(end) + pos;
+			break;
+		}
+
+		default:
+			return (false);
+	}
+	if (target < 0)
+		return (false);
+
+	auto ahead = static_cast<size_t>(target) - _offset;
+
+	if (static_cast<size_t>(target) >= _offset && ahead <= BLOCK_COUNT * _block_size)
+		return (_skip(ahead));
+	_stop();
+
+	bool ret = _stream->seek(target, SEEK_SET);
+
+	_reset();
+	return (ret);
+}
+
+size_t readahead_stream::size() {
+	if (!_size_known) {
+		// the producer owns the underlying stream while it runs; the blocks it filled stay in the ring,
+		// and the next read starts it again from where it stopped
+		_stop();
+		_size = _stream->size();
+		_size_known = true;
+	}
+	return (_size);
+}
+
+auto readahead_stream::block_size() const noexcept -> size_t {
+	return (_block_size);
+}
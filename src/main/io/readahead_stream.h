@@ -0,0 +1,99 @@
+#ifndef OCTAHEDRON_READAHEADSTREAM_H_
+#define OCTAHEDRON_READAHEADSTREAM_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <thread>
+
+#include "file_stream.h"
+#include "../base.h"
+#include "../tools/concurrent_ring.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief File stream decorator reading another stream ahead of its consumer, on a thread of its own.
+ *
+ * The producer thread fills fixed-size blocks from the underlying stream while the consumer reads the blocks
+ * already filled, so decompressing a gz_file_stream overlaps with parsing its contents. Blocks go back and forth
+ * between the two through a pair of spsc_ring. The producer starts on the first read, and the size of the
+ * underlying stream is only asked for when size() is called, so constructing the stream reads nothing.
+ * The underlying stream must not be used directly while this stream exists.
+ *
+ * crc32() is computed over the bytes handed out by this stream, starting from the underlying stream's
+ * own crc32() when reading started, so that it does not depend on how far ahead the producer is.
+ * Forward seeks within reach of the read-ahead skip data; other seeks stop the producer, seek the
+ * underlying stream and start again from there. Writing is not supported.
+ */
+class readahead_stream final : public file_stream {
+public:
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 65536;
+	static constexpr size_t BLOCK_COUNT = 8;
+
+	using file_stream::read;
+	using file_stream::write;
+
+	explicit readahead_stream(
+		std::unique_ptr<file_stream> stream,
+		size_t                       block_size = DEFAULT_BLOCK_SIZE
+	);
+	~readahead_stream() override;
+	readahead_stream(const readahead_stream &) = delete;
+
+	bool                 flush() override;
+	bool                 eof() override;
+	uint32               crc32() override;
+	[[nodiscard]] size_t tell() const override;
+	bool                 seek(ssize_t pos, int whence) override;
+	size_t               size() override;
+
+	size_t read(std::span<std::byte> buf) override;
+	size_t write(std::span<const std::byte> buf) override;
+
+	/**
+	 * \brief Returns the size of a block of the read-ahead ring.
+	 */
+	[[nodiscard]] size_t block_size() const noexcept;
+
+private:
+	struct block {
+		std::byte *data{nullptr};
+		size_t     size{0}; // 0 marks the end of the underlying stream
+	};
+
+	void _reset();
+	void _launch();
+	void _stop();
+	void _produce(std::stop_token stop);
+	bool _next_block();
+	bool _skip(size_t count);
+
+	std::unique_ptr<file_stream>                             _stream;
+	std::array<std::unique_ptr<std::byte[]>, BLOCK_COUNT>    _buffers;
+	size_t                                                   _block_size;
+	size_t                                                   _size{error_size};
+	bool                                                     _size_known{false};
+	// blocks filled by the producer, and blocks the consumer is done with
+	spsc_ring<block, BLOCK_COUNT>                            _filled;
+	spsc_ring<std::byte*, BLOCK_COUNT>                       _free;
+	// bumped after each push to the matching ring, to wake up the other side
+	std::atomic<uint32>                                      _filled_events{0};
+	std::atomic<uint32>                                      _free_events{0};
+	std::atomic<bool>                                        _produced_end{false};
+	// only used by the consumer
+	std::byte                                               *_held{nullptr};
+	const std::byte                                         *_data{nullptr};
+	size_t                                                   _pos{0};
+	size_t                                                   _end{0};
+	size_t                                                   _offset{0};
+	uint32                                                   _crc{0};
+	bool                                                     _at_end{false};
+	std::jthread                                             _thread;
+};
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_READAHEADSTREAM_H_ */
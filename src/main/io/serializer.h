@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <ranges>
+#include <vector>
 
 #include "tools/math.h"
 
@@ -139,7 +141,7 @@ public:
 	}
 
 	size_t bytes_available() const {
-		return (tell() - size());
+		return (size() - tell());
 	}
 
 	size_t size() const {
@@ -250,6 +252,172 @@ using dynamic_buffer = serializer<std::vector<std::byte>>;
 template <byteoid T, size_t Size>
 using static_buffer = serializer<std::array<T, Size>>;
 
+/**
+ * \brief Serializer over a list of non-contiguous buffers, read and written in order as if they were one (scatter/gather).
+ *
+ * Segments are referenced, not copied: this is meant to serialize straight into or out of buffers owned elsewhere,
+ * for example a packet header followed by a payload, without first gathering them into a contiguous one.
+ * Accesses which fit in the current segment are a single memcpy, only the ones crossing a boundary are split.
+ * Like serializer<std::span<T>>, writes stop at the end of the last segment.
+ *
+ * \tparam T Byte type of the segments, const for a read-only serializer
+ */
+template <byteoid T>
+class chained_serializer : public
+	std::conditional_t<
+		std::is_const_v<T>,
+		io_read_interface<chained_serializer<T>>,
+		io_interface<chained_serializer<T>>> {
+public:
+	using value_type = T;
+	using segment = std::span<T>;
+
+	chained_serializer() = default;
+
+	chained_serializer(std::initializer_list<segment> segments) {
+		_segments.reserve(segments.size());
+		for (segment seg : segments)
+			append(seg);
+	}
+
+	template <std::ranges::input_range R> requires(std::convertible_to<std::ranges::range_reference_t<R>, segment>)
+	explicit chained_serializer(R &&segments) {
+		for (segment seg : segments)
+			append(seg);
+	}
+
+	/**
+	 * \brief Adds a buffer after the last one. Empty buffers are ignored.
+	 */
+	void append(segment seg) {
+		if (seg.empty())
+			return;
+		_segments.push_back(seg);
+		_size += seg.size();
+	}
+
+	[[nodiscard]] std::span<const segment> segments() const noexcept {
+		return (_segments);
+	}
+
+	[[nodiscard]] size_t tell() const noexcept {
+		return (_pos);
+	}
+
+	bool seek(ssize_t pos, int whence = SEEK_SET) {
+		size_t target;
+
+		switch (whence) {
+			case SEEK_SET:
+				target = (pos > 0 ? min(static_cast<size_t>(pos), _size) : 0);
+				break;
+			case SEEK_CUR:
+				if (pos > 0)
+					target = _pos + min(static_cast<size_t>(pos), bytes_available());
+				else
+					target = _pos - min(static_cast<size_t>(-pos), _pos);
+				break;
+			case SEEK_END:
+				target = (pos < 0 ? _size - min(static_cast<size_t>(-pos), _size) : _size);
+				break;
+
+			default:
+				return (false);
+		}
+		_locate(target);
+		return (true);
+	}
+
+	[[nodiscard]] size_t bytes_available() const noexcept {
+		return (_size - _pos);
+	}
+
+	[[nodiscard]] size_t size() const noexcept {
+		return (_size);
+	}
+
+	template <byteoid U>
+	size_t write(const U *data, size_t size) requires(!std::is_const_v<T>) {
+		return (write(std::span{reinterpret_cast<const std::byte*>(data), size}));
+	}
+
+	template <byteoid U>
+	size_t read(U *data, size_t size) {
+		return (read(std::span{reinterpret_cast<std::byte*>(data), size}));
+	}
+
+	size_t read(std::span<std::byte> buf) {
+		return (_transfer(buf.size(), [out = buf.data()](T *segment_data, size_t n) mutable {
+			std::memcpy(out, segment_data, n);
+			out += n;
+		}));
+	}
+
+	size_t write(std::span<const std::byte> buf) requires(!std::is_const_v<T>) {
+		return (_transfer(buf.size(), [in = buf.data()](T *segment_data, size_t n) mutable {
+			std::memcpy(segment_data, in, n);
+			in += n;
+		}));
+	}
+
+	void reset() noexcept {
+		_segment = 0;
+		_offset = 0;
+		_pos = 0;
+	}
+
+	void clear() noexcept {
+		_segments.clear();
+		_size = 0;
+		reset();
+	}
+
+private:
+	/**
+	 * \brief Moves `size` bytes from the current position, calling `fun(pointer, n)` for each contiguous piece.
+	 * \return Number of bytes moved, less than `size` at the end of the last segment
+	 */
+	template <typename F>
+	size_t _transfer(size_t size, F &&fun) {
+		size_t remaining = min(size, bytes_available());
+		size_t done = 0;
+
+		while (remaining > 0) {
+			// the position stays at the end of a segment until more is needed, so segments can still be appended
+			if (_offset == _segments[_segment].size()) {
+				++_segment;
+				_offset = 0;
+			}
+
+			segment &seg = _segments[_segment];
+			size_t   n = min(remaining, seg.size() - _offset);
+
+			fun(seg.data() + _offset, n);
+			done += n;
+			remaining -= n;
+			_offset += n;
+		}
+		_pos += done;
+		return (done);
+	}
+
+	void _locate(size_t pos) noexcept {
+		_segment = 0;
+		_offset = pos;
+		_pos = pos;
+		while (_segment + 1 < _segments.size() && _offset >= _segments[_segment].size()) {
+			_offset -= _segments[_segment].size();
+			++_segment;
+		}
+	}
+
+	std::vector<segment> _segments;
+	size_t               _segment{0};
+	size_t               _offset{0};
+	size_t               _pos{0};
+	size_t               _size{0};
+};
+
 using ucharbuf = serializer<std::span<unsigned char>>;
 } // namespace octahedron
 
@@ -6,6 +6,8 @@
 #include "tools/math.h"
 #include "tools/ring.h"
 
+#include <cstring>
+
 #include <io/raw_file_stream.h>
 #include <tools/exception.h>
 #include <fmt/ranges.h>
@@ -35,10 +37,29 @@ class utf8_stream {
 		return (_get_stream(stream));
 	}
 
-	auto _read_buf(size_t size) {
-		if (buffer.size() < size)
-			buffer.accept(_get_stream(stream), std::min(size, BufSize - buffer.size()));
-		return (buffer.size());
+	/**
+	 * \brief Reads from the stream straight into the free space of the buffer.
+	 * \return Number of bytes added.
+	 */
+	size_t _read_buf() {
+		if (at_eof)
+			return (0);
+
+		std::span<char8> free = buffer.reserve_contiguous(BufSize - buffer.size());
+
+		if (free.empty())
+			return (0);
+
+		auto res = _get_stream().read(free.data(), free.size());
+
+		if constexpr (std::is_signed_v<decltype(res)>) {
+			if (res < 0)
+				res = 0;
+		}
+		if (res == 0)
+			at_eof = true;
+		buffer.commit(static_cast<size_t>(res));
+		return (static_cast<size_t>(res));
 	}
 
 public:
@@ -62,70 +83,34 @@ public:
 	}
 
 	size_t read_cube(char *buf, size_t size) {
-		using stream_size = decltype(std::declval<utf8_stream>()._read_buf(std::declval<size_t>()));
-		stream_size total = 0;
+		size_t total = 0;
 
 		while (total < size) {
-			if (buffer.size() < size) {
-				_read_buf(BufSize);
-			}
+			if (buffer.size() < size - total)
+				_read_buf();
+			if (buffer.empty())
+				break;
 
-			if (partial_utf8.count) {
-				if (partial_utf8.needed > partial_utf8.count) {
-					partial_utf8.count += partial_utf8.count + (buffer.read(partial_utf8.empty_bytes()));
-				}
-				auto [bytes, chr, needed] = _do_read_character(partial_utf8.available_bytes(), buf + total);
-				if (needed) { // stream ended with partial utf8, we cannot proceed
-					assert(partial_utf8.needed < partial_utf8.buf.size()); // bug
-					return (total);
-				}
-				partial_utf8.clear();
-				total += chr;
-			}
-			if (buffer.size() == 0)
-				return (total);
-			std::span<char8 const> data = buffer.data_first();
+			// characters are decoded in place, the front is made contiguous for one of up to 4 bytes
+			std::span<char8 const> data = buffer.peek_contiguous(4);
 			auto [bytes, characters, needed] = _do_read_cube(data, buf + total, size - total);
+
 			total += characters;
-			if (needed > 0) {
-				partial_utf8.count = buffer.read(partial_utf8.buf, needed);
-				partial_utf8.needed = needed;
-			}
 			buffer.discard(bytes);
-			if (total >= size)
+			// the character at the front is cut: wait for the rest, unless the stream ended in the middle of it
+			if (needed > 0 && bytes == 0 && _read_buf() == 0)
 				break;
 		}
 		return (total);
 	}
 
 protected:
-	struct carry {
-		std::array<char8, 8> buf;
-		std::size_t count = 0;
-		std::size_t needed = 0;
-
-		std::span<char8> available_bytes() {
-			return {buf.data(), count};
-		}
-
-		std::span<char8> empty_bytes() {
-			return {buf.data() + count, count - buf.size()};
-		}
-
-		void clear() {
-			count = 0;
-			needed = 0;
-		}
-	};
-
 	struct read_result {
 		size_t bytes_read;
 		size_t characters_read;
 		size_t bytes_awaited;
 	};
 
-	carry partial_utf8;
-
 	static read_result _do_read_character(std::span<char8 const> src, char *dst) {
 		char8 chr = src[0];
 		if (static_cast<uint8_t>(chr) < 0x80) {
@@ -160,8 +145,21 @@ protected:
 		while (bytes_read < src.size()) {
 			if (max == 0)
 				break;
+			// runs of ASCII are the same in both encodings, copy them whole
+			size_t ascii = ascii_prefix_size(src.subspan(bytes_read, std::min(max, src.size() - bytes_read)));
+
+			if (ascii > 0) {
+				std::memcpy(dst + characters_read, src.data() + bytes_read, ascii);
+				bytes_read += ascii;
+				characters_read += ascii;
+				max -= ascii;
+				res = {};
+				continue;
+			}
 			res = _do_read_character(src.subspan(bytes_read), dst + characters_read);
-			bytes_read += res.bytes_read + res.bytes_awaited;
+			if (res.bytes_awaited > 0)
+				break;
+			bytes_read += res.bytes_read;
 			characters_read += res.characters_read;
 			--max;
 		}
@@ -2,10 +2,12 @@
 
 #include "engine/game_engine.h"
 
+// tools using the library without an engine, like logdecode, have nowhere to log to
 bool octahedron::is_log_enabled(bit_set<log_level> level) noexcept {
-	return (g_engine->is_log_enabled(level));
+	return (g_engine && g_engine->is_log_enabled(level));
 }
 
 void octahedron::log(bit_set<log_level> level, std::string_view line) {
-	g_engine->log(level, line);
+	if (g_engine)
+		g_engine->log(level, line);
 }
@@ -0,0 +1,566 @@
+#ifndef OCTAHEDRON_CONCURRENT_RING_H_
+#define OCTAHEDRON_CONCURRENT_RING_H_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+
+#include <tools/math.h>
+
+namespace octahedron {
+
+/**
+ * \brief Size assumed for a cache line, used to keep indices written by different threads apart.
+ */
+inline constexpr size_t cache_line_size = 64;
+
+namespace detail {
+
+/**
+ * \brief Storage shared by the concurrent rings: a power-of-two array of uninitialized slots, indexed by ever-increasing positions.
+ *
+ * \tparam T Type of object stored
+ * \tparam Capacity Capacity of the buffer, must be a power of two
+ */
+template <typename T, size_t Capacity>
+requires (std::has_single_bit(Capacity))
+class concurrent_ring_storage {
+public:
+	/**
+	 * \brief Type stored in this container
+	 */
+	using value_type = T;
+
+	/**
+	 * \brief Returns the maximum capacity of the ring container as a constant expression.
+	 * \return Capacity
+	 */
+	consteval static size_t capacity() noexcept {
+		return Capacity;
+	}
+
+protected:
+	/**
+	 * \brief Whether inserting from a range moves its elements rather than copying them, same rule as basic_ring::append_range.
+	 */
+	template <typename Range>
+	inline static constexpr bool moves_from = !std::ranges::borrowed_range<Range>;
+
+	/**
+	 * \brief Returns the slot for an absolute position.
+	 */
+	T* _slot(size_t pos) noexcept {
+		return (std::launder(reinterpret_cast<T*>(_buffer.data())) + (pos & (Capacity - 1)));
+	}
+
+	/**
+	 * \brief Returns the number of contiguous slots starting at an absolute position, before the buffer wraps around.
+	 */
+	static constexpr size_t _contiguous(size_t pos) noexcept {
+		return (Capacity - (pos & (Capacity - 1)));
+	}
+
+	/**
+	 * \brief Underlying buffer. **Never** do any operation on this, use _slot().
+	 */
+	alignas(T) std::array<std::byte, sizeof(T[Capacity])> _buffer;
+};
+
+}
+
+/**
+ * \brief Wait-free single-producer, single-consumer circular buffer.
+ *
+ * One thread may insert (push_back, emplace_back, write, append_range) while another extracts (pop_front, read), without locks.
+ * Each index is only written by one side and sits on its own cache line; each side also keeps a cached copy of the other's index so that it
+ * only touches the shared line when the cached one says the ring is full (or empty). Batch operations publish all of their elements with a single store.
+ *
+ * \tparam T Type of object stored
+ * \tparam Capacity Capacity of the buffer, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class spsc_ring : public detail::concurrent_ring_storage<T, Capacity> {
+	using base = detail::concurrent_ring_storage<T, Capacity>;
+
+public:
+	using base::capacity;
+
+	constexpr spsc_ring() = default;
+	spsc_ring(const spsc_ring&) = delete;
+	spsc_ring& operator=(const spsc_ring&) = delete;
+
+	/**
+	 * \brief Destructor. Destroys any elements still left in the container; no thread may be using it.
+	 */
+	~spsc_ring() noexcept(std::is_nothrow_destructible_v<T>) {
+		size_t tail = _tail.load(std::memory_order::relaxed);
+
+		for (size_t pos = _head.load(std::memory_order::relaxed); pos != tail; ++pos)
+			std::destroy_at(this->_slot(pos));
+	}
+
+	/**
+	 * \brief Producer side. Constructs an element at the end of the container.
+	 *
+	 * \throw Any Any exceptions thrown by the construction of the element, in which case nothing is inserted.
+	 * \return Whether the element was inserted, false if the container was full.
+	 */
+	template <typename... Args>
+	bool emplace_back(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+		size_t tail = _tail.load(std::memory_order::relaxed);
+
+		if (_free(tail, 1) == 0)
+			return (false);
+		std::construct_at(this->_slot(tail), std::forward<Args>(args)...);
+		_tail.store(tail + 1, std::memory_order::release);
+		return (true);
+	}
+
+	/**
+	 * \brief Producer side. Copies a value to the end of the container.
+	 * \return Whether the element was inserted, false if the container was full.
+	 */
+	bool push_back(std::add_const_t<T>& value) noexcept(std::is_nothrow_copy_constructible_v<T>) requires (std::is_copy_constructible_v<T>) {
+		return (emplace_back(value));
+	}
+
+	/**
+	 * \brief Producer side. Moves a value to the end of the container.
+	 * \return Whether the element was inserted, false if the container was full. If false, value is left untouched.
+	 */
+	bool push_back(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) requires (std::is_move_constructible_v<T>) {
+		return (emplace_back(std::move(value)));
+	}
+
+	/**
+	 * \brief Producer side. Try append a range to the end of the container.
+	 *
+	 * \param rng Range to append to the end of the container. If the range is not a <a href="https://en.cppreference.com/w/cpp/ranges/borrowed_range>borrowed range</a> and is an rvalue, the move constructor will be used to construct elements.
+	 * \param max_count Maximum count of elements to add.
+	 * \throw Any Any exceptions thrown by the construction of elements; elements constructed before that are kept.
+	 * \return The count of elements actually added.
+	 */
+	template <typename Range>
+	requires (std::ranges::input_range<std::remove_cvref_t<Range>>)
+	size_t append_range(Range&& rng, size_t max_count = std::numeric_limits<size_t>::max()) {
+		size_t tail = _tail.load(std::memory_order::relaxed);
+		size_t total = _free(tail, max_count);
+		size_t i = 0;
+		auto   it = std::ranges::begin(rng);
+
+		try {
+			for (; i < total && it != std::ranges::end(rng); ++i, ++it) {
+				if constexpr (base::template moves_from<Range>)
+					std::construct_at(this->_slot(tail + i), std::ranges::iter_move(it));
+				else
+					std::construct_at(this->_slot(tail + i), *it);
+			}
+		} catch (...) {
+			_tail.store(tail + i, std::memory_order::release);
+			throw;
+		}
+		_tail.store(tail + i, std::memory_order::release);
+		return (i);
+	}
+
+	/**
+	 * \brief Producer side. Copies as many elements as possible from a buffer to the end of the container.
+	 * \return The count of elements actually written.
+	 */
+	size_t write(std::span<std::add_const_t<T>> buf) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			size_t tail = _tail.load(std::memory_order::relaxed);
+			size_t total = _free(tail, buf.size());
+			size_t first = min(total, this->_contiguous(tail));
+
+			std::memcpy(this->_slot(tail), buf.data(), first * sizeof(T));
+			std::memcpy(this->_slot(tail + first), buf.data() + first, (total - first) * sizeof(T));
+			_tail.store(tail + total, std::memory_order::release);
+			return (total);
+		} else {
+			return (append_range(buf));
+		}
+	}
+
+	/**
+	 * \copydoc write(std::span<std::add_const_t<T>>)
+	 */
+	size_t write(std::add_const_t<T>* buf, size_t max_write) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+		return (write({buf, max_write}));
+	}
+
+	/**
+	 * \brief Consumer side. Extracts the first element of the container.
+	 * \return The element, or nullopt if the container was empty.
+	 */
+	std::optional<T> pop_front() noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>) {
+		size_t head = _head.load(std::memory_order::relaxed);
+
+		if (_available(head, 1) == 0)
+			return (std::nullopt);
+
+		T*               elem = this->_slot(head);
+		std::optional<T> ret{std::move(*elem)};
+
+		std::destroy_at(elem);
+		_head.store(head + 1, std::memory_order::release);
+		return (ret);
+	}
+
+	/**
+	 * \brief Consumer side. Moves as many elements as possible from the start of the container into a buffer.
+	 * \return The count of elements actually read.
+	 */
+	size_t read(std::span<T> buf) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_destructible_v<T>) {
+		size_t head = _head.load(std::memory_order::relaxed);
+		size_t total = _available(head, buf.size());
+
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			size_t first = min(total, this->_contiguous(head));
+
+			std::memcpy(buf.data(), this->_slot(head), first * sizeof(T));
+			std::memcpy(buf.data() + first, this->_slot(head + first), (total - first) * sizeof(T));
+		} else {
+			for (size_t i = 0; i < total; ++i) {
+				T* elem = this->_slot(head + i);
+
+				buf[i] = std::move(*elem);
+				std::destroy_at(elem);
+			}
+		}
+		_head.store(head + total, std::memory_order::release);
+		return (total);
+	}
+
+	/**
+	 * \copydoc read(std::span<T>)
+	 */
+	size_t read(T* buf, size_t max_read) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_destructible_v<T>) {
+		return (read({buf, max_read}));
+	}
+
+	/**
+	 * \copydoc read(std::span<T>)
+	 */
+	size_t read(std::span<T> buf, size_t max_read) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_destructible_v<T>) {
+		return (read(buf.first(min(buf.size(), max_read))));
+	}
+
+	/**
+	 * \brief Returns the count of elements in the container. Only exact when called from the producer or consumer with the other one idle.
+	 */
+	size_t size() const noexcept {
+		size_t head = _head.load(std::memory_order::acquire);
+
+		return (_tail.load(std::memory_order::acquire) - head);
+	}
+
+	bool empty() const noexcept {
+		return (size() == 0);
+	}
+
+private:
+	/**
+	 * \brief Producer side. Returns how many of `wanted` elements can be inserted at `tail`, reloading the consumer's index only when needed.
+	 */
+	size_t _free(size_t tail, size_t wanted) noexcept {
+		size_t free = Capacity - (tail - _cached_head);
+
+		if (free < wanted) {
+			_cached_head = _head.load(std::memory_order::acquire);
+			free = Capacity - (tail - _cached_head);
+		}
+		return (min(free, wanted));
+	}
+
+	/**
+	 * \brief Consumer side. Returns how many of `wanted` elements can be extracted at `head`, reloading the producer's index only when needed.
+	 */
+	size_t _available(size_t head, size_t wanted) noexcept {
+		size_t available = _cached_tail - head;
+
+		if (available < wanted) {
+			_cached_tail = _tail.load(std::memory_order::acquire);
+			available = _cached_tail - head;
+		}
+		return (min(available, wanted));
+	}
+
+	/**
+	 * \brief Position of the next element to extract; written by the consumer.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> _head{0};
+
+	/**
+	 * \brief Consumer's last known value of _tail.
+	 */
+	size_t _cached_tail{0};
+
+	/**
+	 * \brief Position of the next element to insert; written by the producer.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> _tail{0};
+
+	/**
+	 * \brief Producer's last known value of _head.
+	 */
+	size_t _cached_head{0};
+};
+
+/**
+ * \brief Bounded multiple-producer, single-consumer circular buffer.
+ *
+ * Any number of threads may insert while one thread extracts. Producers reserve slots by moving the tail with a compare-exchange,
+ * construct their elements outside of it, then mark each slot with its position; the consumer stops at the first slot not yet marked,
+ * so elements come out in reservation order. A batch reserves all of its slots with a single compare-exchange.
+ *
+ * Since a reserved slot must be filled for the consumer to make progress, elements are built before the reservation
+ * and moved into it, which requires a non-throwing move constructor.
+ *
+ * \tparam T Type of object stored
+ * \tparam Capacity Capacity of the buffer, must be a power of two
+ */
+template <typename T, size_t Capacity>
+requires (std::is_nothrow_move_constructible_v<T>)
+class mpsc_ring : public detail::concurrent_ring_storage<T, Capacity> {
+	using base = detail::concurrent_ring_storage<T, Capacity>;
+
+public:
+	using base::capacity;
+
+	mpsc_ring() noexcept {
+		for (size_t i = 0; i < Capacity; ++i)
+			_sequence[i].value.store(no_slot, std::memory_order::relaxed);
+	}
+
+	mpsc_ring(const mpsc_ring&) = delete;
+	mpsc_ring& operator=(const mpsc_ring&) = delete;
+
+	/**
+	 * \brief Destructor. Destroys any elements still left in the container; no thread may be using it.
+	 */
+	~mpsc_ring() noexcept(std::is_nothrow_destructible_v<T>) {
+		size_t tail = _tail.load(std::memory_order::relaxed);
+
+		for (size_t pos = _head.load(std::memory_order::relaxed); pos != tail; ++pos)
+			std::destroy_at(this->_slot(pos));
+	}
+
+	/**
+	 * \brief Producer side. Constructs an element at the end of the container.
+	 *
+	 * \throw Any Any exceptions thrown by the construction of the element, in which case nothing is inserted.
+	 * \return Whether the element was inserted, false if the container was full.
+	 */
+	template <typename... Args>
+	bool emplace_back(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+		return (_push(T(std::forward<Args>(args)...)));
+	}
+
+	/**
+	 * \brief Producer side. Copies a value to the end of the container.
+	 * \return Whether the element was inserted, false if the container was full.
+	 */
+	bool push_back(std::add_const_t<T>& value) noexcept(std::is_nothrow_copy_constructible_v<T>) requires (std::is_copy_constructible_v<T>) {
+		return (_push(T(value)));
+	}
+
+	/**
+	 * \brief Producer side. Moves a value to the end of the container.
+	 * \return Whether the element was inserted, false if the container was full. If false, value is left untouched.
+	 */
+	bool push_back(T&& value) noexcept {
+		return (_push(std::move(value)));
+	}
+
+	/**
+	 * \brief Producer side. Try append a range to the end of the container, as one contiguous run relative to other producers.
+	 *
+	 * \param rng Range to append to the end of the container. If the range is not a <a href="https://en.cppreference.com/w/cpp/ranges/borrowed_range>borrowed range</a> and is an rvalue, the move constructor will be used to construct elements.
+	 * \param max_count Maximum count of elements to add.
+	 * \return The count of elements actually added.
+	 */
+	template <typename Range>
+	requires (std::ranges::sized_range<std::remove_cvref_t<Range>> && std::is_nothrow_constructible_v<T, std::ranges::range_reference_t<std::remove_cvref_t<Range>>>)
+	size_t append_range(Range&& rng, size_t max_count = std::numeric_limits<size_t>::max()) noexcept {
+		size_t count = min(static_cast<size_t>(std::ranges::size(rng)), max_count);
+		size_t tail = _reserve(count);
+		auto   it = std::ranges::begin(rng);
+
+		for (size_t i = 0; i < count; ++i, ++it) {
+			if constexpr (base::template moves_from<Range>)
+				std::construct_at(this->_slot(tail + i), std::ranges::iter_move(it));
+			else
+				std::construct_at(this->_slot(tail + i), *it);
+		}
+		_publish(tail, count);
+		return (count);
+	}
+
+	/**
+	 * \brief Producer side. Copies as many elements as possible from a buffer to the end of the container, as one contiguous run relative to other producers.
+	 * \return The count of elements actually written.
+	 */
+	size_t write(std::span<std::add_const_t<T>> buf) noexcept requires (std::is_nothrow_copy_constructible_v<T>) {
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			size_t total = buf.size();
+			size_t tail = _reserve(total);
+			size_t first = min(total, this->_contiguous(tail));
+
+			std::memcpy(this->_slot(tail), buf.data(), first * sizeof(T));
+			std::memcpy(this->_slot(tail + first), buf.data() + first, (total - first) * sizeof(T));
+			_publish(tail, total);
+			return (total);
+		} else {
+			return (append_range(buf));
+		}
+	}
+
+	/**
+	 * \copydoc write(std::span<std::add_const_t<T>>)
+	 */
+	size_t write(std::add_const_t<T>* buf, size_t max_write) noexcept requires (std::is_nothrow_copy_constructible_v<T>) {
+		return (write({buf, max_write}));
+	}
+
+	/**
+	 * \brief Consumer side. Extracts the first element of the container.
+	 * \return The element, or nullopt if the container was empty or its first element is still being written.
+	 */
+	std::optional<T> pop_front() noexcept(std::is_nothrow_destructible_v<T>) {
+		size_t head = _head.load(std::memory_order::relaxed);
+
+		if (!_is_ready(head))
+			return (std::nullopt);
+
+		T*               elem = this->_slot(head);
+		std::optional<T> ret{std::move(*elem)};
+
+		std::destroy_at(elem);
+		_head.store(head + 1, std::memory_order::release);
+		return (ret);
+	}
+
+	/**
+	 * \brief Consumer side. Moves elements from the start of the container into a buffer, up to its size or the first element still being written.
+	 * \return The count of elements actually read.
+	 */
+	size_t read(std::span<T> buf) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_destructible_v<T>) {
+		size_t head = _head.load(std::memory_order::relaxed);
+		size_t i = 0;
+
+		for (; i < buf.size() && _is_ready(head + i); ++i) {
+			T* elem = this->_slot(head + i);
+
+			buf[i] = std::move(*elem);
+			std::destroy_at(elem);
+		}
+		_head.store(head + i, std::memory_order::release);
+		return (i);
+	}
+
+	/**
+	 * \copydoc read(std::span<T>)
+	 */
+	size_t read(T* buf, size_t max_read) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_destructible_v<T>) {
+		return (read({buf, max_read}));
+	}
+
+	/**
+	 * \copydoc read(std::span<T>)
+	 */
+	size_t read(std::span<T> buf, size_t max_read) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_destructible_v<T>) {
+		return (read(buf.first(min(buf.size(), max_read))));
+	}
+
+	/**
+	 * \brief Returns the count of elements in the container, including those being written. Approximate while producers are running.
+	 */
+	size_t size() const noexcept {
+		size_t head = _head.load(std::memory_order::acquire);
+
+		return (_tail.load(std::memory_order::acquire) - head);
+	}
+
+	bool empty() const noexcept {
+		return (size() == 0);
+	}
+
+private:
+	/**
+	 * \brief Moves a value into a newly reserved slot.
+	 */
+	bool _push(T&& value) noexcept {
+		size_t count = 1;
+		size_t tail = _reserve(count);
+
+		if (tail == no_slot)
+			return (false);
+		std::construct_at(this->_slot(tail), std::move(value));
+		_publish(tail, 1);
+		return (true);
+	}
+
+	/**
+	 * \brief Reserves up to `count` slots, reducing `count` to what was reserved.
+	 * \return Position of the first reserved slot, or no_slot if none could be.
+	 */
+	size_t _reserve(size_t& count) noexcept {
+		size_t tail = _tail.load(std::memory_order::relaxed);
+		size_t wanted = count;
+
+		do {
+			count = min(wanted, Capacity - (tail - _head.load(std::memory_order::acquire)));
+			if (count == 0)
+				return (no_slot);
+		} while (!_tail.compare_exchange_weak(tail, tail + count, std::memory_order::relaxed));
+		return (tail);
+	}
+
+	/**
+	 * \brief Marks `count` constructed slots starting at `pos` as ready for the consumer.
+	 */
+	void _publish(size_t pos, size_t count) noexcept {
+		for (size_t i = 0; i < count; ++i)
+			_sequence[(pos + i) & (Capacity - 1)].value.store(pos + i, std::memory_order::release);
+	}
+
+	bool _is_ready(size_t pos) const noexcept {
+		return (_sequence[pos & (Capacity - 1)].value.load(std::memory_order::acquire) == pos);
+	}
+
+	/**
+	 * \brief Returned by _reserve when the ring is full, and initial value of the sequences, which no position reaches in practice.
+	 */
+	static constexpr size_t no_slot = std::numeric_limits<size_t>::max();
+
+	struct sequence {
+		std::atomic<size_t> value;
+	};
+
+	/**
+	 * \brief Position of the next element to extract; written by the consumer.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> _head{0};
+
+	/**
+	 * \brief Position of the next slot to reserve; written by the producers.
+	 */
+	alignas(cache_line_size) std::atomic<size_t> _tail{0};
+
+	/**
+	 * \brief Position last published in each slot, so that the consumer can tell a filled slot from a reserved one.
+	 */
+	alignas(cache_line_size) std::array<sequence, Capacity> _sequence;
+};
+
+}
+
+#endif /* OCTAHEDRON_CONCURRENT_RING_H_ */
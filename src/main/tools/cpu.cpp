@@ -0,0 +1,46 @@
+#include "cpu.h"
+
+#if defined(OCTAHEDRON_X86) && defined(_MSC_VER)
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+using namespace octahedron;
+
+namespace
+{
+
+cpu_features detect_cpu_features() noexcept {
+	cpu_features ret;
+
+#if defined(OCTAHEDRON_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	ret.sse2 = __builtin_cpu_supports("sse2");
+	ret.ssse3 = __builtin_cpu_supports("ssse3");
+	ret.avx2 = __builtin_cpu_supports("avx2");
+#elif defined(OCTAHEDRON_X86) && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+
+	int max_leaf = info[0];
+
+	__cpuid(info, 1);
+	ret.sse2 = (info[3] & (1 << 26)) != 0;
+	ret.ssse3 = (info[2] & (1 << 9)) != 0;
+	// the OS must save the AVX registers (OSXSAVE, then XCR0 bits 1 and 2)
+	if (max_leaf >= 7 && (info[2] & (1 << 27)) && (_xgetbv(0) & 0b110) == 0b110) {
+		__cpuidex(info, 7, 0);
+		ret.avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#endif
+	return (ret);
+}
+
+} // namespace
+
+const cpu_features &octahedron::get_cpu_features() noexcept {
+	static const cpu_features features = detect_cpu_features();
+
+	return (features);
+}
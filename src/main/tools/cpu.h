@@ -0,0 +1,42 @@
+#ifndef OCTAHEDRON_CPU_H_
+#define OCTAHEDRON_CPU_H_
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define OCTAHEDRON_X86
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define OCTAHEDRON_SSE2
+#endif
+
+/**
+ * \brief Lets a function use an instruction set extension beyond the compilation flags; callers must check cpu_features first.
+ *
+ * MSVC needs no attribute to emit any intrinsic.
+ */
+#if defined(__GNUC__)
+#  define OCTAHEDRON_TARGET(isa) [[gnu::target(isa)]]
+#else
+#  define OCTAHEDRON_TARGET(isa)
+#endif
+
+namespace octahedron
+{
+
+/**
+ * \brief Instruction set extensions usable on the running CPU and OS.
+ */
+struct cpu_features {
+	bool sse2{false};
+	bool ssse3{false};
+	bool avx2{false};
+};
+
+/**
+ * \brief Returns the features of the running CPU, detected on first call.
+ */
+const cpu_features &get_cpu_features() noexcept;
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_CPU_H_ */
@@ -0,0 +1,263 @@
+#include "random.h"
+
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#include "cpu.h"
+#include "math.h"
+
+#ifdef OCTAHEDRON_SSE2
+#  include <immintrin.h>
+#endif
+
+using namespace octahedron;
+
+namespace
+{
+constexpr uint64 jump_polynomial[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+constexpr uint64 long_jump_polynomial[] = {0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull};
+
+/**
+ * \brief Plain xoshiro256++, used to derive the lanes of a random_stream.
+ */
+struct xoshiro256 {
+	explicit xoshiro256(uint64 seed) noexcept {
+		// splitmix64, the recommended way to expand a 64-bit seed
+		for (uint64 &word : s) {
+			seed += 0x9e3779b97f4a7c15ull;
+
+			uint64 z = seed;
+
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			word = z ^ (z >> 31);
+		}
+	}
+
+	uint64 operator()() noexcept {
+		uint64 result = std::rotl(s[0] + s[3], 23) + s[0];
+		uint64 t = s[1] << 17;
+
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = std::rotl(s[3], 45);
+		return (result);
+	}
+
+	/**
+	 * \brief Advances the state as much as `2^128` (jump_polynomial) or `2^192` (long_jump_polynomial) calls would.
+	 */
+	void jump(const uint64 (&polynomial)[4]) noexcept {
+		uint64 ret[4] = {};
+
+		for (uint64 word : polynomial) {
+			for (int b = 0; b < 64; ++b) {
+				if (word & (uint64{1} << b)) {
+					for (int i = 0; i < 4; ++i)
+						ret[i] ^= s[i];
+				}
+				(*this)();
+			}
+		}
+		std::memcpy(s, ret, sizeof(s));
+	}
+
+	uint64 s[4];
+};
+
+void fill_scalar(uint64 (&state)[4][random_stream::lanes], uint64 *out, size_t blocks) noexcept {
+	constexpr size_t lanes = random_stream::lanes;
+
+	for (size_t b = 0; b < blocks; ++b) {
+		// lane-wise loops, which compilers turn into vector code when they can
+		for (size_t l = 0; l < lanes; ++l)
+			out[b * lanes + l] = std::rotl(state[0][l] + state[3][l], 23) + state[0][l];
+		for (size_t l = 0; l < lanes; ++l) {
+			uint64 t = state[1][l] << 17;
+
+			state[2][l] ^= state[0][l];
+			state[3][l] ^= state[1][l];
+			state[1][l] ^= state[2][l];
+			state[0][l] ^= state[3][l];
+			state[2][l] ^= t;
+			state[3][l] = std::rotl(state[3][l], 45);
+		}
+	}
+}
+
+#ifdef OCTAHEDRON_SSE2
+OCTAHEDRON_TARGET("avx2")
+inline __m256i rotl_avx2(__m256i x, int k) noexcept {
+	return (_mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k)));
+}
+
+OCTAHEDRON_TARGET("avx2")
+void fill_avx2(uint64 (&state)[4][random_stream::lanes], uint64 *out, size_t blocks) noexcept {
+	static_assert(random_stream::lanes == 4, "the AVX2 version runs one lane per 64-bit element");
+
+	__m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[0]));
+	__m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[1]));
+	__m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[2]));
+	__m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(state[3]));
+
+	for (size_t b = 0; b < blocks; ++b) {
+		__m256i result = _mm256_add_epi64(rotl_avx2(_mm256_add_epi64(s0, s3), 23), s0);
+		__m256i t = _mm256_slli_epi64(s1, 17);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + b * 4), result);
+		s2 = _mm256_xor_si256(s2, s0);
+		s3 = _mm256_xor_si256(s3, s1);
+		s1 = _mm256_xor_si256(s1, s2);
+		s0 = _mm256_xor_si256(s0, s3);
+		s2 = _mm256_xor_si256(s2, t);
+		s3 = rotl_avx2(s3, 45);
+	}
+	_mm256_store_si256(reinterpret_cast<__m256i*>(state[0]), s0);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(state[1]), s1);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(state[2]), s2);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(state[3]), s3);
+}
+#endif
+
+using fill_function = void (*)(uint64 (&)[4][random_stream::lanes], uint64 *, size_t) noexcept;
+
+fill_function select_fill() noexcept {
+#ifdef OCTAHEDRON_SSE2
+	if (get_cpu_features().avx2)
+		return (&fill_avx2);
+#endif
+	return (&fill_scalar);
+}
+
+std::atomic<uint64> g_seed{random_stream::default_seed};
+std::atomic<uint64> g_generation{1};
+std::atomic<uint64> g_next_stream{0};
+
+struct thread_stream {
+	uint64        generation{0};
+	random_stream stream;
+};
+
+thread_local thread_stream t_stream;
+} // namespace
+
+random_stream::random_stream(uint64 seed, uint64 stream) noexcept {
+	xoshiro256 base{seed};
+
+	for (uint64 i = 0; i < stream; ++i)
+		base.jump(long_jump_polynomial);
+	for (size_t l = 0; l < lanes; ++l) {
+		for (size_t w = 0; w < 4; ++w)
+			_state[w][l] = base.s[w];
+		base.jump(jump_polynomial);
+	}
+}
+
+void random_stream::_fill(uint64 *out, size_t blocks) noexcept {
+	static const fill_function impl = select_fill();
+
+	impl(_state, out, blocks);
+}
+
+template <typename F>
+void random_stream::_chunks(size_t count, F &&fun) noexcept {
+	constexpr size_t chunk_blocks = 64;
+
+	alignas(32) uint64 chunk[chunk_blocks * lanes];
+
+	// values left over in the current block come first, so that the sequence is the same whichever functions are called
+	while (count > 0 && _buffered > 0) {
+		uint64 value = (*this)();
+
+		fun(std::span<const uint64>{&value, 1});
+		--count;
+	}
+	while (count > 0) {
+		size_t n = octahedron::min(count, chunk_blocks * lanes);
+		size_t blocks = (n + lanes - 1) / lanes;
+
+		_fill(chunk, blocks);
+		fun(std::span<const uint64>{chunk, n});
+		count -= n;
+		// the rest of a partial block is kept for the next call
+		_buffered = blocks * lanes - n;
+		std::memcpy(_buffer.data() + lanes - _buffered, chunk + n, _buffered * sizeof(uint64));
+	}
+}
+
+void random_stream::generate(std::span<uint64> out) noexcept {
+	uint64 *it = out.data();
+
+	_chunks(out.size(), [&it](std::span<const uint64> values) {
+		std::memcpy(it, values.data(), values.size_bytes());
+		it += values.size();
+	});
+}
+
+void random_stream::generate(std::span<uint32> out) noexcept {
+	uint32 *it = out.data();
+
+	// the high half of each value, which is the better half of xoshiro256++ output
+	_chunks(out.size(), [&it](std::span<const uint64> values) {
+		for (uint64 value : values)
+			*it++ = static_cast<uint32>(value >> 32);
+	});
+}
+
+void random_stream::generate_below(std::span<uint32> out, uint32 bound) noexcept {
+	uint32 *it = out.data();
+
+	_chunks(out.size(), [&it, bound](std::span<const uint64> values) {
+		for (uint64 value : values)
+			*it++ = static_cast<uint32>((value >> 32) * bound >> 32);
+	});
+}
+
+void random_stream::generate_floats(std::span<float> out) noexcept {
+	float *it = out.data();
+
+	// 24 bits, as many as a float has in [0.5, 1), so that every result is exact
+	_chunks(out.size(), [&it](std::span<const uint64> values) {
+		for (uint64 value : values)
+			*it++ = static_cast<float>(value >> 40) * 0x1.0p-24f;
+	});
+}
+
+void random_stream::generate_unit_vectors(std::span<std::array<float, 3>> out) noexcept {
+	constexpr float two_pi = 2.0f * std::numbers::pi_v<float>;
+
+	std::array<float, 3> *it = out.data();
+
+	// z uniform in [-1, 1] and the angle around it uniform give a uniform distribution on the sphere (Archimedes)
+	_chunks(out.size(), [&it](std::span<const uint64> values) {
+		for (uint64 value : values) {
+			float z = 1.0f - static_cast<float>(value >> 40) * 0x1.0p-23f;
+			float angle = static_cast<float>(value & 0xFFFFFF) * 0x1.0p-24f * two_pi;
+			float r = std::sqrt(octahedron::max(0.0f, 1.0f - z * z));
+
+			*it++ = {r * std::cos(angle), r * std::sin(angle), z};
+		}
+	});
+}
+
+void octahedron::seed_random_streams(uint64 seed) noexcept {
+	g_seed.store(seed, std::memory_order::relaxed);
+	g_next_stream.store(0, std::memory_order::relaxed);
+	g_generation.fetch_add(1, std::memory_order::release);
+}
+
+random_stream &octahedron::thread_random() noexcept {
+	uint64 generation = g_generation.load(std::memory_order::acquire);
+
+	if (t_stream.generation != generation) {
+		t_stream.stream = random_stream{g_seed.load(std::memory_order::relaxed), g_next_stream.fetch_add(1, std::memory_order::relaxed)};
+		t_stream.generation = generation;
+	}
+	return (t_stream.stream);
+}
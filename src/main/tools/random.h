@@ -0,0 +1,117 @@
+#ifndef OCTAHEDRON_RANDOM_H_
+#define OCTAHEDRON_RANDOM_H_
+
+#include <array>
+#include <limits>
+#include <span>
+
+#include "../base.h"
+
+namespace octahedron
+{
+
+/**
+ * \brief Fast generator filling whole spans, made of 4 xoshiro256++ generators run side by side.
+ *
+ * The lanes are 2^128 values apart in the same sequence, and their state is stored lane-wise so that one step of all
+ * of them is a handful of vector instructions; an AVX2 version is used when the CPU has it. Streams of the same seed
+ * are 2^192 values apart, which makes them independent for any practical purpose.
+ *
+ * This is not a cryptographic generator. Numbers only depend on the seed, the stream and the order of calls,
+ * not on the CPU.
+ */
+class random_stream {
+public:
+	using result_type = uint64;
+
+	static constexpr size_t lanes = 4;
+	static constexpr uint64 default_seed = 0x853c49e6748fea9bull;
+
+	explicit random_stream(uint64 seed = default_seed, uint64 stream = 0) noexcept;
+
+	static constexpr result_type min() noexcept {
+		return (0);
+	}
+
+	static constexpr result_type max() noexcept {
+		return (std::numeric_limits<result_type>::max());
+	}
+
+	result_type operator()() noexcept {
+		if (_buffered == 0) {
+			_next_block(_buffer.data());
+			_buffered = lanes;
+		}
+		return (_buffer[lanes - _buffered--]);
+	}
+
+	/**
+	 * \brief Returns a number in [0, bound), with a bias of at most bound / 2^32 which is fine for gameplay.
+	 */
+	uint32 below(uint32 bound) noexcept {
+		return (static_cast<uint32>(((*this)() >> 32) * bound >> 32));
+	}
+
+	/**
+	 * \brief Returns a float in [0, 1).
+	 */
+	float uniform() noexcept {
+		return (static_cast<float>((*this)() >> 40) * 0x1.0p-24f);
+	}
+
+	void generate(std::span<uint64> out) noexcept;
+	void generate(std::span<uint32> out) noexcept;
+
+	/**
+	 * \brief Fills `out` with numbers in [0, bound), see below().
+	 */
+	void generate_below(std::span<uint32> out, uint32 bound) noexcept;
+
+	/**
+	 * \brief Fills `out` with floats in [0, 1).
+	 */
+	void generate_floats(std::span<float> out) noexcept;
+
+	/**
+	 * \brief Fills `out` with vectors uniformly distributed on the unit sphere.
+	 */
+	void generate_unit_vectors(std::span<std::array<float, 3>> out) noexcept;
+
+private:
+	/**
+	 * \brief Writes `blocks` times one value of each lane to `out`.
+	 */
+	void _fill(uint64 *out, size_t blocks) noexcept;
+
+	void _next_block(uint64 *out) noexcept {
+		_fill(out, 1);
+	}
+
+	/**
+	 * \brief Calls `fun` with spans of successive values until `count` were generated.
+	 */
+	template <typename F>
+	void _chunks(size_t count, F &&fun) noexcept;
+
+	// _state[word][lane]
+	alignas(32) uint64 _state[4][lanes];
+	// the last `_buffered` values of the block are yet to be used
+	alignas(32) std::array<uint64, lanes> _buffer{};
+	size_t _buffered{0};
+};
+
+/**
+ * \brief Seeds the streams of every thread: each thread gets a new stream of `seed` the next time it calls thread_random().
+ *
+ * Streams are numbered in the order threads ask for them, the first being given stream 0.
+ */
+void seed_random_streams(uint64 seed) noexcept;
+
+/**
+ * \brief Returns the random stream of the calling thread, which no other thread uses.
+ */
+random_stream &thread_random() noexcept;
+
+} // namespace octahedron
+
+#endif /* OCTAHEDRON_RANDOM_H_ */
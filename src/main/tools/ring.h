@@ -1,6 +1,7 @@
 #ifndef OCTAHEDRON_RING_H_
 #define OCTAHEDRON_RING_H_
 
+#include <algorithm>
 #include <utility>
 #include <cstddef>
 #include <span>
@@ -501,13 +502,13 @@ public:
 	std::span<T const> data_first() const noexcept {
 		size_t idx = _get_idx();
 		size_t sz = _get_size();
-		return {_array() + idx, idx + sz <= capacity() ? sz : idx + (capacity() - idx)};
+		return {_array() + idx, idx + sz <= capacity() ? sz : capacity() - idx};
 	}
 
 	std::span<T> data_first() noexcept {
 		size_t idx = _get_idx();
 		size_t sz = _get_size();
-		return {_array() + idx, idx + sz <= capacity() ? sz : idx + (capacity() - idx)};
+		return {_array() + idx, idx + sz <= capacity() ? sz : capacity() - idx};
 	}
 
 	std::span<T const> data_second() const noexcept {
@@ -535,8 +536,8 @@ public:
 			};
 		}
 		return {
-			_array() + idx, capacity() - idx,
-			_array(), end - capacity()
+			{_array() + idx, capacity() - idx},
+			{_array(), end - capacity()}
 		};
 	}
 
@@ -551,8 +552,8 @@ public:
 			};
 		}
 		return {
-			_array() + idx, capacity() - idx,
-			_array(), end - capacity()
+			{_array() + idx, capacity() - idx},
+			{_array(), end - capacity()}
 		};
 	}
 
@@ -1369,6 +1370,92 @@ public:
 	constexpr size_t write(view_type buf, size_t max_write) noexcept (this->template nothrow_insert<std::add_const_t<T>&>) {
 		return (this->append_range(buf.size() > max_write ? view_type{buf, max_write} : buf));
 	}
+
+	/**
+	 * \brief Returns free space following the last element as one contiguous span, to be written in place then added with commit().
+	 *
+	 * This lets a producer such as `io_stream::read` or a decompressor write straight into the buffer. When the free space
+	 * after the last element is shorter than `n`, the elements are first moved to the start of the buffer, which costs
+	 * one copy of the elements and none when the buffer is empty.
+	 *
+	 * \param n Minimum size of the span.
+	 * \return All the contiguous free space after the last element, at least `n` elements, or an empty span if less than `n` elements are free.
+	 */
+	std::span<T> reserve_contiguous(size_t n) noexcept {
+		if (this->capacity() - this->size() < n)
+			return {};
+		if (_free_after_end() < n)
+			_linearize();
+
+		size_t end = this->_get_idx() + this->size();
+
+		if (end >= this->capacity())
+			end -= this->capacity();
+		return {this->_array() + end, _free_after_end()};
+	}
+
+	/**
+	 * \brief Adds `n` elements written at the start of the span returned by the last call to reserve_contiguous().
+	 *
+	 * \warn The behavior is undefined if `n` is greater than the size of that span, or if the buffer was modified since.
+	 * \param n Number of elements to add.
+	 */
+	void commit(size_t n) noexcept {
+		assert(n <= _free_after_end());
+
+		this->_set_size(this->size() + n);
+	}
+
+	/**
+	 * \brief Returns the first elements as one contiguous span, to be used in place then consumed with discard().
+	 *
+	 * This lets a consumer such as a decoder or a parser read straight from the buffer. When the elements wrap around
+	 * the end of the buffer before `n` of them, they are first moved to the start of the buffer.
+	 *
+	 * \param n Minimum size of the span, if the container has that many elements.
+	 * \return All the contiguous elements at the front, at least `min(n, size())` of them.
+	 */
+	std::span<T> peek_contiguous(size_t n) noexcept {
+		if (this->data_first().size() < min(n, this->size()))
+			_linearize();
+		return (this->data_first());
+	}
+
+private:
+	/**
+	 * \brief Returns the number of free elements between the last element and either the first one or the end of the buffer.
+	 */
+	size_t _free_after_end() const noexcept {
+		size_t idx = this->_get_idx();
+		size_t end = idx + this->size();
+
+		if (end >= this->capacity())
+			return (idx - (end - this->capacity()));
+		return (this->capacity() - end);
+	}
+
+	/**
+	 * \brief Moves the elements to the start of the buffer, making them and the free space contiguous.
+	 */
+	void _linearize() noexcept {
+		size_t idx = this->_get_idx();
+
+		if (this->empty()) {
+			this->_set_idx(0);
+			return;
+		}
+		if (idx == 0)
+			return;
+		if (idx + this->size() <= this->capacity()) {
+			std::memmove(this->_array(), this->_array() + idx, this->size() * sizeof(T));
+		} else {
+			// [second part, free space, first part] becomes [first part, second part, free space]
+			auto *bytes = reinterpret_cast<std::byte*>(this->_array());
+
+			std::rotate(bytes, bytes + idx * sizeof(T), bytes + this->capacity() * sizeof(T));
+		}
+		this->_set_idx(0);
+	}
 };
 
 /**
@@ -917,29 +917,32 @@ void swapbuffers(bool overlay)
 VARP(menufps, 0, 60, 1000);
 VARP(maxfps, 0, 125, 1000);
 
-void limitfps(int &millis, int curmillis)
+VARFP(precisepacing, 0, 1, 1, g_engine->get_game_clock().set_pacing(precisepacing ? octahedron::pacing::PRECISE : octahedron::pacing::SLEEP));
+
+// frames are paced by the game clock, which sleeps coarsely then yields until the deadline of the frame
+void limitfps(int &millis, int)
 {
     int limit = (mainmenu || minimized) && menufps ? (maxfps ? min(maxfps, menufps) : menufps) : maxfps;
-    if(!limit) return;
-    static int fpserror = 0;
-    int delay = 1000/limit - (millis-curmillis);
-    if(delay < 0) fpserror = 0;
-    else
-    {
-        fpserror += 1000%limit;
-        if(fpserror >= limit)
-        {
-            ++delay;
-            fpserror -= limit;
-        }
-        if(delay > 0)
-        {
-            SDL_Delay(delay);
-            millis += delay;
-        }
-    }
+    octahedron::game_clock &clock = g_engine->get_game_clock();
+    if(!limit) { clock.update(); return; }
+    clock.update(octahedron::microseconds{1000000/limit});
+    millis = getclockmillis();
 }
 
+VARF(profiling, 0, 0, 1, g_engine->get_profiler().set_enabled(profiling!=0));
+ICOMMAND(profilecapture, "i", (int *on),
+{
+    if(*on) g_engine->get_profiler().start_capture();
+    else g_engine->get_profiler().stop_capture();
+});
+ICOMMAND(profiletrace, "s", (char *file), intret(g_engine->write_profile_trace(file) ? 1 : 0));
+ICOMMAND(profilestats, "", (),
+{
+    for(const auto &zone : g_engine->get_profiler().get_stats())
+        conoutf("%.*s: p50 %.3fms, p99 %.3fms, max %.3fms (%llu frames)", int(zone.name.size()), zone.name.data(),
+            zone.p50.count()/1e6, zone.p99.count()/1e6, zone.max.count()/1e6, (unsigned long long)zone.frames);
+});
+
 #ifdef WIN32
 // Force Optimus setups to use the NVIDIA GPU
 extern "C"
@@ -210,8 +210,8 @@ extern bool isvalidcube(const cube &c);
 extern ivec lu;
 extern int lusize;
 extern cube &lookupcube(const ivec &to, int tsize = 0, ivec &ro = lu, int &rsize = lusize);
-extern const cube *neighbourstack[32];
-extern int neighbourdepth;
+extern thread_local const cube *neighbourstack[32];
+extern thread_local int neighbourdepth;
 extern const cube &neighbourcube(const cube &c, int orient, const ivec &co, int size, ivec &ro = lu, int &rsize = lusize);
 extern void resetclipplanes();
 extern int getmippedtexture(const cube &p, int orient);
@@ -238,6 +238,7 @@ extern int visibleorient(const cube &c, int orient);
 extern void genfaceverts(const cube &c, int orient, ivec v[4]);
 extern int calcmergedsize(int orient, const ivec &co, int size, const vertinfo *verts, int numverts);
 extern void invalidatemerges(cube &c, const ivec &co, int size, bool msg);
+extern int parallelmerge;
 extern void calcmerges();
 extern int mergefaces(int orient, facebounds *m, int sz);
 extern void mincubeface(const cube &cu, int orient, const ivec &o, int size, const facebounds &orig, facebounds &cf, ushort nmat = MAT_AIR, ushort matmask = MATF_VOLUME);
@@ -390,12 +391,18 @@ extern void pasteundoent(int idx, const entity &ue);
 extern void pasteundoents(undoblock *u);
 
 // octaedit
+struct dirtyregion
+{
+    ivec bbmin, bbmax;
+};
+
 extern void cancelsel();
 extern void rendertexturepanel(int w, int h);
 extern void addundo(undoblock *u);
 extern void commitchanges(bool force = false);
-extern void changed(const ivec &bbmin, const ivec &bbmax, bool commit = true);
-extern void changed(const block3 &sel, bool commit = true);
+extern void discardchanges();
+extern void changed(const ivec &bbmin, const ivec &bbmax, bool commit = false);
+extern void changed(const block3 &sel, bool commit = false);
 extern void rendereditcursor();
 extern void tryedit();
 
@@ -407,12 +414,14 @@ extern void cleanupprefabs();
 extern ivec worldmin, worldmax, nogimin, nogimax;
 extern vector<tjoint> tjoints;
 extern vector<vtxarray *> varoot, valist;
+extern int parallelva;
 
 extern ushort encodenormal(const vec &n);
 extern vec decodenormal(ushort norm);
 extern void guessnormals(const vec *pos, int numverts, vec *normals);
 extern void reduceslope(ivec &n);
 extern void findtjoints();
+extern void findtjoints(const vector<dirtyregion> &regions);
 extern void octarender();
 extern void allchanged(bool load = false);
 extern void clearvas(cube *c);
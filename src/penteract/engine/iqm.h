@@ -326,7 +326,7 @@ struct iqm : skelloader<iqm>
         {
             auto f = g_engine->get_file_system().open(
               filename,
-              octahedron::open_flags::INPUT | octahedron::open_flags::BINARY
+              octahedron::open_flags::INPUT | octahedron::open_flags::BINARY | octahedron::open_flags::MAPPED
             );
             if(!f) return false;
 
@@ -81,6 +81,7 @@ int main(int argc, char **argv)
         {
             case 'u': if(homedir[0]) logoutf("Using home directory: %s", homedir); break;
             case 'g': break;
+            case 'b': break;
             case 'd': dedicated = atoi(&argv[i][2]); if(dedicated<=0) dedicated = 2; break;
             case 'w': scr_w = clamp(atoi(&argv[i][2]), SCR_MINW, SCR_MAXW); if(!findarg(argc, argv, "-h")) scr_h = -1; break;
             case 'h': scr_h = clamp(atoi(&argv[i][2]), SCR_MINH, SCR_MAXH); if(!findarg(argc, argv, "-w")) scr_w = -1; break;
@@ -220,6 +221,8 @@ int main(int argc, char **argv)
     inputgrab(grabinput = true);
     ignoremousemotion();
 
+    octahedron::profiler &prof = g_engine->get_profiler();
+
     for(;;)
     {
         static int frames = 0;
@@ -236,16 +239,33 @@ int main(int argc, char **argv)
         totalmillis = millis;
         updatetime();
 
-        checkinput();
-        UI::update();
-        menuprocess();
+        {
+            // input handlers and menus are where binds and UI scripts run
+            auto zone = prof.zone<"script">();
+            checkinput();
+            UI::update();
+            menuprocess();
+        }
         tryedit();
 
-        if(lastmillis) game::updateworld();
+        if(lastmillis)
+        {
+            auto zone = prof.zone<"physics">();
+            game::updateworld();
+        }
 
         checksleep(lastmillis);
 
-        serverslice(false, 0);
+        {
+            auto zone = prof.zone<"network">();
+            serverslice(false, 0);
+        }
+
+        {
+            // edits made this frame, local or received, are rebuilt together
+            auto zone = prof.zone<"world edit">();
+            commitchanges();
+        }
 
         if(frames) updatefpshistory(elapsedtime);
         frames++;
@@ -255,14 +275,22 @@ int main(int argc, char **argv)
         updateparticles();
         updatesounds();
 
-        if(minimized) continue;
+        if(minimized)
+        {
+            prof.end_frame();
+            continue;
+        }
 
         gl_setupframe(!mainmenu);
 
         inbetweenframes = false;
-        gl_drawframe();
+        {
+            auto zone = prof.zone<"world render">();
+            gl_drawframe();
+        }
         swapbuffers();
         renderedframe = inbetweenframes = true;
+        prof.end_frame();
     }
 
     ASSERT(0);
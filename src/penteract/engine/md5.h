@@ -164,7 +164,7 @@ struct md5 : skelloader<md5>
 
         bool loadmesh(const char *filename, float smooth)
         {
-            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT);
+            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT | octahedron::open_flags::MAPPED);
             if(!f) return false;
 
             vector<md5joint> basejoints;
@@ -274,7 +274,7 @@ struct md5 : skelloader<md5>
             skelanimspec *sa = skel->findskelanim(filename);
             if(sa) return sa;
 
-            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT);
+            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT | octahedron::open_flags::MAPPED);
             if(!f) return NULL;
 
             vector<md5hierarchy> hierarchy;
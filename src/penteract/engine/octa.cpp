@@ -17,7 +17,7 @@ static struct emptycube : cube
 } emptycube;
 
 cube *worldroot = newcubes(F_SOLID);
-int allocnodes = 0;
+std::atomic<int> allocnodes = 0;
 
 cubeext *growcubeext(cubeext *old, int maxverts)
 {
@@ -272,8 +272,9 @@ int lookupmaterial(const vec &v)
     return c->material;
 }
 
-const cube *neighbourstack[32];
-int neighbourdepth = -1;
+// per thread, so that faces can be merged on several threads at once
+thread_local const cube *neighbourstack[32];
+thread_local int neighbourdepth = -1;
 
 const cube &neighbourcube(const cube &c, int orient, const ivec &co, int size, ivec &ro, int &rsize)
 {
@@ -1760,49 +1761,52 @@ void mergepolys(int orient, const ivec &co, const ivec &n, int offset, vector<po
     addmerges(orient, co, n, offset, polys);
 }
 
-static int genmergeprogress = 0;
-
 struct cfpolys
 {
     vector<poly> polys;
 };
 
-static hashtable<cfkey, cfpolys> cpolys;
+// each thread merging faces collects them in its own table
+static thread_local hashtable<cfkey, cfpolys> cpolys;
 
-void genmerges(cube *c = worldroot, const ivec &o = ivec(0, 0, 0), int size = worldsize>>1)
+static void genmerges(cube &c, const ivec &co, int size, bool collect)
 {
-    if((genmergeprogress++&0xFFF)==0) renderprogress(float(genmergeprogress)/allocnodes, "merging faces...");
-    neighbourstack[++neighbourdepth] = c;
-    loopi(8)
+    int vis;
+    loopj(6) if((vis = visibletris(c, j, co, size)))
     {
-        ivec co(i, o, size);
-        int vis;
-        if(c[i].children) genmerges(c[i].children, co, size>>1);
-        else if(!isempty(c[i])) loopj(6) if((vis = visibletris(c[i], j, co, size)))
+        cfkey k;
+        poly p;
+        if(collect)
         {
-            cfkey k;
-            poly p;
-            if(size < 1<<maxmerge && c != worldroot)
+            if(genpoly(c, j, co, size, vis, k.n, k.offset, p))
             {
-                if(genpoly(c[i], j, co, size, vis, k.n, k.offset, p))
-                {
-                    k.orient = j;
-                    k.tex = c[i].texture[j];
-                    k.material = c[i].material&MAT_ALPHA;
-                    cpolys[k].polys.add(p);
-                    continue;
-                }
+                k.orient = j;
+                k.tex = c.texture[j];
+                k.material = c.material&MAT_ALPHA;
+                cpolys[k].polys.add(p);
+                continue;
             }
-            else if(minface && size >= 1<<minface && touchingface(c[i], j))
+        }
+        else if(minface && size >= 1<<minface && touchingface(c, j))
+        {
+            if(genpoly(c, j, co, size, vis, k.n, k.offset, p) && p.merged)
             {
-                if(genpoly(c[i], j, co, size, vis, k.n, k.offset, p) && p.merged)
-                {
-                    addmerge(c[i], j, co, k.n, k.offset, p);
-                    continue;
-                }
+                addmerge(c, j, co, k.n, k.offset, p);
+                continue;
             }
-            clearmerge(c[i], j);
         }
+        clearmerge(c, j);
+    }
+}
+
+static void genmerges(cube *c, const ivec &o, int size)
+{
+    neighbourstack[++neighbourdepth] = c;
+    loopi(8)
+    {
+        ivec co(i, o, size);
+        if(c[i].children) genmerges(c[i].children, co, size>>1);
+        else if(!isempty(c[i])) genmerges(c[i], co, size, size < 1<<maxmerge && c != worldroot);
         if((size == 1<<maxmerge || c == worldroot) && cpolys.numelems)
         {
             enumeratekt(cpolys, cfkey, key, cfpolys, val,
@@ -1815,6 +1819,56 @@ void genmerges(cube *c = worldroot, const ivec &o = ivec(0, 0, 0), int size = wo
     --neighbourdepth;
 }
 
+// the cubes of a maxmerge sized cube only merge with each other, so each of these is merged on its own
+struct mergecell
+{
+    cube *c;
+    ivec o;
+    int size;
+};
+
+static vector<mergecell> mergecells;
+
+// finds the cells, merging the faces of the bigger cubes above them along the way
+static void findmergecells(cube *c, const ivec &o, int size)
+{
+    neighbourstack[++neighbourdepth] = c;
+    loopi(8)
+    {
+        ivec co(i, o, size);
+        if(c[i].children)
+        {
+            if(size>>1 != 1<<maxmerge) { findmergecells(c[i].children, co, size>>1); continue; }
+            mergecell &m = mergecells.add();
+            m.c = c[i].children;
+            m.o = co;
+            m.size = size>>1;
+        }
+        else if(!isempty(c[i])) genmerges(c[i], co, size, false);
+    }
+    --neighbourdepth;
+}
+
+static void genmerges(const mergecell &m)
+{
+    // a thread waiting on merge jobs may run this in the middle of its own traversal, keep its stack aside
+    int olddepth = neighbourdepth;
+    const cube *oldstack[32];
+    if(olddepth >= 0) memcpy(oldstack, neighbourstack, (olddepth + 1)*sizeof(oldstack[0]));
+    // neighbourcube() needs the parents of the cell on this thread's stack
+    neighbourdepth = -1;
+    cube *c = worldroot;
+    int scale = worldscale;
+    while(c != m.c)
+    {
+        neighbourstack[++neighbourdepth] = c;
+        c = c[octastep(m.o.x, m.o.y, m.o.z, --scale)].children;
+    }
+    genmerges(m.c, m.o, m.size);
+    if(olddepth >= 0) memcpy(neighbourstack, oldstack, (olddepth + 1)*sizeof(oldstack[0]));
+    neighbourdepth = olddepth;
+}
+
 int calcmergedsize(int orient, const ivec &co, int size, const vertinfo *verts, int numverts)
 {
     ushort x1 = verts[0].x, y1 = verts[0].y, z1 = verts[0].z,
@@ -1879,9 +1933,83 @@ void invalidatemerges(cube &c, const ivec &co, int size, bool msg)
     invalidatemerges(c);
 }
 
+VARP(parallelmerge, 0, 1, 1);
+
 void calcmerges()
 {
-    genmergeprogress = 0;
-    genmerges();
+    renderprogress(0, "merging faces...");
+    if(worldsize>>1 <= 1<<maxmerge) { genmerges(worldroot, ivec(0, 0, 0), worldsize>>1); return; }
+    findmergecells(worldroot, ivec(0, 0, 0), worldsize>>1);
+    // the cells are merged in groups so that the main thread can report progress between them, as only it may render
+    int numgroups = min(mergecells.length(), 64);
+    if(parallelmerge)
+    {
+        octahedron::job_system &jobs = g_engine->get_job_system();
+        std::vector<octahedron::job> groups;
+        loopi(numgroups)
+        {
+            int first = i*mergecells.length()/numgroups, last = (i+1)*mergecells.length()/numgroups;
+            groups.push_back(jobs.submit([first, last]() { for(int j = first; j < last; j++) genmerges(mergecells[j]); }));
+        }
+        loopi(numgroups)
+        {
+            renderprogress(float(i)/numgroups, "merging faces...");
+            jobs.wait(groups[i]);
+        }
+    }
+    else loopv(mergecells)
+    {
+        if(i%max(mergecells.length()/numgroups, 1) == 0) renderprogress(float(i)/mergecells.length(), "merging faces...");
+        genmerges(mergecells[i]);
+    }
+    mergecells.setsize(0);
 }
 
+static inline void hashmergebytes(ullong &h, const void *data, int len)
+{
+    const uchar *bytes = (const uchar *)data;
+    loopi(len) h = (h ^ bytes[i]) * 0x100000001B3ULL;
+}
+
+// hashes which faces are merged and their surfaces, leaving out where the verts are stored in each cube
+static void hashmerges(ullong &h, const cube *c)
+{
+    loopi(8)
+    {
+        const cube &cu = c[i];
+        if(cu.children) { hashmerges(h, cu.children); continue; }
+        hashmergebytes(h, &cu.merged, sizeof(cu.merged));
+        if(!cu.ext) continue;
+        loopj(6)
+        {
+            const surfaceinfo &surf = cu.ext->surfaces[j];
+            hashmergebytes(h, &surf.numverts, sizeof(surf.numverts));
+            hashmergebytes(h, cu.ext->verts() + surf.verts, surf.totalverts()*sizeof(vertinfo));
+        }
+    }
+}
+
+// merges the faces of the current map serially and on the job system, and checks both give the same merges
+static void mergetiming()
+{
+    int oldparallelmerge = parallelmerge;
+    double millis[2];
+    ullong hashes[2];
+    loopi(2)
+    {
+        parallelmerge = i;
+        auto start = std::chrono::steady_clock::now();
+        calcmerges();
+        millis[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        hashes[i] = 0xCBF29CE484222325ULL;
+        hashmerges(hashes[i], worldroot);
+    }
+    parallelmerge = oldparallelmerge;
+    allchanged();
+    conoutf("merged faces: %.1fms serial, %.1fms on %d threads (%.2fx), merges %s",
+        millis[0], millis[1], int(g_engine->get_job_system().thread_count()) + 1,
+        millis[0]/max(millis[1], 1e-3), hashes[0] == hashes[1] ? "identical" : "differ");
+}
+
+COMMAND(mergetiming, "");
+
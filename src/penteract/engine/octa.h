@@ -260,7 +260,8 @@ struct undoblock // undo header, all data sits in payload
 
 extern cube *worldroot;             // the world data. only a ptr to 8 cubes (ie: like cube.children above)
 extern int wtris, wverts, vtris, vverts, glde, gbatches, rplanes;
-extern int allocnodes, allocva, selchildcount, selchildmat;
+extern std::atomic<int> allocnodes;   // atomic, map chunks are loaded on several threads
+extern int allocva, selchildcount, selchildmat;
 
 const uint F_EMPTY = 0;             // all edges in the range (0,0)
 const uint F_SOLID = 0x80808080;    // all edges in the range (0,8)
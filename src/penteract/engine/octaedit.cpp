@@ -568,6 +568,26 @@ void tryedit()
 //////////// ready changes to vertex arrays ////////////
 
 static bool haschanged = false;
+static vector<dirtyregion> dirtyregions;
+
+// folds the regions it touches into it, so that edits repeated around the same spot stay one region
+static void adddirtyregion(const ivec &bbmin, const ivec &bbmax)
+{
+    ivec rmin = bbmin, rmax = bbmax;
+    loopvrev(dirtyregions)
+    {
+        const dirtyregion &r = dirtyregions[i];
+        if(r.bbmin.x > rmax.x || r.bbmin.y > rmax.y || r.bbmin.z > rmax.z ||
+           r.bbmax.x < rmin.x || r.bbmax.y < rmin.y || r.bbmax.z < rmin.z)
+            continue;
+        rmin.min(r.bbmin);
+        rmax.max(r.bbmax);
+        dirtyregions.removeunordered(i);
+    }
+    dirtyregion &r = dirtyregions.add();
+    r.bbmin = rmin;
+    r.bbmax = rmax;
+}
 
 void readychanges(const ivec &bbmin, const ivec &bbmax, cube *c, const ivec &cor, int size)
 {
@@ -600,6 +620,16 @@ void readychanges(const ivec &bbmin, const ivec &bbmax, cube *c, const ivec &cor
     }
 }
 
+// drops the changes readied since the last commit, for when all the vas are rebuilt anyway
+void discardchanges()
+{
+    haschanged = false;
+    dirtyregions.setsize(0);
+}
+
+extern int filltjoints;
+
+// rebuilds the vas readied since the last commit, done once a frame so that several edits cost a single rebuild
 void commitchanges(bool force)
 {
     if(!force && !haschanged) return;
@@ -608,6 +638,8 @@ void commitchanges(bool force)
     int oldlen = valist.length();
     resetclipplanes();
     entitiesinoctanodes();
+    if(filltjoints) findtjoints(dirtyregions);
+    dirtyregions.setsize(0);
     inbetweenframes = false;
     octarender();
     inbetweenframes = true;
@@ -619,6 +651,7 @@ void commitchanges(bool force)
 void changed(const ivec &bbmin, const ivec &bbmax, bool commit)
 {
     readychanges(bbmin, bbmax, worldroot, ivec(0, 0, 0), worldsize/2);
+    adddirtyregion(bbmin, bbmax);
     haschanged = true;
 
     if(commit) commitchanges();
@@ -627,10 +660,7 @@ void changed(const ivec &bbmin, const ivec &bbmax, bool commit)
 void changed(const block3 &sel, bool commit)
 {
     if(sel.s.iszero()) return;
-    readychanges(ivec(sel.o).sub(1), ivec(sel.s).mul(sel.grid).add(sel.o).add(1), worldroot, ivec(0, 0, 0), worldsize/2);
-    haschanged = true;
-
-    if(commit) commitchanges();
+    changed(ivec(sel.o).sub(1), ivec(sel.s).mul(sel.grid).add(sel.o).add(1), commit);
 }
 
 //////////// copy and undo /////////////
@@ -871,7 +901,6 @@ void swapundo(undolist &a, undolist &b, int op)
         if(!u->numents) changed(*u->block(), false);
         freeundo(u);
     }
-    commitchanges();
     if(!hmapsel)
     {
         sel = l;
@@ -1168,7 +1197,6 @@ bool unpackundo(const uchar *inbuf, int inlen, int outlen)
         freeblock(b);
     }
     delete[] outbuf;
-    commitchanges();
     return true;
 }
 
@@ -1978,8 +2006,30 @@ static ushort getmaterial(cube &c)
 
 VAR(invalidcubeguard, 0, 1, 1);
 
+struct recordededit
+{
+    int type, dir, mode;
+    selinfo sel;
+};
+
+static vector<recordededit> editrecording;
+
+// records the face pushes and cube deletions, local or from other clients, for editbench to replay
+VARF(editrecord, 0, 0, 1, { if(editrecord) editrecording.setsize(0); });
+
+static void recordedit(int type, const selinfo &sel, int dir = 0, int mode = 0)
+{
+    if(!editrecord) return;
+    recordededit &e = editrecording.add();
+    e.type = type;
+    e.dir = dir;
+    e.mode = mode;
+    e.sel = sel;
+}
+
 void mpeditface(int dir, int mode, selinfo &sel, bool local)
 {
+    recordedit(EDIT_FACE, sel, dir, mode);
     if(mode==1 && (sel.cx || sel.cy || sel.cxs&1 || sel.cys&1)) mode = 0;
     int d = dimension(sel.orient);
     int dc = dimcoord(sel.orient);
@@ -2083,10 +2133,51 @@ void pushsel(int *dir)
 
 void mpdelcube(selinfo &sel, bool local)
 {
+    recordedit(EDIT_DELCUBE, sel);
     if(local) game::edittrigger(sel, EDIT_DELCUBE);
     loopselxyz(discardchildren(c, true); emptyfaces(c));
 }
 
+static inline double editpercentile(const vector<double> &sorted, double p)
+{
+    return sorted[min(int(sorted.length()*p), sorted.length()-1)];
+}
+
+// replays the recorded edits on the current map, committing them a frame's worth at a time,
+// and reports the time from each edit until its vas are rebuilt
+static void editbench(int *perframe)
+{
+    if(noedit(true) || multiplayer()) return;
+    if(editrecording.empty()) { conoutf(CON_ERROR, "no recorded edits, set editrecord 1 first"); return; }
+    int batch = max(*perframe, 1), commits = 0, oldrecord = editrecord;
+    editrecord = 0;
+    commitchanges();
+    vector<double> latencies;
+    vector<std::chrono::steady_clock::time_point> pending;
+    auto start = std::chrono::steady_clock::now();
+    loopv(editrecording)
+    {
+        const recordededit &e = editrecording[i];
+        selinfo esel = e.sel;
+        pending.add(std::chrono::steady_clock::now());
+        if(e.type == EDIT_FACE) mpeditface(e.dir, e.mode, esel, false);
+        else mpdelcube(esel, false);
+        if(pending.length() < batch && i+1 < editrecording.length()) continue;
+        commitchanges();
+        commits++;
+        auto end = std::chrono::steady_clock::now();
+        loopvj(pending) latencies.add(std::chrono::duration<double, std::milli>(end - pending[j]).count());
+        pending.setsize(0);
+    }
+    double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    editrecord = oldrecord;
+    latencies.sort();
+    conoutf("%d edits in %d commits: %.1fms total, p50 %.2fms, p99 %.2fms, max %.2fms",
+        latencies.length(), commits, total, editpercentile(latencies, 0.5), editpercentile(latencies, 0.99), latencies.last());
+}
+
+COMMAND(editbench, "i");
+
 void delcube()
 {
     if(noedit(true)) return;
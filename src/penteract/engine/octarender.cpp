@@ -267,42 +267,95 @@ struct sortval
      sortval() {}
 };
 
-struct vacollect : verthash
+struct mergedface
+{
+    uchar orient, numverts;
+    ushort mat, tex, envmap;
+    vertinfo *verts;
+    int tjoints;
+};
+
+// a face found while walking the octree, turned into vertices by whichever thread builds its va
+struct vaface
 {
+    cube *c; // NULL for a merged face
+    ivec co;
+    int size, merge;
+    uchar orient, vis;
+};
+
+// what a va is built from, gathered on the main thread while walking the octree
+struct vaplan
+{
+    vtxarray *va;
     ivec origin;
     int size;
+    vector<vaface> faces;
+    vector<mergedface> merges;
+    vector<materialsurface> matsurfs;
+    vector<octaentities *> mapmodels, decals, extdecals;
+    ivec nogimin, nogimax;
+
+    void clearplan()
+    {
+        va = NULL;
+        faces.setsize(0);
+        merges.setsize(0);
+        matsurfs.setsize(0);
+        mapmodels.setsize(0);
+        decals.setsize(0);
+        extdecals.setsize(0);
+        nogimin = ivec(INT_MAX, INT_MAX, INT_MAX);
+        nogimax = ivec(INT_MIN, INT_MIN, INT_MIN);
+    }
+
+    // moves the contents of another plan into this one, which must be clear
+    void takeplan(vaplan &p)
+    {
+        va = p.va;
+        origin = p.origin;
+        size = p.size;
+        faces.move(p.faces);
+        merges.move(p.merges);
+        matsurfs.move(p.matsurfs);
+        mapmodels.move(p.mapmodels);
+        decals.move(p.decals);
+        extdecals.move(p.extdecals);
+        nogimin = p.nogimin;
+        nogimax = p.nogimax;
+    }
+};
+
+struct vacollect : verthash, vaplan
+{
     hashtable<sortkey, sortval> indices;
     hashtable<decalkey, sortval> decalindices;
     vector<ushort> skyindices;
     vector<sortkey> texs;
     vector<decalkey> decaltexs;
     vector<grasstri> grasstris;
-    vector<materialsurface> matsurfs;
-    vector<octaentities *> mapmodels, decals, extdecals;
+    vector<int> decalents;
     int worldtris, skytris, decaltris;
     vec alphamin, alphamax;
     vec refractmin, refractmax;
     vec skymin, skymax;
-    ivec nogimin, nogimax;
+
+    vacollect() { clear(); }
 
     void clear()
     {
         clearverts();
+        clearplan();
         worldtris = skytris = decaltris = 0;
         indices.clear();
         decalindices.clear();
         skyindices.setsize(0);
-        matsurfs.setsize(0);
-        mapmodels.setsize(0);
-        decals.setsize(0);
-        extdecals.setsize(0);
         grasstris.setsize(0);
         texs.setsize(0);
         decaltexs.setsize(0);
+        decalents.setsize(0);
         alphamin = refractmin = skymin = vec(1e16f, 1e16f, 1e16f);
         alphamax = refractmax = skymax = vec(-1e16f, -1e16f, -1e16f);
-        nogimin = ivec(INT_MAX, INT_MAX, INT_MAX);
-        nogimax = ivec(INT_MIN, INT_MIN, INT_MIN);
     }
 
     void optimize()
@@ -420,25 +473,18 @@ struct vacollect : verthash
             octaentities *oe = extdecals[i];
             loopvj(oe->decals)
             {
-                extentity &e = *ents[oe->decals[j]];
-                if(e.flags&EF_RENDER) continue;
-                e.flags |= EF_RENDER;
-                DecalSlot &s = lookupdecalslot(e.attr1, true);
+                // several nodes can list the same decal, which is only generated once; entity flags can't mark it as vas are built concurrently
+                int id = oe->decals[j];
+                if(decalents.find(id) >= 0) continue;
+                decalents.add(id);
+                extentity &e = *ents[id];
+                DecalSlot &s = lookupdecalslot(e.attr1, false);
                 if(!s.shader) continue;
                 ushort envmap = s.shader->type&SHADER_ENVMAP ? (s.texmask&(1<<TEX_ENVMAP) ? EMID_CUSTOM : closestenvmap(e.o)) : EMID_NONE;
                 decalkey k(e.attr1, envmap);
                 gendecal(e, s, k);
             }
         }
-        loopv(extdecals)
-        {
-            octaentities *oe = extdecals[i];
-            loopvj(oe->decals)
-            {
-                extentity &e = *ents[oe->decals[j]];
-                if(e.flags&EF_RENDER) e.flags &= ~EF_RENDER;
-            }
-        }
         enumeratekt(decalindices, decalkey, k, sortval, t,
         {
             if(t.tris.length()) decaltexs.add(k);
@@ -448,9 +494,6 @@ struct vacollect : verthash
 
     void setupdata(vtxarray *va)
     {
-        optimize();
-        gendecals();
-
         va->verts = verts.length();
         va->tris = worldtris/3;
         va->vbuf = 0;
@@ -614,14 +657,12 @@ struct vacollect : verthash
             va->grasstris.move(grasstris);
             loadgrassshaders();
         }
-
-        if(mapmodels.length()) va->mapmodels.put(mapmodels.getbuf(), mapmodels.length());
-        if(decals.length()) va->decals.put(decals.getbuf(), decals.length());
     }
 
+    // every face generates vertices, and sky indices and grass only come with them
     bool emptyva()
     {
-        return verts.empty() && matsurfs.empty() && skyindices.empty() && grasstris.empty() && mapmodels.empty() && decals.empty();
+        return faces.empty() && matsurfs.empty() && mapmodels.empty() && decals.empty();
     }
 } vc;
 
@@ -672,7 +713,7 @@ extern const vec orientation_bitangent[8][6] =
     { vec( 0, -1,  0), vec( 0,  1,  0), vec( 1,  0,  0), vec(-1,  0,  0), vec(-1,  0,  0), vec(-1,  0,  0) },
 };
 
-void addtris(VSlot &vslot, int orient, const sortkey &key, vertex *verts, int *index, int numverts, int convex, int tj)
+void addtris(vacollect &vc, VSlot &vslot, int orient, const sortkey &key, vertex *verts, int *index, int numverts, int convex, int tj)
 {
     int &total = key.tex==DEFAULT_SKY ? vc.skytris : vc.worldtris;
     int edge = orient*(MAXFACEVERTS+1);
@@ -760,7 +801,7 @@ void addtris(VSlot &vslot, int orient, const sortkey &key, vertex *verts, int *i
     }
 }
 
-void addgrasstri(int face, vertex *verts, int numv, ushort texture, int layer)
+void addgrasstri(vacollect &vc, int face, vertex *verts, int numv, ushort texture, int layer)
 {
     grasstri &g = vc.grasstris.add();
     int i1, i2, i3, i4;
@@ -866,7 +907,7 @@ void guessnormals(const vec *pos, int numverts, vec *normals)
     normals[3] = n2;
 }
 
-void addcubeverts(VSlot &vslot, int orient, int size, vec *pos, int convex, ushort texture, vertinfo *vinfo, int numverts, int tj = -1, ushort envmap = EMID_NONE, int grassy = 0, bool alpha = false, int layer = LAYER_TOP)
+void addcubeverts(vacollect &vc, VSlot &vslot, int orient, int size, vec *pos, int convex, ushort texture, vertinfo *vinfo, int numverts, int tj = -1, ushort envmap = EMID_NONE, int grassy = 0, bool alpha = false, int layer = LAYER_TOP)
 {
     vec4 sgen, tgen;
     calctexgen(vslot, orient, sgen, tgen);
@@ -915,7 +956,7 @@ void addcubeverts(VSlot &vslot, int orient, int size, vec *pos, int convex, usho
     }
 
     sortkey key(texture, vslot.scroll.iszero() ? O_ANY : orient, layer&LAYER_BOTTOM ? layer : LAYER_TOP, envmap, alpha ? (vslot.refractscale > 0 ? ALPHA_REFRACT : (vslot.alphaback ? ALPHA_BACK : ALPHA_FRONT)) : NO_ALPHA);
-    addtris(vslot, orient, key, verts, index, numverts, convex, tj);
+    addtris(vc, vslot, orient, key, verts, index, numverts, convex, tj);
 
     if(grassy)
     {
@@ -924,11 +965,11 @@ void addcubeverts(VSlot &vslot, int orient, int size, vec *pos, int convex, usho
             int faces = 0;
             if(index[0]!=index[i+1] && index[i+1]!=index[i+2] && index[i+2]!=index[0]) faces |= 1;
             if(i+3 < numverts && index[0]!=index[i+2] && index[i+2]!=index[i+3] && index[i+3]!=index[0]) faces |= 2;
-            if(grassy > 1 && faces==3) addgrasstri(i, verts, 4, texture, layer);
+            if(grassy > 1 && faces==3) addgrasstri(vc, i, verts, 4, texture, layer);
             else
             {
-                if(faces&1) addgrasstri(i, verts, 3, texture, layer);
-                if(faces&2) addgrasstri(i+1, verts, 3, texture, layer);
+                if(faces&1) addgrasstri(vc, i, verts, 3, texture, layer);
+                if(faces&2) addgrasstri(vc, i+1, verts, 3, texture, layer);
             }
         }
     }
@@ -955,7 +996,8 @@ enum
     CE_START = 1<<0,
     CE_END   = 1<<1,
     CE_FLIP  = 1<<2,
-    CE_DUP   = 1<<3
+    CE_DUP   = 1<<3,
+    CE_FIX   = 1<<4
 };
 
 struct cubeedge
@@ -969,7 +1011,7 @@ struct cubeedge
 vector<cubeedge> cubeedges;
 hashtable<edgegroup, int> edgegroups(1<<13);
 
-void gencubeedges(cube &c, const ivec &co, int size)
+void gencubeedges(cube &c, const ivec &co, int size, bool fix = true)
 {
     ivec pos[MAXFACEVERTS];
     int vis;
@@ -1023,7 +1065,7 @@ void gencubeedges(cube &c, const ivec &co, int size)
             ce.offset = t1;
             ce.size = t2 - t1;
             ce.index = i*(MAXFACEVERTS+1)+j;
-            ce.flags = CE_START | CE_END | (e1!=j ? CE_FLIP : 0);
+            ce.flags = CE_START | CE_END | (e1!=j ? CE_FLIP : 0) | (fix ? CE_FIX : 0);
             ce.next = -1;
 
             bool insert = true;
@@ -1084,57 +1126,128 @@ void gencubeedges(cube *c = worldroot, const ivec &co = ivec(0, 0, 0), int size
     --neighbourdepth;
 }
 
-void gencubeverts(cube &c, const ivec &co, int size, int csi)
+static inline bool overlapsregions(const vector<dirtyregion> &regions, const ivec &o, int size)
 {
-    if(!(c.visible&0xC0)) return;
-
-    int vismask = ~c.merged & 0x3F;
-    if(!(c.visible&0x80)) vismask &= c.visible;
-    if(!vismask) return;
+    loopv(regions)
+    {
+        const dirtyregion &r = regions[i];
+        if(o.x < r.bbmax.x && o.y < r.bbmax.y && o.z < r.bbmax.z &&
+           o.x+size > r.bbmin.x && o.y+size > r.bbmin.y && o.z+size > r.bbmin.z)
+            return true;
+    }
+    return false;
+}
 
-    int tj = filltjoints && c.ext ? c.ext->tjoints : -1, vis;
-    loopi(6) if(vismask&(1<<i) && (vis = visibletris(c, i, co, size)))
+// grows the bounds to cover every leaf cube overlapping the region
+static void regionbounds(cube *c, const ivec &co, int size, const dirtyregion &r, ivec &bbmin, ivec &bbmax)
+{
+    loopoctabox(co, size, r.bbmin, r.bbmax)
     {
-        vec pos[MAXFACEVERTS];
-        vertinfo *verts = NULL;
-        int numverts = c.ext ? c.ext->surfaces[i].numverts&MAXFACEVERTS : 0, convex = 0;
-        if(numverts)
+        ivec o(i, co, size);
+        if(c[i].children) regionbounds(c[i].children, o, size>>1, r, bbmin, bbmax);
+        else
         {
-            verts = c.ext->verts() + c.ext->surfaces[i].verts;
-            vec vo(ivec(co).mask(~0xFFF));
-            loopj(numverts) pos[j] = vec(verts[j].getxyz()).mul(1.0f/8).add(vo);
-            if(!flataxisface(c, i)) convex = faceconvexity(verts, numverts, size);
+            bbmin.min(o);
+            bbmax.max(ivec(o).add(size));
         }
+    }
+}
+
+// only the edges of cubes inside the regions get t-joints, the cubes around them just contribute their edges
+static void gencubeedges(const vector<dirtyregion> &regions, const vector<dirtyregion> &bounds, cube *c, const ivec &co, int size)
+{
+    neighbourstack[++neighbourdepth] = c;
+    loopi(8)
+    {
+        ivec o(i, co, size);
+        if(!overlapsregions(bounds, o, size)) continue;
+        if(c[i].children) gencubeedges(regions, bounds, c[i].children, o, size>>1);
         else
         {
-            ivec v[4];
-            genfaceverts(c, i, v);
-            if(!flataxisface(c, i)) convex = faceconvexity(v);
-            int order = vis&4 || convex < 0 ? 1 : 0;
-            vec vo(co);
-            pos[numverts++] = vec(v[order]).mul(size/8.0f).add(vo);
-            if(vis&1) pos[numverts++] = vec(v[order+1]).mul(size/8.0f).add(vo);
-            pos[numverts++] = vec(v[order+2]).mul(size/8.0f).add(vo);
-            if(vis&2) pos[numverts++] = vec(v[(order+3)&3]).mul(size/8.0f).add(vo);
+            bool fix = overlapsregions(regions, o, size);
+            if(fix && c[i].ext) c[i].ext->tjoints = -1;
+            if(!isempty(c[i])) gencubeedges(c[i], o, size, fix);
         }
+    }
+    --neighbourdepth;
+}
 
-        VSlot &vslot = lookupvslot(c.texture[i], true),
-              *layer = vslot.layer && !(c.material&MAT_ALPHA) ? &lookupvslot(vslot.layer, true) : NULL;
-        ushort envmap = vslot.slot->shader->type&SHADER_ENVMAP ? (vslot.slot->texmask&(1<<TEX_ENVMAP) ? EMID_CUSTOM : closestenvmap(i, co, size)) : EMID_NONE,
-               envmap2 = layer && layer->slot->shader->type&SHADER_ENVMAP ? (layer->slot->texmask&(1<<TEX_ENVMAP) ? EMID_CUSTOM : closestenvmap(i, co, size)) : EMID_NONE;
-        while(tj >= 0 && tjoints[tj].edge < i*(MAXFACEVERTS+1)) tj = tjoints[tj].next;
-        int hastj = tj >= 0 && tjoints[tj].edge < (i+1)*(MAXFACEVERTS+1) ? tj : -1;
-        int grassy = vslot.slot->grass && i!=O_BOTTOM ? (vis!=3 || convex ? 1 : 2) : 0;
-        if(!c.ext)
-            addcubeverts(vslot, i, size, pos, convex, c.texture[i], NULL, numverts, hastj, envmap, grassy, (c.material&MAT_ALPHA)!=0);
-        else
+void findcubefaces(cube &c, const ivec &co, int size)
+{
+    if(!(c.visible&0xC0)) return;
+
+    int vismask = ~c.merged & 0x3F;
+    if(!(c.visible&0x80)) vismask &= c.visible;
+    if(!vismask) return;
+
+    int vis;
+    loopi(6) if(vismask&(1<<i) && (vis = visibletris(c, i, co, size)))
+    {
+        // slots are loaded here, on the main thread, as the faces may be generated on any other
+        VSlot &vslot = lookupvslot(c.texture[i], true);
+        if(vslot.layer && !(c.material&MAT_ALPHA)) lookupvslot(vslot.layer, true);
+        if(c.ext)
         {
             const surfaceinfo &surf = c.ext->surfaces[i];
-            if(!surf.numverts || surf.numverts&LAYER_TOP)
-                addcubeverts(vslot, i, size, pos, convex, c.texture[i], verts, numverts, hastj, envmap, grassy, (c.material&MAT_ALPHA)!=0, surf.numverts&LAYER_BLEND);
-            if(surf.numverts&LAYER_BOTTOM)
-                addcubeverts(layer ? *layer : vslot, i, size, pos, convex, vslot.layer, verts, numverts, hastj, envmap2, 0, false, surf.numverts&LAYER_TOP ? LAYER_BOTTOM : LAYER_TOP);
+            if(surf.numverts && !(surf.numverts&LAYER_BLEND)) continue;
         }
+
+        vaface &f = vc.faces.add();
+        f.c = &c;
+        f.co = co;
+        f.size = size;
+        f.merge = -1;
+        f.orient = i;
+        f.vis = vis;
+    }
+}
+
+void gencubeface(vacollect &vc, const vaface &f)
+{
+    cube &c = *f.c;
+    const ivec &co = f.co;
+    int size = f.size, orient = f.orient, vis = f.vis;
+
+    vec pos[MAXFACEVERTS];
+    vertinfo *verts = NULL;
+    int numverts = c.ext ? c.ext->surfaces[orient].numverts&MAXFACEVERTS : 0, convex = 0;
+    if(numverts)
+    {
+        verts = c.ext->verts() + c.ext->surfaces[orient].verts;
+        vec vo(ivec(co).mask(~0xFFF));
+        loopj(numverts) pos[j] = vec(verts[j].getxyz()).mul(1.0f/8).add(vo);
+        if(!flataxisface(c, orient)) convex = faceconvexity(verts, numverts, size);
+    }
+    else
+    {
+        ivec v[4];
+        genfaceverts(c, orient, v);
+        if(!flataxisface(c, orient)) convex = faceconvexity(v);
+        int order = vis&4 || convex < 0 ? 1 : 0;
+        vec vo(co);
+        pos[numverts++] = vec(v[order]).mul(size/8.0f).add(vo);
+        if(vis&1) pos[numverts++] = vec(v[order+1]).mul(size/8.0f).add(vo);
+        pos[numverts++] = vec(v[order+2]).mul(size/8.0f).add(vo);
+        if(vis&2) pos[numverts++] = vec(v[(order+3)&3]).mul(size/8.0f).add(vo);
+    }
+
+    VSlot &vslot = lookupvslot(c.texture[orient], false),
+          *layer = vslot.layer && !(c.material&MAT_ALPHA) ? &lookupvslot(vslot.layer, false) : NULL;
+    ushort envmap = vslot.slot->shader->type&SHADER_ENVMAP ? (vslot.slot->texmask&(1<<TEX_ENVMAP) ? EMID_CUSTOM : closestenvmap(orient, co, size)) : EMID_NONE,
+           envmap2 = layer && layer->slot->shader->type&SHADER_ENVMAP ? (layer->slot->texmask&(1<<TEX_ENVMAP) ? EMID_CUSTOM : closestenvmap(orient, co, size)) : EMID_NONE;
+    int tj = filltjoints && c.ext ? c.ext->tjoints : -1;
+    while(tj >= 0 && tjoints[tj].edge < orient*(MAXFACEVERTS+1)) tj = tjoints[tj].next;
+    int hastj = tj >= 0 && tjoints[tj].edge < (orient+1)*(MAXFACEVERTS+1) ? tj : -1;
+    int grassy = vslot.slot->grass && orient!=O_BOTTOM ? (vis!=3 || convex ? 1 : 2) : 0;
+    if(!c.ext)
+        addcubeverts(vc, vslot, orient, size, pos, convex, c.texture[orient], NULL, numverts, hastj, envmap, grassy, (c.material&MAT_ALPHA)!=0);
+    else
+    {
+        const surfaceinfo &surf = c.ext->surfaces[orient];
+        if(!surf.numverts || surf.numverts&LAYER_TOP)
+            addcubeverts(vc, vslot, orient, size, pos, convex, c.texture[orient], verts, numverts, hastj, envmap, grassy, (c.material&MAT_ALPHA)!=0, surf.numverts&LAYER_BLEND);
+        if(surf.numverts&LAYER_BOTTOM)
+            addcubeverts(vc, layer ? *layer : vslot, orient, size, pos, convex, vslot.layer, verts, numverts, hastj, envmap2, 0, false, surf.numverts&LAYER_TOP ? LAYER_BOTTOM : LAYER_TOP);
     }
 }
 
@@ -1158,31 +1271,9 @@ vtxarray *newva(const ivec &o, int size)
     va->hasmerges = 0;
     va->mergelevel = -1;
 
-    vc.setupdata(va);
-
-    if(va->alphatris)
-    {
-        va->alphamin = ivec(vec(vc.alphamin).mul(8)).shr(3);
-        va->alphamax = ivec(vec(vc.alphamax).mul(8)).add(7).shr(3);
-    }
-
-    if(va->refracttris)
-    {
-        va->refractmin = ivec(vec(vc.refractmin).mul(8)).shr(3);
-        va->refractmax = ivec(vec(vc.refractmax).mul(8)).add(7).shr(3);
-    }
-
-    if(va->sky && vc.skymax.x >= 0)
-    {
-        va->skymin = ivec(vec(vc.skymin).mul(8)).shr(3);
-        va->skymax = ivec(vec(vc.skymax).mul(8)).add(7).shr(3);
-    }
-        
-    va->nogimin = vc.nogimin;
-    va->nogimax = vc.nogimax;
+    if(vc.mapmodels.length()) va->mapmodels.put(vc.mapmodels.getbuf(), vc.mapmodels.length());
+    if(vc.decals.length()) va->decals.put(vc.decals.getbuf(), vc.decals.length());
 
-    wverts += va->verts;
-    wtris  += va->tris + va->blends + va->alphatris + va->decaltris;
     allocva++;
     valist.add(va);
 
@@ -1287,14 +1378,6 @@ void updatevabbs(bool force)
     else loopv(varoot) updatevabb(varoot[i]);
 }
 
-struct mergedface
-{
-    uchar orient, numverts;
-    ushort mat, tex, envmap;
-    vertinfo *verts;
-    int tjoints;
-};
-
 #define MAXMERGELEVEL 12
 static int vahasmerges = 0, vamergemax = 0;
 static vector<mergedface> vamerges[MAXMERGELEVEL+1];
@@ -1375,25 +1458,52 @@ void addmergedverts(int level, const ivec &o)
 {
     vector<mergedface> &mfl = vamerges[level];
     if(mfl.empty()) return;
-    vec vo(ivec(o).mask(~0xFFF));
-    vec pos[MAXFACEVERTS];
     loopv(mfl)
     {
         mergedface &mf = mfl[i];
-        int numverts = mf.numverts&MAXFACEVERTS;
-        loopi(numverts)
-        {
-            vertinfo &v = mf.verts[i];
-            pos[i] = vec(v.x, v.y, v.z).mul(1.0f/8).add(vo);
-        }
-        VSlot &vslot = lookupvslot(mf.tex, true);
-        int grassy = vslot.slot->grass && mf.orient!=O_BOTTOM && mf.numverts&LAYER_TOP ? 2 : 0;
-        addcubeverts(vslot, mf.orient, 1<<level, pos, 0, mf.tex, mf.verts, numverts, mf.tjoints, mf.envmap, grassy, (mf.mat&MAT_ALPHA)!=0, mf.numverts&LAYER_BLEND);
+        lookupvslot(mf.tex, true);
+        vaface &f = vc.faces.add();
+        f.c = NULL;
+        f.co = o;
+        f.size = 1<<level;
+        f.merge = vc.merges.length();
+        f.orient = mf.orient;
+        f.vis = 0;
+        vc.merges.add(mf);
         vahasmerges |= MERGE_USE;
     }
     mfl.setsize(0);
 }
 
+void genmergedface(vacollect &vc, const vaface &f)
+{
+    const mergedface &mf = vc.merges[f.merge];
+    int numverts = mf.numverts&MAXFACEVERTS;
+    vec vo(ivec(f.co).mask(~0xFFF));
+    vec pos[MAXFACEVERTS];
+    loopi(numverts)
+    {
+        vertinfo &v = mf.verts[i];
+        pos[i] = vec(v.x, v.y, v.z).mul(1.0f/8).add(vo);
+    }
+    VSlot &vslot = lookupvslot(mf.tex, false);
+    int grassy = vslot.slot->grass && mf.orient!=O_BOTTOM && mf.numverts&LAYER_TOP ? 2 : 0;
+    addcubeverts(vc, vslot, mf.orient, f.size, pos, 0, mf.tex, mf.verts, numverts, mf.tjoints, mf.envmap, grassy, (mf.mat&MAT_ALPHA)!=0, mf.numverts&LAYER_BLEND);
+}
+
+// generates the vertices and indices of a va from its plan, on any thread
+void buildva(vacollect &vc)
+{
+    loopv(vc.faces)
+    {
+        const vaface &f = vc.faces[i];
+        if(f.c) gencubeface(vc, f);
+        else genmergedface(vc, f);
+    }
+    vc.optimize();
+    vc.gendecals();
+}
+
 static inline void finddecals(vtxarray *va)
 {
     if(va->hasmerges&(MERGE_ORIGIN|MERGE_PART))
@@ -1440,7 +1550,7 @@ void rendercube(cube &c, const ivec &co, int size, int csi, int &maxlevel) // cr
 
     if(!isempty(c))
     {
-        gencubeverts(c, co, size, csi);
+        findcubefaces(c, co, size);
         if(c.merged) maxlevel = max(maxlevel, genmergedfaces(c, co, size));
     }
     if(c.material != MAT_AIR)
@@ -1462,7 +1572,7 @@ void rendercube(cube &c, const ivec &co, int size, int csi, int &maxlevel) // cr
     if(csi <= MAXMERGELEVEL && vamerges[csi].length()) addmergedverts(csi, co);
 }
 
-void calcgeombb(const ivec &co, int size, ivec &bbmin, ivec &bbmax)
+void calcgeombb(vacollect &vc, const ivec &co, int size, ivec &bbmin, ivec &bbmax)
 {
     vec vmin(co), vmax = vmin;
     vmin.add(size);
@@ -1478,9 +1588,56 @@ void calcgeombb(const ivec &co, int size, ivec &bbmin, ivec &bbmax)
     bbmax = ivec(vmax.mul(8)).add(7).shr(3);
 }
 
+// fills a va with what was built for it, on the main thread as it packs its buffers in vbos
+void setupva(vacollect &vc, vtxarray *va)
+{
+    vc.setupdata(va);
+
+    if(va->alphatris)
+    {
+        va->alphamin = ivec(vec(vc.alphamin).mul(8)).shr(3);
+        va->alphamax = ivec(vec(vc.alphamax).mul(8)).add(7).shr(3);
+    }
+
+    if(va->refracttris)
+    {
+        va->refractmin = ivec(vec(vc.refractmin).mul(8)).shr(3);
+        va->refractmax = ivec(vec(vc.refractmax).mul(8)).add(7).shr(3);
+    }
+
+    if(va->sky && vc.skymax.x >= 0)
+    {
+        va->skymin = ivec(vec(vc.skymin).mul(8)).shr(3);
+        va->skymax = ivec(vec(vc.skymax).mul(8)).add(7).shr(3);
+    }
+        
+    va->nogimin = vc.nogimin;
+    va->nogimax = vc.nogimax;
+
+    wverts += va->verts;
+    wtris  += va->tris + va->blends + va->alphatris + va->decaltris;
+
+    calcgeombb(vc, va->o, va->size, va->geommin, va->geommax);
+    calcmatbb(va, va->o, va->size, vc.matsurfs);
+}
+
 static int entdepth = -1;
 static octaentities *entstack[32];
 
+// while set, vas are only planned by setva() and built together by buildvas()
+static bool deferva = false;
+static vector<vaplan> vaplans;
+
+static void loaddecalslots(const vector<octaentities *> &oes)
+{
+    vector<extentity *> &ents = entities::getents();
+    loopv(oes)
+    {
+        const octaentities *oe = oes[i];
+        loopvj(oe->decals) lookupdecalslot(ents[oe->decals[j]]->attr1, true);
+    }
+}
+
 void setva(cube &c, const ivec &co, int size, int csi)
 {
     ASSERT(size <= 0x1000);
@@ -1503,11 +1660,20 @@ void setva(cube &c, const ivec &co, int size, int csi)
     if(size == min(0x1000, worldsize/2) || !vc.emptyva())
     {
         vtxarray *va = newva(co, size);
+        // a leaf given an ext only to hold its va has no surfaces, which generates the same faces as no ext
         ext(c).va = va;
-        calcgeombb(co, size, va->geommin, va->geommax);
-        calcmatbb(va, co, size, vc.matsurfs);
         va->hasmerges = vahasmerges;
         va->mergelevel = vamergemax;
+        vc.va = va;
+
+        loaddecalslots(vc.decals);
+        loaddecalslots(vc.extdecals);
+        if(deferva) vaplans.add().takeplan(vc);
+        else
+        {
+            buildva(vc);
+            setupva(vc, va);
+        }
     }
     else
     {
@@ -1546,6 +1712,7 @@ static inline int setcubevisibility(cube &c, const ivec &co, int size)
 VARF(vafacemax, 64, 384, 256*256, allchanged());
 VARF(vafacemin, 0, 96, 256*256, allchanged());
 VARF(vacubesize, 32, 128, 0x1000, allchanged());
+VARP(parallelva, 0, 1, 1);
 
 int updateva(cube *c, const ivec &co, int size, int csi)
 {
@@ -1610,6 +1777,7 @@ int updateva(cube *c, const ivec &co, int size, int csi)
 
 void addtjoint(const edgegroup &g, const cubeedge &e, int offset)
 {
+    if(!(e.flags&CE_FIX)) return;
     int vcoord = (g.slope[g.axis]*offset + g.origin[g.axis]) & 0x7FFF;
     tjoint &tj = tjoints.add();
     tj.offset = vcoord / g.slope[g.axis];
@@ -1671,6 +1839,9 @@ void findtjoints(int cur, const edgegroup &g)
     }
 }
 
+// length of tjoints when it last held no orphaned t-joints
+static int compactedtjoints = 0;
+
 void findtjoints()
 {
     recalcprogress = 0;
@@ -1679,18 +1850,107 @@ void findtjoints()
     enumeratekt(edgegroups, edgegroup, g, int, e, findtjoints(e, g));
     cubeedges.setsize(0);
     edgegroups.clear();
+    compactedtjoints = tjoints.length();
+}
+
+static void compacttjoints(cube *c, vector<tjoint> &compacted)
+{
+    loopi(8)
+    {
+        if(c[i].ext && c[i].ext->tjoints >= 0)
+        {
+            int prev = -1;
+            for(int tj = c[i].ext->tjoints; tj >= 0; tj = tjoints[tj].next)
+            {
+                if(prev < 0) c[i].ext->tjoints = compacted.length();
+                else compacted[prev].next = compacted.length();
+                prev = compacted.length();
+                compacted.add(tjoints[tj]);
+            }
+            compacted[prev].next = -1;
+        }
+        if(c[i].children) compacttjoints(c[i].children, compacted);
+    }
+}
+
+// drops the t-joints no cube links to anymore, left behind by the cubes whose t-joints were refound
+static void compacttjoints()
+{
+    vector<tjoint> compacted;
+    compacttjoints(worldroot, compacted);
+    tjoints.setsize(0);
+    tjoints.move(compacted);
+    compactedtjoints = tjoints.length();
+}
+
+// refinds the t-joints of the cubes touching the edited regions, leaving the ones elsewhere in place
+void findtjoints(const vector<dirtyregion> &regions)
+{
+    if(regions.empty()) return;
+    vector<dirtyregion> bounds;
+    loopv(regions)
+    {
+        const dirtyregion &r = regions[i];
+        ivec bbmin(worldsize, worldsize, worldsize), bbmax(0, 0, 0);
+        regionbounds(worldroot, ivec(0, 0, 0), worldsize>>1, r, bbmin, bbmax);
+        if(bbmin.x >= bbmax.x) continue;
+        dirtyregion &b = bounds.add();
+        b.bbmin = bbmin.sub(1);
+        b.bbmax = bbmax.add(1);
+    }
+    gencubeedges(regions, bounds, worldroot, ivec(0, 0, 0), worldsize>>1);
+    enumeratekt(edgegroups, edgegroup, g, int, e, findtjoints(e, g));
+    cubeedges.setsize(0);
+    edgegroups.clear();
+    // the t-joints of the edited cubes were only unlinked, reclaim them once they could make up half of the list
+    if(tjoints.length() > 2*compactedtjoints + 1024) compacttjoints();
 }
 
+#define VABATCH 64
+
+static vacollect *vabuilders[VABATCH];
+
+// builds the planned vas on the job system, a batch at a time, then packs them in vbos in the order they were planned
+static void buildvas()
+{
+    octahedron::job_system &jobs = g_engine->get_job_system();
+    for(int start = 0; start < vaplans.length(); start += VABATCH)
+    {
+        int num = min(vaplans.length() - start, VABATCH);
+        loopi(num) if(!vabuilders[i]) vabuilders[i] = new vacollect;
+        jobs.parallel_for(0, num, [start](size_t i)
+        {
+            vacollect &b = *vabuilders[i];
+            b.takeplan(vaplans[start + int(i)]);
+            buildva(b);
+        }, 1);
+        loopi(num)
+        {
+            vacollect &b = *vabuilders[i];
+            setupva(b, b.va);
+            b.clear();
+        }
+    }
+    vaplans.shrink(0);
+}
+
+static double vamillis = 0;
+
 void octarender()                               // creates va s for all leaf cubes that don't already have them
 {
+    auto start = std::chrono::steady_clock::now();
     int csi = 0;
     while(1<<csi < worldsize) csi++;
 
     recalcprogress = 0;
     varoot.setsize(0);
+    deferva = parallelva != 0;
     updateva(worldroot, ivec(0, 0, 0), worldsize/2, csi-1);
+    deferva = false;
+    buildvas();
     loadprogress = 0;
     flushvbo();
+    vamillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
     explicitsky = 0;
     loopv(valist)
@@ -1735,6 +1995,7 @@ void allchanged(bool load)
     if(load) initlights();
     renderprogress(0, "clearing vertex arrays...");
     clearvas(worldroot);
+    discardchanges();
     resetqueries();
     resetclipplanes();
     if(load) initenvmaps();
@@ -1763,3 +2024,48 @@ void recalc()
 
 COMMAND(recalc, "");
 
+static inline void hashvabytes(ullong &h, const void *data, int len)
+{
+    const uchar *bytes = (const uchar *)data;
+    loopi(len) h = (h ^ bytes[i]) * 0x100000001B3ULL;
+}
+
+// hashes the contents of every va's buffers and how they are packed in vbos
+static ullong hashvas()
+{
+    ullong h = 0xCBF29CE484222325ULL;
+    loopv(valist)
+    {
+        vtxarray *va = valist[i];
+        int layout[] = { i && va->vbuf == valist[i-1]->vbuf, va->voffset, va->eoffset, va->skyoffset, va->decaloffset, va->verts, va->sky };
+        hashvabytes(h, layout, sizeof(layout));
+        if(va->verts) hashvabytes(h, va->vdata + va->voffset, va->verts*sizeof(vertex));
+        int elems = 0, decalelems = 0;
+        loopj(va->texs + va->blends + va->alphaback + va->alphafront + va->refract) elems += va->texelems[j].length;
+        loopj(va->decaltexs) decalelems += va->decalelems[j].length;
+        if(elems) hashvabytes(h, va->edata + va->eoffset, elems*sizeof(ushort));
+        if(va->sky) hashvabytes(h, va->skydata + va->skyoffset, va->sky*sizeof(ushort));
+        if(decalelems) hashvabytes(h, va->decaldata + va->decaloffset, decalelems*sizeof(ushort));
+    }
+    return h;
+}
+
+// rebuilds the vas of the current map serially then in parallel, and reports the speedup
+ICOMMAND(vatiming, "", (),
+{
+    int oldparallelva = parallelva;
+    double millis[2];
+    ullong hashes[2];
+    loopi(2)
+    {
+        parallelva = i;
+        allchanged();
+        millis[i] = vamillis;
+        hashes[i] = hashvas();
+    }
+    parallelva = oldparallelva;
+    conoutf("%d vertex arrays: %.1fms serial, %.1fms on %d threads (%.2fx), buffers %s",
+        valist.length(), millis[0], millis[1], int(g_engine->get_job_system().thread_count()) + 1,
+        millis[0]/max(millis[1], 1e-3), hashes[0] == hashes[1] ? "identical" : "differ");
+});
+
@@ -1818,6 +1818,7 @@ bool moveplayer(physent *pl, int moveres, bool local, int curtime)
 
         d.mul(f);
         loopi(moveres) if(!move(pl, d) && ++collisions<5) i--; // discrete steps collision detection & sliding
+        if(collisions) g_engine->binary_log<"physics: entity {} collided {} times, at {:.2f} {:.2f} {:.2f}">(octahedron::log_level::TRACE, int(pl->type), collisions, pl->o.x, pl->o.y, pl->o.z);
         if(timeinair > 800 && !pl->timeinair && !water) // if we land after long time must have been a high jump, make thud sound
         {
             game::physicstrigger(pl, local, -1, 0);
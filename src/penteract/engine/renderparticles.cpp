@@ -1008,19 +1008,23 @@ static void splash(int type, int color, int radius, int num, int fade, const vec
     float collidez = parts[type]->type&PT_COLLIDE ? p.z - raycube(p, vec(0, 0, -1), COLLIDERADIUS, RAY_CLIPMAT) + (parts[type]->stain >= 0 ? COLLIDEERROR : 0) : -1;
     int fmin = 1;
     int fmax = fade*3;
-    loopi(num)
+    // directions and distances are drawn in batches, a direction scaled by radius*cbrt(u) is uniform in the ball
+    const int batchsize = 64;
+    std::array<float, 3> dirs[batchsize];
+    float dists[batchsize];
+    octahedron::random_stream &rng = octahedron::thread_random();
+    for(int base = 0; base < num; base += batchsize)
     {
-        int x, y, z;
-        do
+        int batch = min(num - base, batchsize);
+        rng.generate_unit_vectors({dirs, size_t(batch)});
+        rng.generate_floats({dists, size_t(batch)});
+        loopj(batch)
         {
-            x = rnd(radius*2)-radius;
-            y = rnd(radius*2)-radius;
-            z = rnd(radius*2)-radius;
+            int i = base + j;
+            vec tmp = vec(dirs[j][0], dirs[j][1], dirs[j][2]).mul(radius*cbrtf(dists[j]));
+            int f = (num < 10) ? (fmin + rnd(fmax)) : (fmax - (i*(fmax-fmin))/(num-1)); //help deallocater by using fade distribution rather than random
+            newparticle(p, tmp, f, type, color, size, gravity)->val = collidez;
         }
-        while(x*x+y*y+z*z>radius*radius);
-        vec tmp = vec((float)x, (float)y, (float)z);
-        int f = (num < 10) ? (fmin + rnd(fmax)) : (fmax - (i*(fmax-fmin))/(num-1)); //help deallocater by using fade distribution rather than random
-        newparticle(p, tmp, f, type, color, size, gravity)->val = collidez;
     }
 }
 
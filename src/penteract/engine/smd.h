@@ -259,7 +259,7 @@ struct smd : skelloader<smd>
 
         bool loadmesh(const char *filename)
         {
-            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT);
+            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT | octahedron::open_flags::MAPPED);
             if (!f)
                 return false;
 
@@ -365,7 +365,7 @@ struct smd : skelloader<smd>
             skelanimspec *sa = skel->findskelanim(filename);
             if(sa || skel->numbones <= 0) return sa;
 
-            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT);
+            auto f = g_engine->get_file_system().open(filename, octahedron::open_flags::INPUT | octahedron::open_flags::MAPPED);
             if (!f)
                 return nullptr;
 
@@ -3530,7 +3530,7 @@ bool loaddds(const char *filename, ImageData &image, int force)
 {
     auto f = g_engine->get_file_system().open(
       filename,
-      octahedron::open_flags::INPUT | octahedron::open_flags::BINARY
+      octahedron::open_flags::INPUT | octahedron::open_flags::BINARY | octahedron::open_flags::MAPPED
     );
     if(!f)
       return false;
@@ -22,7 +22,7 @@ struct octaheader
     int numvslots;
 };
 
-#define MAPVERSION 1            // bump if map format changes, see worldio.cpp
+#define MAPVERSION 2            // bump if map format changes, see worldio.cpp
 
 struct mapheader
 {
@@ -3,9 +3,13 @@
 #include "engine.h"
 
 #include "tools/math.h"
+#include "io/buffered_stream.h"
 #include "io/file_stream.h"
 #include "io/gz_file_stream.h"
+#include "io/readahead_stream.h"
+#include "io/serializer.h"
 
+using octahedron::buffered_stream;
 using octahedron::file_stream;
 using octahedron::log_level;
 
@@ -38,7 +42,9 @@ static void fixent(entity &e, int version)
 
 static bool loadmapheader(file_stream *f, const char *ogzname, mapheader &hdr, octaheader &ohdr)
 {
-		if (auto ret = f->getAll(hdr.magic, hdr.version, hdr.headersize); !ret)
+		// both headers are read whole, an OCTA header being a TMAP header with one more int
+		static_assert(sizeof(octaheader) == sizeof(mapheader) + sizeof(int) && offsetof(octaheader, numvslots) == sizeof(mapheader));
+		if (auto ret = f->get(hdr); !ret)
     {
 	    octahedron::log(log_level::ERROR, "map {} has malformatted header", ogzname);
 			octahedron::log(log_level::ERROR | log_level::DEBUG, "(expected to read {} bytes, got {})", ret.expected_size, ret.value);
@@ -51,12 +57,6 @@ static bool loadmapheader(file_stream *f, const char *ogzname, mapheader &hdr, o
 	        octahedron::log(log_level::ERROR, "map {} requires a newer version of Tesseract", ogzname);
         	return false;
         }
-        if(auto ret = f->getAll(hdr.worldsize, hdr.numents, hdr.numpvs, hdr.blendmap, hdr.numvars, hdr.numvslots); !ret)
-        {
-	        octahedron::log(log_level::ERROR, "map {} has malformatted header", ogzname);
-					octahedron::log(log_level::ERROR | log_level::DEBUG, "(expected to read {} bytes, got {})", ret.expected_size, ret.value);
-        	return false;
-				}
 				if (hdr.worldsize <= 0 || hdr.numents < 0)
 				{
 					octahedron::log(log_level::ERROR, "map {} has malformatted header", ogzname);
@@ -73,15 +73,8 @@ static bool loadmapheader(file_stream *f, const char *ogzname, mapheader &hdr, o
 						ogzname);
 					return false;
 				}
-				if (auto ret = f->getAll(
-							ohdr.worldsize,
-							ohdr.numents,
-							ohdr.numpvs,
-							ohdr.lightmaps,
-							ohdr.blendmap,
-							ohdr.numvars,
-							ohdr.numvslots);
-						!ret)
+				memcpy(&ohdr, &hdr, sizeof(hdr));
+				if (auto ret = f->get(ohdr.numvslots); !ret)
 				{
 					octahedron::log(log_level::ERROR, "map {} has malformatted header", ogzname);
 					octahedron::log(log_level::ERROR | log_level::DEBUG, "(expected to read {} bytes, got {})", ret.expected_size, ret.value);
@@ -119,7 +112,7 @@ bool loadents(const char *fname, vector<entity> &ents, uint *crc)
     validmapname(name, fname);
     defformatstring(ogzname, "media/map/%s.ogz", name);
 		path(ogzname);
-		auto f = g_engine->get_file_system().open_gz(ogzname, OpenFlags::INPUT | OpenFlags::BINARY);
+		auto f = g_engine->get_file_system().open_gz(ogzname, OpenFlags::INPUT | OpenFlags::BINARY | OpenFlags::MAPPED);
     if(!f) return false;
 
     mapheader hdr;
@@ -231,7 +224,17 @@ void backup(const char *name, const char *backupname)
     g_engine->get_file_system().rename(name, backupname);
 }
 
-enum { OCTSAV_CHILDREN = 0, OCTSAV_EMPTY, OCTSAV_SOLID, OCTSAV_NORMAL };
+enum { OCTSAV_CHILDREN = 0, OCTSAV_EMPTY, OCTSAV_SOLID, OCTSAV_NORMAL, OCTSAV_CHUNK };
+
+// since map version 2, the children of cubes this size are saved after the rest of the octree, each on its own,
+// with an index of their sizes so that they can be loaded in parallel
+#define MAPCHUNKSIZE 512
+
+struct mapchunk
+{
+    cube *c;
+    ivec o;
+};
 
 #define LM_PACKW 512
 #define LM_PACKH 512
@@ -245,7 +248,8 @@ struct polysurfacecompat
 
 static int savemapprogress = 0;
 
-void savec(cube *c, const ivec &o, int size, file_stream *f, bool nolms)
+template<class S>
+void savec(cube *c, const ivec &o, int size, S *f, bool nolms, vector<mapchunk> *chunks = NULL)
 {
     if((savemapprogress++&0xFFF)==0) renderprogress(float(savemapprogress)/allocnodes, "saving octree...");
 
@@ -254,14 +258,22 @@ void savec(cube *c, const ivec &o, int size, file_stream *f, bool nolms)
         ivec co(i, o, size);
         if(c[i].children)
         {
-            f->put<char>(OCTSAV_CHILDREN);
+            if(chunks && size == MAPCHUNKSIZE)
+            {
+                f->template put<char>(OCTSAV_CHUNK);
+                mapchunk &chunk = chunks->add();
+                chunk.c = &c[i];
+                chunk.o = co;
+                continue;
+            }
+            f->template put<char>(OCTSAV_CHILDREN);
             savec(c[i].children, co, size>>1, f, nolms);
         }
         else
         {
             int oflags = 0, surfmask = 0, totalverts = 0;
             if(c[i].material!=MAT_AIR) oflags |= 0x40;
-            if(isempty(c[i])) f->put<char>(oflags | OCTSAV_EMPTY);
+            if(isempty(c[i])) f->template put<char>(oflags | OCTSAV_EMPTY);
             else
             {
                 if(!nolms)
@@ -277,22 +289,22 @@ void savec(cube *c, const ivec &o, int size, file_stream *f, bool nolms)
                     }
                 }
 
-                if(isentirelysolid(c[i])) f->put<char>(oflags | OCTSAV_SOLID);
+                if(isentirelysolid(c[i])) f->template put<char>(oflags | OCTSAV_SOLID);
                 else
                 {
-                    f->put<char>(oflags | OCTSAV_NORMAL);
+                    f->template put<char>(oflags | OCTSAV_NORMAL);
                     f->write(c[i].edges, 12);
                 }
             }
 
-            loopj(6) f->put<ushort>(c[i].texture[j]);
+            loopj(6) f->template put<ushort>(c[i].texture[j]);
 
-            if(oflags&0x40) f->put<ushort>(c[i].material);
-            if(oflags&0x80) f->put<char>(c[i].merged);
+            if(oflags&0x40) f->template put<ushort>(c[i].material);
+            if(oflags&0x80) f->template put<char>(c[i].merged);
             if(oflags&0x20)
             {
-                f->put<char>(surfmask);
-                f->put<char>(totalverts);
+                f->template put<char>(surfmask);
+                f->template put<char>(totalverts);
                 loopj(6) if(surfmask&(1<<j))
                 {
                     surfaceinfo surf = c[i].ext->surfaces[j];
@@ -342,21 +354,21 @@ void savec(cube *c, const ivec &o, int size, file_stream *f, bool nolms)
                         if(hasxyz && vertmask&0x01)
                         {
                             ivec v0 = verts[vertorder].getxyz(), v2 = verts[(vertorder+2)&3].getxyz();
-                            f->put<ushort>(v0[vc]); f->put<ushort>(v0[vr]);
-                            f->put<ushort>(v2[vc]); f->put<ushort>(v2[vr]);
+                            f->template put<ushort>(v0[vc]); f->template put<ushort>(v0[vr]);
+                            f->template put<ushort>(v2[vc]); f->template put<ushort>(v2[vr]);
                             hasxyz = false;
                         }
                     }
-                    if(hasnorm && vertmask&0x08) { f->put<ushort>(verts[0].norm); hasnorm = false; }
+                    if(hasnorm && vertmask&0x08) { f->template put<ushort>(verts[0].norm); hasnorm = false; }
                     if(hasxyz || hasnorm) loopk(layerverts)
                     {
                         const vertinfo &v = verts[(k+vertorder)%layerverts];
                         if(hasxyz)
                         {
                             ivec xyz = v.getxyz();
-                            f->put<ushort>(xyz[vc]); f->put<ushort>(xyz[vr]);
+                            f->template put<ushort>(xyz[vc]); f->template put<ushort>(xyz[vr]);
                         }
-                        if(hasnorm) f->put<ushort>(v.norm);
+                        if(hasnorm) f->template put<ushort>(v.norm);
                     }
                 }
             }
@@ -364,30 +376,41 @@ void savec(cube *c, const ivec &o, int size, file_stream *f, bool nolms)
     }
 }
 
-cube *loadchildren(file_stream *f, const ivec &co, int size, bool &failed);
+template<class S>
+cube *loadchildren(S *f, const ivec &co, int size, bool &failed, vector<mapchunk> *chunks = NULL);
 
-void loadc(file_stream *f, cube &c, const ivec &co, int size, bool &failed)
+template<class S>
+void loadc(S *f, cube &c, const ivec &co, int size, bool &failed, vector<mapchunk> *chunks)
 {
-    int octsav = f->get<char>();
+    int octsav = f->template get<char>();
     switch(octsav&0x7)
     {
         case OCTSAV_CHILDREN:
-            c.children = loadchildren(f, co, size>>1, failed);
+            c.children = loadchildren(f, co, size>>1, failed, chunks);
+            return;
+
+        case OCTSAV_CHUNK:
+        {
+            if(!chunks || size != MAPCHUNKSIZE) { failed = true; return; }
+            mapchunk &chunk = chunks->add();
+            chunk.c = &c;
+            chunk.o = co;
             return;
+        }
 
         case OCTSAV_EMPTY:  emptyfaces(c);        break;
         case OCTSAV_SOLID:  solidfaces(c);        break;
         case OCTSAV_NORMAL: f->read(c.edges, 12); break;
         default: failed = true; return;
     }
-    loopi(6) c.texture[i] = f->get<ushort>();
-    if(octsav&0x40) c.material = f->get<ushort>();
-    if(octsav&0x80) c.merged = f->get<char>();
+    loopi(6) c.texture[i] = f->template get<ushort>();
+    if(octsav&0x40) c.material = f->template get<ushort>();
+    if(octsav&0x80) c.merged = f->template get<char>();
     if(octsav&0x20)
     {
         int surfmask, totalverts;
-        surfmask = f->get<char>();
-        totalverts = octahedron::max(f->get<char>(), 0);
+        surfmask = f->template get<char>();
+        totalverts = octahedron::max(f->template get<char>(), 0);
         newcubeext(c, totalverts, false);
         memset(c.ext->surfaces, 0, sizeof(c.ext->surfaces));
         memset(c.ext->verts(), 0, totalverts*sizeof(vertinfo));
@@ -431,7 +454,7 @@ void loadc(file_stream *f, cube &c, const ivec &co, int size, bool &failed)
             {
                 if(hasxyz && vertmask&0x01)
                 {
-                    ushort c1 = f->get<ushort>(), r1 = f->get<ushort>(), c2 = f->get<ushort>(), r2 = f->get<ushort>();
+                    ushort c1 = f->template get<ushort>(), r1 = f->template get<ushort>(), c2 = f->template get<ushort>(), r2 = f->template get<ushort>();
                     ivec xyz;
                     xyz[vc] = c1; xyz[vr] = r1; xyz[dim] = n[dim] ? -(bias + n[vc]*xyz[vc] + n[vr]*xyz[vr])/n[dim] : vo[dim];
                     verts[0].setxyz(xyz);
@@ -445,14 +468,14 @@ void loadc(file_stream *f, cube &c, const ivec &co, int size, bool &failed)
                 }
                 if(hasuv && vertmask&0x02)
                 {
-                    loopk(4) f->get<ushort>();
-                    if(surf.numverts&LAYER_DUP) loopk(4) f->get<ushort>();
+                    loopk(4) f->template get<ushort>();
+                    if(surf.numverts&LAYER_DUP) loopk(4) f->template get<ushort>();
                     hasuv = false;
                 }
             }
             if(hasnorm && vertmask&0x08)
             {
-                ushort norm = f->get<ushort>();
+                ushort norm = f->template get<ushort>();
                 loopk(layerverts) verts[k].norm = norm;
                 hasnorm = false;
             }
@@ -462,29 +485,122 @@ void loadc(file_stream *f, cube &c, const ivec &co, int size, bool &failed)
                 if(hasxyz)
                 {
                     ivec xyz;
-                    xyz[vc] = f->get<ushort>(); xyz[vr] = f->get<ushort>();
+                    xyz[vc] = f->template get<ushort>(); xyz[vr] = f->template get<ushort>();
                     xyz[dim] = n[dim] ? -(bias + n[vc]*xyz[vc] + n[vr]*xyz[vr])/n[dim] : vo[dim];
                     v.setxyz(xyz);
                 }
-                if(hasuv) { f->get<ushort>(); f->get<ushort>(); }
-                if(hasnorm) v.norm = f->get<ushort>();
+                if(hasuv) { f->template get<ushort>(); f->template get<ushort>(); }
+                if(hasnorm) v.norm = f->template get<ushort>();
             }
-            if(hasuv && surf.numverts&LAYER_DUP) loopk(layerverts) { f->get<ushort>(); f->get<ushort>(); }
+            if(hasuv && surf.numverts&LAYER_DUP) loopk(layerverts) { f->template get<ushort>(); f->template get<ushort>(); }
         }
     }
 }
 
-cube *loadchildren(file_stream *f, const ivec &co, int size, bool &failed)
+template<class S>
+cube *loadchildren(S *f, const ivec &co, int size, bool &failed, vector<mapchunk> *chunks)
 {
     cube *c = newcubes();
     loopi(8)
     {
-        loadc(f, c[i], ivec(i, co, size), size, failed);
+        loadc(f, c[i], ivec(i, co, size), size, failed, chunks);
         if(failed) break;
     }
     return c;
 }
 
+static void savechunks(file_stream *f, const vector<mapchunk> &chunks, bool nolms)
+{
+    std::vector<octahedron::dynamic_buffer> data(chunks.length());
+    loopv(chunks) savec(chunks[i].c->children, chunks[i].o, MAPCHUNKSIZE>>1, &data[i], nolms);
+    f->put<int>(chunks.length());
+    loopv(chunks) f->put<int>(int(data[i].size()));
+    loopv(chunks) f->write(data[i].data(), data[i].size());
+}
+
+VARP(parallelload, 0, 1, 1);
+
+// decodes the chunks of the octree on the job system, each as soon as its bytes are read, so that decoding overlaps
+// with inflating and reading the rest of the map; a chunk is validated by the job decoding it
+struct chunkloader
+{
+    vector<mapchunk> &chunks;
+    std::vector<std::vector<std::byte>> data;
+    std::vector<cube *> decoded;
+    std::vector<uchar> failed;
+    std::vector<octahedron::job> jobs;
+
+    chunkloader(vector<mapchunk> &chunks) : chunks(chunks), data(chunks.length()), decoded(chunks.length(), NULL), failed(chunks.length(), 0) {}
+    ~chunkloader() { finish(); }
+
+    void decode(int i)
+    {
+        octahedron::serializer in{data[i].data(), data[i].size()};
+        bool chunkfailed = false;
+        cube *c = NULL;
+        try { c = loadchildren(&in, chunks[i].o, MAPCHUNKSIZE>>1, chunkfailed); }
+        catch(const std::exception &) { chunkfailed = true; }
+        // a chunk must be made of exactly the bytes its size announced
+        if(in.tell() != in.size()) chunkfailed = true;
+        // validatec may discardchildren, which is safe off the main thread here: the cubes of a fresh chunk have no
+        // va nor octree entities yet, so it only frees cubes and cubeexts, and freeoctaentities merely reads the
+        // entity count, which no longer changes once the octree is being read
+        if(c) validatec(c, MAPCHUNKSIZE>>1);
+        std::vector<std::byte>().swap(data[i]);
+        decoded[i] = c;
+        failed[i] = chunkfailed;
+    }
+
+    // the buffer grows as bytes arrive, so a size the stream cannot back allocates about as much as was actually read
+    static bool readchunk(buffered_stream *f, std::vector<std::byte> &buf, size_t size)
+    {
+        while(buf.size() < size)
+        {
+            size_t pos = buf.size(), n = min(size - pos, max(pos, size_t(65536)));
+            buf.resize(pos + n);
+            if(f->read(std::span{buf.data() + pos, n}) != n) return false;
+        }
+        return true;
+    }
+
+    bool read(buffered_stream *f)
+    {
+        if(f->get<int>() != chunks.length()) return false;
+        std::vector<int> sizes(chunks.length());
+        loopv(chunks)
+        {
+            sizes[i] = f->get<int>();
+            if(sizes[i] < 0) return false;
+        }
+        loopv(chunks)
+        {
+            if(!readchunk(f, data[i], sizes[i])) return false;
+            if(parallelload) jobs.push_back(g_engine->get_job_system().submit([this, i]() { decode(i); }));
+            else decode(i);
+            renderprogress(float(i+1)/chunks.length(), "loading octree...");
+        }
+        return true;
+    }
+
+    // waits for the chunks still being decoded, then attaches them all to the octree
+    bool finish()
+    {
+        loopi(int(jobs.size()))
+        {
+            renderprogress(float(i)/jobs.size(), "decoding octree...");
+            g_engine->get_job_system().wait(jobs[i]);
+        }
+        jobs.clear();
+        bool ok = true;
+        loopv(chunks)
+        {
+            if(decoded[i]) { chunks[i].c->children = decoded[i]; decoded[i] = NULL; }
+            if(failed[i]) ok = false;
+        }
+        return ok;
+    }
+};
+
 VAR(dbgvars, 0, 0, 1);
 
 void savevslot(file_stream *f, VSlot &vs, int prev)
@@ -499,18 +615,18 @@ void savevslot(file_stream *f, VSlot &vs, int prev)
             SlotShaderParam &p = vs.params[i];
             f->put(ushort(strlen(p.name)));
             f->write(p.name, strlen(p.name));
-            loopk(4) f->put(float(p.val[k]));
+            f->put(p.val);
         }
     }
     if(vs.changed & (1<<VSLOT_SCALE)) f->put(float(vs.scale));
     if(vs.changed & (1<<VSLOT_ROTATION)) f->put(int(vs.rotation));
     if(vs.changed & (1<<VSLOT_OFFSET))
     {
-        loopk(2) f->put(int(vs.offset[k]));
+        f->put(vs.offset);
     }
     if(vs.changed & (1<<VSLOT_SCROLL))
     {
-        loopk(2) f->put(float(vs.scroll[k]));
+        f->put(vs.scroll);
     }
     if(vs.changed & (1<<VSLOT_LAYER)) f->put(int(vs.layer));
     if(vs.changed & (1<<VSLOT_ALPHA))
@@ -520,12 +636,12 @@ void savevslot(file_stream *f, VSlot &vs, int prev)
     }
     if(vs.changed & (1<<VSLOT_COLOR))
     {
-        loopk(3) f->put(float(vs.colorscale[k]));
+        f->put(vs.colorscale);
     }
     if(vs.changed & (1<<VSLOT_REFRACT))
     {
         f->put(float(vs.refractscale));
-        loopk(3) f->put(float(vs.refractcolor[k]));
+        f->put(vs.refractcolor);
     }
     if(vs.changed & (1<<VSLOT_DETAIL)) f->put(int(vs.detail));
 }
@@ -639,7 +755,10 @@ bool save_world(const char *mname, bool nolms)
     setmapfilenames(*mname ? mname : "untitled");
 		if (savebak)
 				backup(ogzname, bakname);
-		auto f = g_engine->get_file_system().open_gz(ogzname, octahedron::open_flags::INPUT | octahedron::open_flags::BINARY);
+		auto f = g_engine->get_file_system().open_gz(
+			ogzname,
+			octahedron::open_flags::OUTPUT | octahedron::open_flags::TRUNCATE | octahedron::open_flags::BINARY | octahedron::open_flags::PARALLEL
+		);
     if(!f) { conoutf(CON_WARN, "could not write map to %s", ogzname); return false; }
 
     int numvslots = vslots.length();
@@ -725,7 +844,9 @@ bool save_world(const char *mname, bool nolms)
     savevslots(f.get(), numvslots);
 
     renderprogress(0, "saving octree...");
-		savec(worldroot, ivec(0, 0, 0), worldsize >> 1, f.get(), nolms);
+    vector<mapchunk> chunks;
+		savec(worldroot, ivec(0, 0, 0), worldsize >> 1, f.get(), nolms, &chunks);
+    savechunks(f.get(), chunks, nolms);
 
     if(!nolms)
     {
@@ -748,8 +869,12 @@ bool load_world(const char *mname, const char *cname)        // still supports a
 
     int loadingstart = SDL_GetTicks();
     setmapfilenames(mname, cname);
-    auto f = g_engine->get_file_system().open_gz(ogzname, OpenFlags::INPUT | OpenFlags::BINARY);
-    if(!f) { conoutf(CON_ERROR, "could not read map %s", ogzname); return false; }
+    auto gz = g_engine->get_file_system().open_gz(ogzname, OpenFlags::INPUT | OpenFlags::BINARY | OpenFlags::MAPPED);
+    if(!gz) { conoutf(CON_ERROR, "could not read map %s", ogzname); return false; }
+    // inflating runs on a thread of its own, ahead of parsing
+    if(parallelload) gz = std::make_unique<octahedron::readahead_stream>(std::move(gz));
+    // the octree is read a few bytes at a time, keep those reads out of zlib
+    auto f = std::make_unique<buffered_stream>(std::move(gz));
 
     mapheader hdr;
     octaheader ohdr;
@@ -898,9 +1023,12 @@ bool load_world(const char *mname, const char *cname)        // still supports a
 
     renderprogress(0, "loading octree...");
     bool failed = false;
-		worldroot		= loadchildren(f.get(), ivec(0, 0, 0), hdr.worldsize >> 1, failed);
-    if(failed) conoutf(CON_ERROR, "garbage in map");
+    vector<mapchunk> chunks;
+		worldroot		= loadchildren(f.get(), ivec(0, 0, 0), hdr.worldsize >> 1, failed, hdr.version >= 2 ? &chunks : NULL);
+    chunkloader loader(chunks);
+    if(!failed && hdr.version >= 2 && !loader.read(f.get())) failed = true;
 
+    // the chunks are still leaves here, they are validated as they are decoded
     renderprogress(0, "validating...");
     validatec(worldroot, hdr.worldsize>>1);
 
@@ -927,6 +1055,9 @@ bool load_world(const char *mname, const char *cname)        // still supports a
 
     mapcrc = f->crc32();
 
+    if(!loader.finish()) failed = true;
+    if(failed) conoutf(CON_ERROR, "garbage in map");
+
     conoutf("read map %s (%.1f seconds)", ogzname, (SDL_GetTicks()-loadingstart)/1000.0f);
 
     clearmainmenu();
@@ -962,6 +1093,51 @@ void savemap(char *mname) { save_world(mname); }
 COMMAND(savemap, "s");
 COMMAND(savecurrentmap, "");
 
+// rewrites a map saved in an older format, the chunked octree being the main difference
+void convertmap(char *mname)
+{
+    if(multiplayer() || !load_world(mname)) return;
+    save_world(mname);
+}
+
+COMMAND(convertmap, "s");
+
+// loads a map fully serially then with the loading pipeline, parallel va building and parallel merging on,
+// and reports the best wall time of each
+static void loadbench(char *mname, int *runs)
+{
+    if(multiplayer()) return;
+    string name;
+    copystring(name, mname[0] ? mname : game::getclientmap());
+    if(!name[0]) { conoutf(CON_ERROR, "no map to load"); return; }
+    int oldparallelload = parallelload, oldparallelva = parallelva, oldparallelmerge = parallelmerge;
+    double millis[2] = { 1e30, 1e30 };
+    bool loaded = true;
+    loopi(2)
+    {
+        parallelload = parallelva = parallelmerge = i;
+        loopj(max(*runs, 1))
+        {
+            auto start = std::chrono::steady_clock::now();
+            loaded = load_world(name);
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if(!loaded) break;
+            millis[i] = min(millis[i], elapsed);
+        }
+        if(!loaded) break;
+    }
+    parallelload = oldparallelload;
+    parallelva = oldparallelva;
+    parallelmerge = oldparallelmerge;
+    if(!loaded) return;
+    // the job system's workers and this thread, plus the readahead thread inflating the map
+    int threads = int(g_engine->get_job_system().thread_count()) + 1;
+    conoutf("loaded %s: %.1fms serial, %.1fms pipelined on %d threads + readahead (%.2fx)",
+        name, millis[0], millis[1], threads, millis[0]/max(millis[1], 1e-3));
+}
+
+COMMAND(loadbench, "si");
+
 void writeobj(char *name)
 {
     defformatstring(fname, "%s.obj", name);
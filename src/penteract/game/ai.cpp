@@ -258,7 +258,7 @@ namespace ai
 
         while(!candidates.empty())
         {
-            int w = rnd(candidates.length()), n = candidates.removeunordered(w);
+            int w = octahedron::thread_random().below(candidates.length()), n = candidates.removeunordered(w);
             if(n != d->lastnode && !d->ai->hasprevnode(n) && !obstacles.find(n, d) && makeroute(d, b, n)) return true;
         }
         return false;
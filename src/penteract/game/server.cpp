@@ -1151,10 +1151,16 @@ namespace server
         return buf;
     }
 
+    std::unique_ptr<octahedron::file_stream> opendemo(const char *file)
+    {
+        using octahedron::open_flags;
+
+        return g_engine->get_file_system().open_gz(file, open_flags::INPUT | open_flags::BINARY);
+    }
+
     void setupdemoplayback()
     {
-        octahedron::log(octahedron::log_level::ERROR, "server::setupdemoplayback() NYI");
-        /*if(demoplayback) return;
+        if(demoplayback) return;
         demoheader hdr;
         string msg;
         msg[0] = '\0';
@@ -1162,10 +1168,10 @@ namespace server
         copystring(file, smapname);
         int len = strlen(file);
         if(len < 4 || strcasecmp(&file[len-4], ".dmo")) concatstring(file, ".dmo");
-        if(const char *buf = getdemofile(file, false)) demoplayback = opengzfile(buf, "rb");
-        if(!demoplayback) demoplayback = opengzfile(file, "rb");
+        if(const char *buf = getdemofile(file, false)) demoplayback = opendemo(buf);
+        if(!demoplayback) demoplayback = opendemo(file);
         if(!demoplayback) formatstring(msg, "could not read demo \"%s\"", file);
-        else if(demoplayback->read(&hdr, sizeof(demoheader))!=sizeof(demoheader) || memcmp(hdr.magic, DEMO_MAGIC, sizeof(hdr.magic)))
+        else if(demoplayback->read(std::as_writable_bytes(std::span{&hdr, 1}))!=sizeof(demoheader) || memcmp(hdr.magic, DEMO_MAGIC, sizeof(hdr.magic)))
             formatstring(msg, "\"%s\" is not a demo file", file);
         else
         {
@@ -1184,12 +1190,11 @@ namespace server
 
         sendf(-1, 1, "ri3", N_DEMOPLAYBACK, 1, -1);
 
-        if(demoplayback->read(&nextplayback, sizeof(nextplayback))!=sizeof(nextplayback))
+        if(!demoplayback->get<octahedron::endianness::little>(nextplayback))
         {
             enddemoplayback();
             return;
         }
-        lilswap(&nextplayback, 1);*/
     }
 
     void readdemo()
@@ -1198,14 +1203,11 @@ namespace server
         while(gamemillis>=nextplayback)
         {
             int chan, len;
-            if(demoplayback->read(&chan, sizeof(chan))!=sizeof(chan) ||
-               demoplayback->read(&len, sizeof(len))!=sizeof(len))
+            if(!demoplayback->getAll<octahedron::endianness::little>(chan, len))
             {
                 enddemoplayback();
                 return;
             }
-            lilswap(&chan, 1);
-            lilswap(&len, 1);
             ENetPacket *packet = enet_packet_create(NULL, len+1, 0);
             if(!packet || demoplayback->read(packet->data+1, len)!=size_t(len))
             {
@@ -1217,12 +1219,11 @@ namespace server
             sendpacket(-1, chan, packet);
             if(!packet->referenceCount) enet_packet_destroy(packet);
             if(!demoplayback) break;
-            if(demoplayback->read(&nextplayback, sizeof(nextplayback))!=sizeof(nextplayback))
+            if(!demoplayback->get<octahedron::endianness::little>(nextplayback))
             {
                 enddemoplayback();
                 return;
             }
-            lilswap(&nextplayback, 1);
         }
     }
 
@@ -2884,6 +2885,7 @@ namespace server
     void parsepacket(int sender, int chan, packetbuf &p)     // has to parse exactly each byte of the packet
     {
         if(sender<0 || p.packet->flags&ENET_PACKET_FLAG_UNSEQUENCED || chan > 2) return;
+        g_engine->binary_log<"net: {} bytes from client {} on channel {}">(octahedron::log_level::TRACE, p.maxlen, sender, chan);
         char text[MAXTRANS];
 				netmsg			type;
         clientinfo *ci = sender>=0 ? getinfo(sender) : NULL, *cq = ci, *cm = ci;
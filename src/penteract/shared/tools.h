@@ -1254,6 +1254,9 @@ template <class T, int SIZE> struct reversequeue : queue<T, SIZE>
     const T &operator[](int offset) const { return queue<T, SIZE>::added(offset); }
 };
 
+#include "io/byteswap.h"
+#include "tools/random.h"
+
 static inline bool islittleendian() { union { int i; uchar b[sizeof(int)]; } conv; conv.i = 1; return conv.b[0] != 0; }
 #ifdef SDL_BYTEORDER
 #define endianswap16 SDL_Swap16
@@ -1272,7 +1275,12 @@ template<> inline int endianswap<int>(int n) { return endianswap32(n); }
 template<> inline ullong endianswap<ullong>(ullong n) { return endianswap64(n); }
 template<> inline llong endianswap<llong>(llong n) { return endianswap64(n); }
 template<> inline double endianswap<double>(double n) { union { double t; uint i; } conv; conv.t = n; conv.i = endianswap64(conv.i); return conv.t; }
-template<class T> inline void endianswap(T *buf, size_t len) { for(T *end = &buf[len]; buf < end; buf++) *buf = endianswap(*buf); }
+template<class T> inline void endianswap(T *buf, size_t len)
+{
+    // whole arrays of numbers go through the vectorized kernels
+    if constexpr(std::is_arithmetic_v<T>) octahedron::byteswap_values(buf, buf, len, sizeof(T));
+    else for(T *end = &buf[len]; buf < end; buf++) *buf = endianswap(*buf);
+}
 template<class T> inline T endiansame(T n) { return n; }
 template<class T> inline void endiansame(T *buf, size_t len) {}
 #ifdef SDL_BYTEORDER
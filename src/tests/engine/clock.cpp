@@ -0,0 +1,74 @@
+#include "engine/engine.h"
+#include "tests.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <engine/clock.h>
+
+#include <fmt/chrono.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+struct jitter {
+	std::vector<octahedron::nanoseconds> overshoots;
+
+	octahedron::nanoseconds percentile(size_t p) const {
+		return (overshoots[std::min(overshoots.size() - 1, overshoots.size() * p / 100)]);
+	}
+};
+
+jitter measure_jitter(octahedron::game_clock &clock, octahedron::microseconds period, int ticks) {
+	jitter ret;
+
+	ret.overshoots.reserve(ticks);
+	clock.update();
+	for (int i = 0; i < ticks; ++i) {
+		auto deadline = clock.get_last_tick().time + period;
+
+		clock.update(period);
+		ret.overshoots.push_back(clock.get_last_tick().time - deadline);
+	}
+	std::ranges::sort(ret.overshoots);
+	return (ret);
+}
+} // namespace
+
+[[maybe_unused]] test &clock_pacing_test = g_engine_tests.make_test("clock pacing", "Tick jitter of precise frame pacing", [](test& self) {
+	using octahedron::nanoseconds;
+
+	constexpr int                     ticks = 2000;
+	constexpr octahedron::microseconds period{500};
+
+	octahedron::game_clock clock{octahedron::pacing::PRECISE};
+	jitter                 precise = measure_jitter(clock, period, ticks);
+	const auto            &stats = clock.get_pacing_stats();
+
+	if (precise.overshoots.front() < nanoseconds::zero())
+		self.fail(fmt::format("tick ended {} early", -precise.overshoots.front()));
+	// a tick only waits if the caller came back before its deadline, which a preempted test thread may not
+	if (stats.paced_ticks > ticks || stats.paced_ticks < ticks * 9 / 10)
+		self.fail(fmt::format("{} paced ticks recorded out of {}", stats.paced_ticks, ticks));
+	// ticks which came back late did not wait, they are measured here but not in the statistics
+	if (stats.max_overshoot > precise.overshoots.back() || (stats.paced_ticks == ticks && stats.max_overshoot != precise.overshoots.back()))
+		self.fail(fmt::format("max overshoot is {} instead of {}", stats.max_overshoot, precise.overshoots.back()));
+	if (stats.mean_overshoot() > stats.max_overshoot || stats.last_overshoot > stats.max_overshoot)
+		self.fail("inconsistent pacing statistics");
+
+	clock.set_pacing(octahedron::pacing::SLEEP);
+	clock.reset_pacing_stats();
+	if (clock.get_pacing_stats().paced_ticks != 0)
+		self.fail("pacing statistics were not reset");
+
+	jitter sleep = measure_jitter(clock, period, ticks / 4);
+
+	// how late the ticks are depends on the machine and its load, so it is only logged, the "clock precise pacing" benchmark tracks it
+	self.log(
+		"sleep granularity {}, overshoot p50/p99/max: precise {}/{}/{}, sleep {}/{}/{}",
+		octahedron::sleep_granularity(),
+		precise.percentile(50), precise.percentile(99), precise.overshoots.back(),
+		sleep.percentile(50), sleep.percentile(99), sleep.overshoots.back()
+	);
+}).set_exclusive();
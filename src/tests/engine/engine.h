@@ -0,0 +1,12 @@
+#ifndef OCTAHEDRON_TESTS_ENGINE_H_
+#define OCTAHEDRON_TESTS_ENGINE_H_
+
+#include "tests.h"
+
+namespace octahedron::tests {
+
+inline test_suite& g_engine_tests = make_test_suite("Engine");
+
+}
+
+#endif
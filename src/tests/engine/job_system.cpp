@@ -0,0 +1,137 @@
+#include "engine/engine.h"
+#include "tests.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <engine/job_system.h>
+
+using namespace octahedron::tests;
+
+[[maybe_unused]] test &job_system_test = g_engine_tests.make_test("job_system", "Submitting and waiting on jobs", [](test& self) {
+	octahedron::job_system jobs{3};
+	std::atomic<int>       count{0};
+	std::vector<octahedron::job> handles;
+
+	for (int i = 0; i < 1000; ++i)
+		handles.push_back(jobs.submit([&count]() { count.fetch_add(1, std::memory_order::relaxed); }));
+	jobs.wait(handles);
+	if (count != 1000)
+		self.fail(fmt::format("{} jobs ran instead of 1000", count.load()));
+	for (const auto &j : handles) {
+		if (!j.done()) {
+			self.fail("waited job is not done");
+			break;
+		}
+	}
+
+	// a job waiting on jobs it spawned helps run them instead of blocking a worker
+	std::atomic<int> nested{0};
+	std::vector<octahedron::job> outer;
+
+	for (int i = 0; i < 16; ++i) {
+		outer.push_back(jobs.submit([&jobs, &nested]() {
+			std::vector<octahedron::job> inner;
+
+			for (int k = 0; k < 16; ++k)
+				inner.push_back(jobs.submit([&nested]() { nested.fetch_add(1, std::memory_order::relaxed); }));
+			jobs.wait(inner);
+		}));
+	}
+	jobs.wait(outer);
+	if (nested != 256)
+		self.fail(fmt::format("{} nested jobs ran instead of 256", nested.load()));
+
+	auto failing = jobs.submit([]() { throw std::runtime_error{"job failure"}; });
+
+	try {
+		jobs.wait(failing);
+		self.fail("exception thrown by a job was not rethrown");
+	} catch (const std::runtime_error &e) {
+		if (std::string_view{e.what()} != "job failure")
+			self.fail("wrong exception rethrown");
+	}
+});
+
+[[maybe_unused]] test &job_system_dependencies_test = g_engine_tests.make_test("job_system dependencies", "Jobs running after their dependencies", [](test& self) {
+	octahedron::job_system jobs{2};
+
+	for (int round = 0; round < 50; ++round) {
+		std::atomic<int> stage{0};
+		std::atomic<bool> ordered{true};
+
+		auto first = jobs.submit([&stage]() { stage.store(1); });
+		auto second = jobs.submit([&stage]() { stage.fetch_add(0); });
+		auto third = jobs.submit_after({first, second}, [&stage, &ordered]() {
+			if (stage.load() != 1)
+				ordered = false;
+			stage.store(2);
+		});
+		auto fourth = jobs.submit_after({third}, [&stage, &ordered]() {
+			if (stage.load() != 2)
+				ordered = false;
+			stage.store(3);
+		});
+
+		jobs.wait(fourth);
+		if (!ordered || stage != 3) {
+			self.fail(fmt::format("dependencies ran out of order in round {}", round));
+			return;
+		}
+	}
+
+	// dependencies already done, or invalid, do not hold the job back
+	auto done = jobs.submit([]() {});
+
+	jobs.wait(done);
+
+	bool ran = false;
+
+	jobs.wait(jobs.submit_after({done, octahedron::job{}}, [&ran]() { ran = true; }));
+	if (!ran)
+		self.fail("job with finished dependencies did not run");
+});
+
+[[maybe_unused]] test &job_system_parallel_for_test = g_engine_tests.make_test("job_system parallel_for", "Splitting index ranges across workers", [](test& self) {
+	octahedron::job_system jobs{3};
+	std::vector<octahedron::uint64> values(100000);
+
+	std::iota(values.begin(), values.end(), octahedron::uint64{0});
+
+	std::vector<octahedron::uint64> squares(values.size());
+
+	jobs.parallel_for(0, values.size(), [&](size_t i) { squares[i] = values[i] * values[i]; });
+	for (size_t i = 0; i < values.size(); ++i) {
+		if (squares[i] != values[i] * values[i]) {
+			self.fail(fmt::format("index {} was not processed", i));
+			break;
+		}
+	}
+
+	std::atomic<octahedron::uint64> sum{0};
+	std::atomic<size_t>             chunks{0};
+
+	jobs.parallel_for(10, values.size(), [&](size_t begin, size_t end) {
+		octahedron::uint64 local = 0;
+
+		for (size_t i = begin; i < end; ++i)
+			local += values[i];
+		sum.fetch_add(local, std::memory_order::relaxed);
+		chunks.fetch_add(1, std::memory_order::relaxed);
+	}, 30000);
+
+	octahedron::uint64 expected = std::accumulate(values.begin() + 10, values.end(), octahedron::uint64{0});
+
+	if (sum != expected)
+		self.fail(fmt::format("range sum is {} instead of {}", sum.load(), expected));
+	if (chunks > 4)
+		self.fail(fmt::format("grain was ignored, {} chunks", chunks.load()));
+
+	size_t calls = 0;
+
+	jobs.parallel_for(5, 5, [&calls](size_t) { ++calls; });
+	if (calls != 0)
+		self.fail("empty range called the function");
+});
@@ -0,0 +1,167 @@
+#include "engine/engine.h"
+#include "io/io.h"
+#include "tests.h"
+
+#include <thread>
+#include <vector>
+
+#include <engine/profiler.h>
+#include <io/file_stream.h>
+#include <io/file_system.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+void busy_wait(octahedron::microseconds duration) {
+	auto end = std::chrono::steady_clock::now() + duration;
+
+	while (std::chrono::steady_clock::now() < end)
+		;
+}
+
+const octahedron::profiler::zone_stats *find_zone(const std::vector<octahedron::profiler::zone_stats> &stats, std::string_view name) {
+	for (const auto &zone : stats) {
+		if (zone.name == name)
+			return (&zone);
+	}
+	return (nullptr);
+}
+} // namespace
+
+[[maybe_unused]] test &profiler_test = g_engine_tests.make_test("profiler", "Per-frame zone statistics", [](test& self) {
+	using octahedron::microseconds;
+
+	constexpr int frames = 20;
+
+	octahedron::profiler prof;
+
+	{
+		auto zone = prof.zone<"disabled zone">();
+	}
+	prof.end_frame();
+	if (!prof.get_stats().empty())
+		self.fail("disabled profiler recorded zones");
+
+	prof.set_enabled(true);
+	for (int frame = 0; frame < frames; ++frame) {
+		std::jthread worker{[&prof]() {
+			auto zone = prof.zone<"physics">();
+
+			busy_wait(microseconds{200});
+		}};
+
+		{
+			auto zone = prof.zone<"world render">();
+
+			busy_wait(microseconds{100});
+			// two occurrences in the frame add up
+			{
+				auto nested = prof.zone<"script">();
+
+				busy_wait(microseconds{50});
+			}
+			{
+				auto nested = prof.zone<"script">();
+
+				busy_wait(microseconds{50});
+			}
+		}
+		worker.join();
+		prof.end_frame();
+	}
+
+	auto stats = prof.get_stats();
+
+	for (std::string_view name : {"frame", "world render", "physics", "script"}) {
+		const auto *zone = find_zone(stats, name);
+
+		if (!zone) {
+			self.fail(fmt::format("no statistics for zone {}", name));
+			continue;
+		}
+		if (zone->frames != frames)
+			self.fail(fmt::format("zone {} seen in {} frames instead of {}", name, zone->frames, frames));
+		if (zone->p50 > zone->p99 || zone->p99 > zone->max)
+			self.fail(fmt::format("zone {} has inconsistent percentiles", name));
+	}
+	if (find_zone(stats, "disabled zone"))
+		self.fail("zone recorded while disabled appears in the statistics");
+	if (const auto *script = find_zone(stats, "script"); script && script->p50 < microseconds{100})
+		self.fail("occurrences of a zone in a frame were not added up");
+	if (const auto *render = find_zone(stats, "world render"); render && render->p50 < microseconds{200})
+		self.fail("world render zone is too short");
+	if (prof.dropped() != 0)
+		self.fail("zones were dropped");
+
+	for (size_t i = 0; i < octahedron::profiler::thread_capacity + 10; ++i)
+		auto zone = prof.zone<"overflow">();
+	if (prof.dropped() != 10)
+		self.fail(fmt::format("{} zones dropped instead of 10", prof.dropped()));
+	prof.end_frame();
+});
+
+[[maybe_unused]] test &profiler_trace_test = g_engine_tests.make_test("profiler trace", "Chrome trace export of captured zones", [](test& self) {
+	using octahedron::open_flags;
+
+	temp_dir                dir{"profiler_trace"};
+	octahedron::file_system fs;
+	octahedron::profiler    prof;
+
+	fs.set_home_dir(dir.path.string());
+	prof.set_enabled(true);
+	prof.start_capture();
+	for (int frame = 0; frame < 3; ++frame) {
+		{
+			auto zone = prof.zone<"network">();
+		}
+		{
+			auto zone = prof.zone<"quoted \"zone\"">();
+		}
+		prof.end_frame();
+	}
+	prof.stop_capture();
+	{
+		auto zone = prof.zone<"network">();
+	}
+	prof.end_frame();
+
+	{
+		auto out = fs.open("trace.json", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+		if (!out || !prof.write_chrome_trace(*out)) {
+			self.fail("failed to write the trace");
+			return;
+		}
+	}
+
+	auto in = fs.open("trace.json", open_flags::INPUT | open_flags::BINARY);
+
+	if (!in) {
+		self.fail("failed to open the trace");
+		return;
+	}
+
+	std::string json(in->size(), '\0');
+
+	in->read(std::as_writable_bytes(std::span{json}));
+
+	auto count = [&json](std::string_view str) {
+		size_t n = 0;
+
+		for (size_t pos = json.find(str); pos != std::string::npos; pos = json.find(str, pos + 1))
+			++n;
+		return (n);
+	};
+
+	if (!json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") || !json.ends_with("]}\n"))
+		self.fail("malformed trace");
+	if (count("\"name\":\"network\"") != 3)
+		self.fail(fmt::format("{} network zones in the trace instead of 3", count("\"name\":\"network\"")));
+	if (count("\"name\":\"frame\"") != 3)
+		self.fail("frames missing from the trace");
+	if (count("\"name\":\"quoted \\\"zone\\\"\"") != 3)
+		self.fail("zone names are not escaped");
+	if (count("\"ph\":\"X\"") != 9)
+		self.fail("unexpected number of trace events");
+});
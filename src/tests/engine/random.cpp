@@ -0,0 +1,169 @@
+#include "engine/engine.h"
+#include "tests.h"
+
+#include <array>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <tools/random.h>
+
+using namespace octahedron::tests;
+
+[[maybe_unused]] test &random_stream_test = g_engine_tests.make_test("random_stream", "Sequences of bulk random generation", [](test& self) {
+	using octahedron::random_stream;
+	using octahedron::uint64;
+
+	std::vector<uint64> expected(37);
+	random_stream       a{42};
+
+	a.generate(std::span{expected});
+
+	// the sequence does not depend on how it is drawn
+	random_stream       b{42};
+	std::vector<uint64> mixed;
+
+	for (int i = 0; i < 3; ++i)
+		mixed.push_back(b());
+	for (size_t n : {10, 1, 19}) {
+		size_t size = mixed.size();
+
+		mixed.resize(size + n);
+		b.generate(std::span{mixed}.subspan(size));
+		if (mixed.size() < expected.size() - 4)
+			mixed.push_back(b());
+	}
+	while (mixed.size() < expected.size())
+		mixed.push_back(b());
+	if (mixed != expected)
+		self.fail("interleaving single values and spans changed the sequence");
+
+	random_stream       other_seed{43};
+	random_stream       other_stream{42, 1};
+	std::vector<uint64> values(expected.size());
+
+	other_seed.generate(std::span{values});
+	if (values == expected)
+		self.fail("different seeds give the same sequence");
+	other_stream.generate(std::span{values});
+	if (values == expected)
+		self.fail("different streams give the same sequence");
+
+	std::vector<octahedron::uint32> halves(expected.size());
+	random_stream                   c{42};
+
+	c.generate(std::span{halves});
+	for (size_t i = 0; i < halves.size(); ++i) {
+		if (halves[i] != static_cast<octahedron::uint32>(expected[i] >> 32)) {
+			self.fail("32-bit values are not the high halves of the sequence");
+			break;
+		}
+	}
+
+	octahedron::seed_random_streams(1234);
+
+	random_stream &mine = octahedron::thread_random();
+	random_stream  reference{1234, 0};
+	uint64         theirs = 0;
+
+	if (mine() != reference())
+		self.fail("first thread to ask after seeding did not get stream 0");
+	std::jthread{[&theirs]() { theirs = octahedron::thread_random()(); }}.join();
+	if (theirs == random_stream{1234, 0}())
+		self.fail("two threads share a stream");
+	if (theirs != random_stream{1234, 1}())
+		self.fail("second thread did not get stream 1");
+}).set_exclusive();
+
+[[maybe_unused]] test &random_stream_statistics_test = g_engine_tests.make_test("random statistics", "Statistical sanity of bulk random generation", [](test& self) {
+	constexpr size_t count = 1 << 16;
+
+	octahedron::random_stream rng{7};
+
+	{
+		std::vector<octahedron::uint32> values(count);
+		std::array<size_t, 32>          bits{};
+
+		rng.generate(std::span{values});
+		for (octahedron::uint32 value : values) {
+			for (int b = 0; b < 32; ++b)
+				bits[b] += (value >> b) & 1;
+		}
+		// 1% is more than 5 standard deviations for 65536 samples
+		for (int b = 0; b < 32; ++b) {
+			double ratio = static_cast<double>(bits[b]) / count;
+
+			if (std::abs(ratio - 0.5) > 0.01)
+				self.fail(fmt::format("bit {} set in {:.2f}% of the values", b, ratio * 100));
+		}
+	}
+	{
+		constexpr octahedron::uint32 buckets = 16;
+
+		std::vector<octahedron::uint32> values(count);
+		std::array<double, buckets>     histogram{};
+
+		rng.generate_below(std::span{values}, buckets);
+		for (octahedron::uint32 value : values) {
+			if (value >= buckets) {
+				self.fail(fmt::format("{} is out of bounds", value));
+				return;
+			}
+			++histogram[value];
+		}
+
+		double expected = static_cast<double>(count) / buckets;
+		double chi2 = 0;
+
+		for (double n : histogram)
+			chi2 += (n - expected) * (n - expected) / expected;
+		// p = 0.001 for 15 degrees of freedom
+		if (chi2 > 37.7)
+			self.fail(fmt::format("chi-squared of {:.1f} over {} buckets", chi2, buckets));
+	}
+	{
+		std::vector<float> values(count);
+		double             sum = 0;
+		double             sum_squares = 0;
+
+		rng.generate_floats(std::span{values});
+		for (float value : values) {
+			if (value < 0.0f || value >= 1.0f) {
+				self.fail(fmt::format("float {} is out of [0, 1)", value));
+				return;
+			}
+			sum += value;
+			sum_squares += value * value;
+		}
+
+		double mean = sum / count;
+		double variance = sum_squares / count - mean * mean;
+
+		if (std::abs(mean - 0.5) > 0.01 || std::abs(variance - 1.0 / 12) > 0.01)
+			self.fail(fmt::format("floats have a mean of {:.4f} and a variance of {:.4f}", mean, variance));
+	}
+	{
+		std::vector<std::array<float, 3>> vectors(count);
+		std::array<double, 3>             sum{};
+		std::array<double, 3>             sum_squares{};
+
+		rng.generate_unit_vectors(std::span{vectors});
+		for (const auto &v : vectors) {
+			float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+			if (std::abs(length - 1.0f) > 1e-5f) {
+				self.fail(fmt::format("vector of length {}", length));
+				return;
+			}
+			for (int i = 0; i < 3; ++i) {
+				sum[i] += v[i];
+				sum_squares[i] += v[i] * v[i];
+			}
+		}
+		// on a uniform sphere every coordinate has a mean of 0 and a mean square of 1/3
+		for (int i = 0; i < 3; ++i) {
+			if (std::abs(sum[i] / count) > 0.01 || std::abs(sum_squares[i] / count - 1.0 / 3) > 0.01)
+				self.fail(fmt::format("coordinate {} of unit vectors is biased", i));
+		}
+	}
+});
@@ -0,0 +1,120 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <coroutine>
+
+#include <io/async_file_system.h>
+#include <io/file_stream.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+// fire-and-forget coroutine, enough to co_await in a test
+struct detached_task {
+	struct promise_type {
+		detached_task get_return_object() noexcept {
+			return {};
+		}
+
+		std::suspend_never initial_suspend() noexcept {
+			return {};
+		}
+
+		std::suspend_never final_suspend() noexcept {
+			return {};
+		}
+
+		void return_void() noexcept {}
+
+		void unhandled_exception() noexcept {
+			std::terminate();
+		}
+	};
+};
+
+std::vector<std::byte> make_file_data(size_t i) {
+	return (std::vector<std::byte>(1000 * i + 1, static_cast<std::byte>(i)));
+}
+
+bool write_files(octahedron::file_system &fs, size_t count) {
+	using octahedron::open_flags;
+
+	for (size_t i = 0; i < count; ++i) {
+		auto f = fs.open(fmt::format("file{}.bin", i), open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+		auto data = make_file_data(i);
+
+		if (!f || f->write(data) != data.size())
+			return (false);
+	}
+	return (true);
+}
+} // namespace
+
+[[maybe_unused]] test &async_read_test = g_io_tests.make_test("async_read", "Asynchronous whole-file reads", [](test& self) {
+	constexpr size_t        file_count = 32;
+	temp_dir                dir{"async_read"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_files(fs, file_count)) {
+		self.fail("failed to write test files");
+		return;
+	}
+
+	octahedron::async_file_system                                                 afs{fs, 3};
+	std::vector<octahedron::async_result<octahedron::async_file_system::bytes>> results;
+
+	for (size_t i = 0; i < file_count; ++i)
+		results.push_back(afs.read(fmt::format("file{}.bin", i)));
+	for (size_t i = 0; i < file_count; ++i) {
+		auto data = results[i].get();
+
+		if (!data || *data != make_file_data(i))
+			self.fail(fmt::format("file{}.bin: wrong contents", i));
+	}
+	if (afs.read("does_not_exist.bin").get())
+		self.fail("reading a missing file did not fail");
+
+	auto stream = afs.open("file3.bin", octahedron::open_flags::INPUT | octahedron::open_flags::BINARY).get();
+
+	if (!stream || stream->size() != make_file_data(3).size())
+		self.fail("async open returned a bad stream");
+
+	// creating folders below a file throws on the pool, which must reach get() rather than terminate
+	try {
+		if (afs.open("file0.bin/sub/out.bin", octahedron::open_flags::OUTPUT | octahedron::open_flags::TRUNCATE | octahedron::open_flags::BINARY).get())
+			self.fail("opening a file below another file did not fail");
+	} catch (const std::exception &) {
+	}
+});
+
+[[maybe_unused]] test &async_await_test = g_io_tests.make_test("async_await", "co_await on asynchronous reads", [](test& self) {
+	constexpr size_t        file_count = 16;
+	temp_dir                dir{"async_await"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	if (!write_files(fs, file_count)) {
+		self.fail("failed to write test files");
+		return;
+	}
+
+	std::atomic<size_t> matched{0};
+
+	{
+		octahedron::async_file_system afs{fs, 2};
+		auto                          reader = [&](size_t i) -> detached_task {
+			auto data = co_await afs.read(fmt::format("file{}.bin", i));
+
+			if (data && *data == make_file_data(i))
+				++matched;
+		};
+
+		for (size_t i = 0; i < file_count; ++i)
+			reader(i);
+		afs.wait_idle();
+	}
+	if (matched != file_count)
+		self.fail(fmt::format("{} out of {} awaited reads returned the right data", matched.load(), file_count));
+});
@@ -0,0 +1,123 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <io/async_logger.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+using string_logger = octahedron::logger<std::ostringstream>;
+
+std::vector<std::string> split_lines(const std::string &str) {
+	std::vector<std::string> ret;
+	std::istringstream       in{str};
+
+	for (std::string line; std::getline(in, line);)
+		ret.push_back(std::move(line));
+	return (ret);
+}
+
+template <typename Logger>
+std::vector<std::string> get_lines(Logger &logger) {
+	return (logger.with_sink([](string_logger &sink) { return (split_lines(sink.target.str())); }));
+}
+} // namespace
+
+[[maybe_unused]] test &async_logger_test = g_io_tests.make_test("async_logger", "Logging through a background writer", [](test& self) {
+	constexpr size_t threads = 4;
+	constexpr size_t per_thread = 5000;
+
+	octahedron::async_logger<string_logger, octahedron::log_overflow::BLOCK, 64> logger{string_logger{std::ostringstream{}}};
+
+	logger.prefix_generator = [](octahedron::log_level, std::string_view) { return (std::string{"> "}); };
+	{
+		std::vector<std::jthread> workers;
+
+		for (size_t t = 0; t < threads; ++t) {
+			workers.emplace_back([&logger, t]() {
+				for (size_t i = 0; i < per_thread; ++i)
+					logger.log(octahedron::log_level::INFO, "{} {}", t, i);
+			});
+		}
+	}
+	logger.flush();
+
+	auto                        lines = get_lines(logger);
+	std::array<size_t, threads> expected{};
+
+	if (lines.size() != threads * per_thread) {
+		self.fail(fmt::format("{} lines written instead of {}", lines.size(), threads * per_thread));
+		return;
+	}
+	for (const auto &line : lines) {
+		size_t t;
+		size_t i;
+
+		if (std::sscanf(line.c_str(), "> %zu %zu", &t, &i) != 2 || t >= threads || i != expected[t]) {
+			self.fail(fmt::format("unexpected line \"{}\"", line));
+			return;
+		}
+		++expected[t];
+	}
+	if (logger.dropped() != 0)
+		self.fail("lines dropped with the BLOCK policy");
+
+	std::string long_line(1000, 'x');
+
+	logger.log(octahedron::log_level::INFO, long_line);
+	logger.flush();
+	lines = get_lines(logger);
+	if (lines.back() != "> " + long_line)
+		self.fail(fmt::format("long line written as {} characters instead of {}", lines.back().size(), long_line.size() + 2));
+});
+
+[[maybe_unused]] test &async_logger_overflow_test = g_io_tests.make_test("async_logger overflow", "DROP and OVERWRITE policies of the async logger", [](test& self) {
+	constexpr size_t count = 200;
+
+	{
+		octahedron::async_logger<string_logger, octahedron::log_overflow::DROP, 16> logger{string_logger{std::ostringstream{}}};
+
+		// holding the sink keeps the writer thread from draining the ring
+		logger.with_sink([&](string_logger &) {
+			for (size_t i = 0; i < count; ++i)
+				logger.log(octahedron::log_level::INFO, "{}", i);
+		});
+		logger.flush();
+
+		auto lines = get_lines(logger);
+
+		if (logger.dropped() == 0 || lines.size() + logger.dropped() != count)
+			self.fail(fmt::format("DROP: {} lines written and {} dropped out of {}", lines.size(), logger.dropped(), count));
+		if (lines.empty() || lines.front() != "0")
+			self.fail("DROP: first line was not kept");
+	}
+	{
+		octahedron::async_logger<string_logger, octahedron::log_overflow::OVERWRITE, 16> logger{string_logger{std::ostringstream{}}};
+		// every third line is too long for a record, overwriting it must also discard its spilled text
+		auto line = [](size_t i) { return (i % 3 == 0 ? fmt::format("{} {}", i, std::string(300, 'x')) : std::to_string(i)); };
+
+		logger.with_sink([&](string_logger &) {
+			for (size_t i = 0; i < count; ++i)
+				logger.log(octahedron::log_level::INFO, line(i));
+		});
+		logger.flush();
+
+		auto lines = get_lines(logger);
+
+		if (logger.dropped() == 0 || lines.size() + logger.dropped() != count)
+			self.fail(fmt::format("OVERWRITE: {} lines written and {} dropped out of {}", lines.size(), logger.dropped(), count));
+		if (lines.size() < 16 || lines.back() != line(count - 1) || lines[lines.size() - 16] != line(count - 16))
+			self.fail("OVERWRITE: last lines were not kept");
+		for (size_t i = 0; i < lines.size(); ++i) {
+			if (lines[i] != line(count - lines.size() + i)) {
+				self.fail(fmt::format("OVERWRITE: line {} is \"{:.20}\"", i, lines[i]));
+				break;
+			}
+		}
+	}
+});
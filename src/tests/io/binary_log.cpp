@@ -0,0 +1,189 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <array>
+#include <thread>
+#include <vector>
+
+#include <io/binary_log.h>
+#include <io/file_stream.h>
+#include <io/file_system.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+enum class color : octahedron::uint8 {
+	RED = 1,
+	BLUE = 2
+};
+} // namespace
+
+[[maybe_unused]] test &binary_log_test = g_io_tests.make_test("binary_log", "Deferred-formatting binary log records", [](test& self) {
+	using octahedron::log_level;
+	using octahedron::open_flags;
+
+	temp_dir                dir{"binary_log"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+
+	std::vector<std::string> expected;
+
+	{
+		// a small buffer forces records to be flushed in the middle of the test
+		octahedron::binary_logger logger{fs.open("log.bin", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY), 64};
+		std::string               name{"octahedron"};
+		int                       calls = 0;
+
+		logger.log<"int {} uint {} short {} char {} bool {}">(log_level::INFO, -42, 42u, octahedron::int16{-7}, 'x', true);
+		expected.push_back("int -42 uint 42 short -7 char x bool true");
+		logger.log<"float {:.2f} double {:.3f}">(log_level::DEBUG, 1.5f, 2.25);
+		expected.push_back("float 1.50 double 2.250");
+		logger.log<"{} is {} characters long, color {}">(log_level::INFO, name, name.size(), color::BLUE);
+		expected.push_back("octahedron is 10 characters long, color 2");
+		logger.log<"literal {}, view {}">(log_level::WARN, "abc", std::string_view{"def"});
+		expected.push_back("literal abc, view def");
+		logger.log<"lazy {}">(log_level::INFO, [&calls]() { return (++calls); });
+		expected.push_back("lazy 1");
+		logger.write(log_level::ERROR, std::string(200, 'z'));
+		expected.push_back(std::string(200, 'z'));
+		for (int i = 0; i < 100; ++i) {
+			logger.log<"int {} uint {} short {} char {} bool {}">(log_level::INFO, i, 42u, octahedron::int16{-7}, 'x', false);
+			expected.push_back(fmt::format("int {} uint 42 short -7 char x bool false", i));
+		}
+		logger.level = log_level::WARN | log_level::ERROR;
+		logger.log<"filtered {}">(log_level::INFO, [&calls]() { return (++calls); });
+		if (calls != 1)
+			self.fail("argument of a filtered line was evaluated");
+	}
+
+	auto in = fs.open("log.bin", open_flags::INPUT | open_flags::BINARY);
+
+	if (!in) {
+		self.fail("failed to open the log");
+		return;
+	}
+
+	octahedron::binary_log_reader reader{*in};
+	size_t                        count = 0;
+	std::chrono::nanoseconds      last_time{0};
+
+	if (!reader.valid())
+		self.fail("bad log header");
+	while (auto line = reader.next()) {
+		if (count >= expected.size()) {
+			self.fail(fmt::format("unexpected line \"{}\"", line->text));
+			break;
+		}
+		if (line->text != expected[count])
+			self.fail(fmt::format("line {} is \"{}\" instead of \"{}\"", count, line->text, expected[count]));
+		if (line->time < last_time)
+			self.fail(fmt::format("line {} goes back in time", count));
+		last_time = line->time;
+		++count;
+	}
+	if (count != expected.size())
+		self.fail(fmt::format("read {} lines instead of {}", count, expected.size()));
+});
+
+[[maybe_unused]] test &binary_log_threads_test = g_io_tests.make_test("binary_log threads", "Binary logging from several threads", [](test& self) {
+	using octahedron::log_level;
+	using octahedron::open_flags;
+
+	constexpr int threads = 4;
+	constexpr int per_thread = 10000;
+
+	temp_dir                dir{"binary_log_threads"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+	{
+		octahedron::binary_logger logger{fs.open("log.bin", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY)};
+		std::vector<std::jthread> workers;
+
+		for (int t = 0; t < threads; ++t) {
+			workers.emplace_back([&logger, t]() {
+				for (int i = 0; i < per_thread; ++i)
+					logger.log<"thread {} line {}">(log_level::DEBUG, t, i);
+			});
+		}
+	}
+
+	auto in = fs.open("log.bin", open_flags::INPUT | open_flags::BINARY);
+
+	if (!in) {
+		self.fail("failed to open the log");
+		return;
+	}
+
+	octahedron::binary_log_reader reader{*in};
+	std::array<int, threads>     next{};
+	int                          count = 0;
+
+	while (auto line = reader.next()) {
+		int t;
+		int i;
+
+		if (std::sscanf(line->text.c_str(), "thread %d line %d", &t, &i) != 2 || t < 0 || t >= threads || i != next[t]) {
+			self.fail(fmt::format("unexpected line \"{}\"", line->text));
+			return;
+		}
+		++next[t];
+		++count;
+	}
+	if (count != threads * per_thread)
+		self.fail(fmt::format("read {} lines instead of {}", count, threads * per_thread));
+});
+
+[[maybe_unused]] test &binary_log_corrupt_test = g_io_tests.make_test("binary_log corrupt", "Binary logs with sizes and ids past anything they can hold", [](test& self) {
+	using octahedron::open_flags;
+	using octahedron::uint32;
+	using octahedron::uint64;
+
+	temp_dir                dir{"binary_log_corrupt"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir(dir.path.string());
+
+	// each log is a valid header followed by one entry with a field set too large for the reader to allocate it
+	auto check_rejected = [&](std::string_view what, auto... fields) {
+		std::vector<std::byte> bytes;
+		auto                   append = [&bytes](const auto &value) {
+			auto raw = std::as_bytes(std::span{&value, 1});
+
+			bytes.insert(bytes.end(), raw.begin(), raw.end());
+		};
+
+		append(std::array<char, 4>{'O', 'C', 'T', 'L'});
+		append(uint32{1});
+		(append(fields), ...);
+		{
+			auto out = fs.open("bad.bin", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+			if (!out || out->write(bytes) != bytes.size()) {
+				self.fail("failed to write the corrupt log");
+				return;
+			}
+		}
+
+		auto in = fs.open("bad.bin", open_flags::INPUT | open_flags::BINARY);
+
+		if (!in) {
+			self.fail("failed to open the corrupt log");
+			return;
+		}
+		try {
+			octahedron::binary_log_reader reader{*in};
+
+			if (!reader.valid() || reader.next())
+				self.fail(fmt::format("read a line from a log with a corrupt {}", what));
+		} catch (const std::exception &e) {
+			self.fail(fmt::format("{} reading a log with a corrupt {}", e.what(), what));
+		}
+	};
+
+	check_rejected("format id", 'D', uint32{0xFFFFFFF0}, uint32{0}, uint32{0});
+	check_rejected("format size", 'D', uint32{0}, uint32{0xFFFFFFFF});
+	check_rejected("payload size", 'R', uint32{0}, uint32{0}, uint64{0}, uint32{0xFFFFFFFF});
+});
@@ -0,0 +1,88 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include <io/byteswap.h>
+#include <io/serializer.h>
+
+using namespace octahedron::tests;
+
+[[maybe_unused]] test &byteswap_values_test = g_io_tests.make_test("byteswap_values", "Batched byte order conversion", [](test& self) {
+	std::vector<std::byte> src(1000);
+	std::vector<std::byte> dst(src.size());
+
+	std::ranges::generate(src, [i = 0]() mutable { return (static_cast<std::byte>(i++ * 7)); });
+	for (size_t value_size : {2, 3, 4, 8}) {
+		// counts around the 16 and 32-byte blocks, and odd offsets to exercise unaligned loads
+		for (size_t count : {0, 1, 3, 7, 8, 9, 31, 32, 33, 100}) {
+			for (size_t offset : {0, 1}) {
+				const std::byte *in = src.data() + offset;
+				std::vector      inplace(in, in + count * value_size);
+				bool             good = true;
+
+				octahedron::byteswap_values(dst.data() + offset, in, count, value_size);
+				octahedron::byteswap_values(inplace.data(), inplace.data(), count, value_size);
+				for (size_t i = 0; i < count * value_size && good; ++i) {
+					std::byte expected = in[(i / value_size) * value_size + value_size - 1 - i % value_size];
+
+					good = (dst[offset + i] == expected && inplace[i] == expected);
+				}
+				if (!good)
+					self.fail(fmt::format("wrong conversion of {} values of {} bytes at offset {}", count, value_size, offset));
+			}
+		}
+	}
+});
+
+[[maybe_unused]] test &byteswap_ranges_test = g_io_tests.make_test("byteswap ranges", "Putting and getting ranges in both byte orders", [](test& self) {
+	using octahedron::endianness;
+
+	std::vector<octahedron::uint16> shorts(5000);
+	std::vector<octahedron::uint32> ints(3000);
+	std::array<float, 7>            floats{1.0f, -2.5f, 3.25f, 0.0f, 1e10f, -1e-10f, 42.0f};
+
+	std::iota(shorts.begin(), shorts.end(), octahedron::uint16{1});
+	std::iota(ints.begin(), ints.end(), 0x01020304u);
+
+	octahedron::dynamic_buffer buf;
+
+	// larger than the staging block, so the conversion spans several writes
+	if (!buf.put<decltype(shorts), endianness::big>(shorts) || !buf.put<decltype(ints), endianness::big>(ints) ||
+	    !buf.put<decltype(floats), endianness::big>(floats) || !buf.put<decltype(ints), endianness::little>(ints))
+		self.fail("failed to write the ranges");
+	if (buf.size() != 2 * shorts.size() + 4 * ints.size() + 4 * floats.size() + 4 * ints.size())
+		self.fail(fmt::format("{} bytes written", buf.size()));
+
+	std::byte *data = reinterpret_cast<std::byte*>(buf.data());
+
+	if (data[0] != std::byte{0} || data[1] != std::byte{1} || data[2 * shorts.size()] != std::byte{1} || data[2 * shorts.size() + 3] != std::byte{4})
+		self.fail("ranges were not written big endian");
+
+	std::vector<octahedron::uint16> shorts_in(shorts.size());
+	std::vector<octahedron::uint32> ints_in(ints.size());
+	std::array<float, 7>            floats_in{};
+	std::vector<octahedron::uint32> ints_le(ints.size());
+
+	buf.reset();
+	if (!buf.get<decltype(shorts_in), endianness::big>(shorts_in) || shorts_in != shorts)
+		self.fail("read back the wrong uint16");
+	if (!buf.get<decltype(ints_in), endianness::big>(ints_in) || ints_in != ints)
+		self.fail("read back the wrong uint32");
+	if (!buf.get<decltype(floats_in), endianness::big>(floats_in) || floats_in != floats)
+		self.fail("read back the wrong floats");
+	if (!buf.get<decltype(ints_le), endianness::little>(ints_le) || ints_le != ints)
+		self.fail("read back the wrong little endian uint32");
+
+	float scalar{};
+
+	buf.clear();
+	if (!buf.put<float, endianness::big>(-2.5f) || buf.data()[0] != std::byte{0xC0})
+		self.fail("scalar float was not written big endian");
+	buf.reset();
+	if (!buf.get<float, endianness::big>(scalar) || scalar != -2.5f)
+		self.fail(fmt::format("read back scalar float {}", scalar));
+});
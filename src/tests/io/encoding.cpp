@@ -0,0 +1,83 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <random>
+#include <vector>
+
+#include <io/encoding.h>
+#include <io/file_system.h>
+#include <io/utf8_stream.h>
+
+using namespace octahedron::tests;
+
+[[maybe_unused]] test &ascii_prefix_test = g_io_tests.make_test("ascii_prefix_size", "Vectorized ASCII run detection", [](test& self) {
+	std::vector<char8_t> buf(100, u8'a');
+
+	// a non-ASCII byte at every position, seen through every alignment and length
+	for (size_t marker = 0; marker <= buf.size(); ++marker) {
+		if (marker < buf.size())
+			buf[marker] = static_cast<char8_t>(0x80 | marker);
+		for (size_t start = 0; start < 40; ++start) {
+			for (size_t length : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{33}, buf.size() - start}) {
+				std::span<char8_t const> view{buf.data() + start, length};
+				size_t                   expected = (marker >= start && marker < start + length ? marker - start : length);
+				size_t                   result = octahedron::ascii_prefix_size(view);
+
+				if (result != expected) {
+					self.fail(fmt::format("{} ASCII bytes found at {}+{} instead of {}", result, start, length, expected));
+					return;
+				}
+			}
+		}
+		if (marker < buf.size())
+			buf[marker] = u8'a';
+	}
+});
+
+[[maybe_unused]] test &utf8_stream_runs_test = g_io_tests.make_test("utf8_stream runs", "Utf8 streams mixing ASCII runs and multibyte characters", [](test& self) {
+	using octahedron::open_flags;
+
+	temp_dir                dir{"utf8_stream_runs"};
+	octahedron::file_system fs;
+	std::u8string           text;
+	std::string             expected;
+	std::mt19937            rng{42};
+
+	fs.set_home_dir(dir.path.string());
+	// long enough to span several refills of the stream buffer, with characters straddling them
+	while (text.size() < 20000) {
+		size_t run = std::uniform_int_distribution<size_t>{0, 80}(rng);
+
+		for (size_t i = 0; i < run; ++i) {
+			auto c = static_cast<char8_t>(std::uniform_int_distribution<int>{' ', '~'}(rng));
+
+			text.push_back(c);
+			expected.push_back(static_cast<char>(c));
+		}
+
+		std::u8string_view multibyte = (rng() & 1 ? std::u8string_view{u8"é"} : std::u8string_view{u8"Ж"});
+
+		text += multibyte;
+		expected.push_back(octahedron::unicode_character::from_utf8(multibyte).to_cube());
+	}
+	{
+		auto out = fs.open("text.txt", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+		out->write(std::span{reinterpret_cast<const std::byte*>(text.data()), text.size()});
+	}
+
+	octahedron::utf8_stream stream(fs.open("text.txt", open_flags::INPUT | open_flags::BINARY));
+	std::string             result;
+	char                    chunk[37];
+
+	while (size_t n = stream.read_cube(chunk, sizeof(chunk)))
+		result.append(chunk, n);
+	if (result.size() != expected.size())
+		self.fail(fmt::format("read {} characters instead of {}", result.size(), expected.size()));
+	for (size_t i = 0; i < std::min(result.size(), expected.size()); ++i) {
+		if (result[i] != expected[i]) {
+			self.fail(fmt::format("character {} is {:#x} instead of {:#x}", i, static_cast<octahedron::uchar>(result[i]), static_cast<octahedron::uchar>(expected[i])));
+			break;
+		}
+	}
+});
@@ -3,8 +3,17 @@
 #include "io/io.h"
 #include "tests.h"
 
+#include <engine/job_system.h>
+#include <io/buffered_stream.h>
+#include <io/gz_file_stream.h>
+#include <io/mapped_file_stream.h>
+#include <io/readahead_stream.h>
 #include <io/utf8_stream.h>
 
+#include <atomic>
+
+#include <zlib.h>
+
 using namespace octahedron::tests;
 
 [[maybe_unused]] test &utf8_stream_test = g_io_tests.make_test("utf8_stream", "Utf8 streams", [](test& self) {
@@ -29,3 +38,433 @@ using namespace octahedron::tests;
 	} while (characters_read1 == 32 && characters_read2 == 32);
 
 });
+
+[[maybe_unused]] test &mapped_file_stream_test = g_io_tests.make_test("mapped_file_stream", "Memory-mapped file streams", [](test& self) {
+	using octahedron::open_flags;
+
+	octahedron::file_system fs;
+	auto raw = fs.open("testdata/utf8_no_bom.txt", open_flags::INPUT | open_flags::BINARY);
+	auto mapped = fs.open("testdata/utf8_no_bom.txt", open_flags::INPUT | open_flags::BINARY | open_flags::MAPPED);
+
+	if (!raw || !mapped) {
+		self.fail("failed to open test file");
+		return;
+	}
+	if (mapped->size() != raw->size())
+		self.fail(fmt::format("size mismatch: mapped {}, raw {}", mapped->size(), raw->size()));
+
+	std::array<std::byte, 61> buffer1;
+	std::array<std::byte, 61> buffer2;
+	size_t read1;
+	size_t read2;
+
+	do {
+		read1 = mapped->read(buffer1);
+		read2 = raw->read(buffer2);
+		if (read1 != read2 || memcmp(buffer1.data(), buffer2.data(), read1) != 0) {
+			self.fail(fmt::format("read mismatch at {}", mapped->tell()));
+			return;
+		}
+	} while (read1 == buffer1.size());
+	if (!mapped->eof())
+		self.fail("eof() failed to return true after reading the whole file");
+
+	if (!mapped->seek(-8, SEEK_END) || mapped->tell() != mapped->size() - 8)
+		self.fail("seek(-8, SEEK_END) failed");
+	if (mapped->read(buffer1) != 8)
+		self.fail("failed to read the last 8 bytes");
+	if (!mapped->seek(0, SEEK_SET) || mapped->seek(-1, SEEK_CUR))
+		self.fail("seek before the start of the file failed to return false");
+
+	auto *view = dynamic_cast<octahedron::mapped_file_stream*>(mapped.get());
+
+	if (!view || view->view().size() != mapped->size())
+		self.fail("view() failed to cover the whole file");
+});
+
+[[maybe_unused]] test &buffered_stream_test = g_io_tests.make_test("buffered_stream", "Buffered stream decorator", [](test& self) {
+	using octahedron::open_flags;
+
+	octahedron::file_system fs;
+	auto raw = fs.open("testdata/utf8_no_bom.txt", open_flags::INPUT | open_flags::BINARY);
+	auto inner = fs.open("testdata/utf8_no_bom.txt", open_flags::INPUT | open_flags::BINARY);
+
+	if (!raw || !inner) {
+		self.fail("failed to open test file");
+		return;
+	}
+	// a small window so that reads straddle refills
+	octahedron::buffered_stream buffered{std::move(inner), 7};
+	size_t size = raw->size();
+
+	if (buffered.size() != size)
+		self.fail(fmt::format("size mismatch: buffered {}, raw {}", buffered.size(), size));
+
+	for (size_t i = 0; i + 2 <= size; i += 2) {
+		auto a = buffered.get<uint16_t>();
+		auto b = raw->get<uint16_t>();
+
+		if (a != b || buffered.tell() != raw->tell()) {
+			self.fail(fmt::format("get<uint16_t> mismatch at {}", raw->tell()));
+			return;
+		}
+	}
+
+	std::array<std::byte, 23> buffer1;
+	std::array<std::byte, 23> buffer2;
+
+	for (ssize_t pos : {ssize_t{3}, ssize_t{0}, static_cast<ssize_t>(size / 2), ssize_t{5}}) {
+		if (!buffered.seek(pos, SEEK_SET) || !raw->seek(pos, SEEK_SET)) {
+			self.fail(fmt::format("seek({}) failed", pos));
+			return;
+		}
+		size_t read1 = buffered.read(buffer1);
+		size_t read2 = raw->read(buffer2);
+
+		if (read1 != read2 || memcmp(buffer1.data(), buffer2.data(), read1) != 0 || buffered.tell() != raw->tell())
+			self.fail(fmt::format("read mismatch after seek({})", pos));
+		if (!buffered.seek(-4, SEEK_CUR) || buffered.tell() != raw->tell() - 4)
+			self.fail(fmt::format("seek(-4, SEEK_CUR) failed after seek({})", pos));
+		raw->seek(-4, SEEK_CUR);
+	}
+
+	if (!buffered.seek(-8, SEEK_END) || buffered.tell() != size - 8)
+		self.fail("seek(-8, SEEK_END) failed");
+	if (buffered.read(buffer1) != 8)
+		self.fail("failed to read the last 8 bytes");
+	if (!buffered.eof())
+		self.fail("eof() failed to return true after reading the whole file");
+});
+
+namespace
+{
+
+/**
+ * \brief Stream forwarding to another one, counting the reads it gets.
+ */
+class counting_stream final : public octahedron::file_stream {
+public:
+	using file_stream::read;
+	using file_stream::write;
+
+	explicit counting_stream(std::unique_ptr<octahedron::file_stream> stream, std::atomic<size_t> &reads) :
+		_stream{std::move(stream)},
+		_reads{reads} {}
+
+	bool flush() override { return (_stream->flush()); }
+	bool eof() override { return (_stream->eof()); }
+	uint32 crc32() override { return (_stream->crc32()); }
+	[[nodiscard]] size_t tell() const override { return (_stream->tell()); }
+	bool seek(ssize_t pos, int whence) override { return (_stream->seek(pos, whence)); }
+	size_t size() override { return (_stream->size()); }
+
+	size_t read(std::span<std::byte> buf) override {
+		++_reads;
+		return (_stream->read(buf));
+	}
+
+	size_t write(std::span<const std::byte> buf) override { return (_stream->write(buf)); }
+
+private:
+	std::unique_ptr<octahedron::file_stream> _stream;
+	std::atomic<size_t>                     &_reads;
+};
+
+}
+
+[[maybe_unused]] test &readahead_stream_test = g_io_tests.make_test("readahead_stream", "Read-ahead stream decorator", [](test& self) {
+	using octahedron::open_flags;
+
+	constexpr std::string_view file_name = "readahead_test.gz";
+	temp_dir                   dir{"readahead_stream"};
+	octahedron::file_system    fs;
+	std::vector<std::byte>     data(1 << 20);
+
+	fs.set_home_dir(dir.path.string());
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<std::byte>((i / 11) ^ (i * 17 >> 8));
+	{
+		auto f = fs.open_gz(file_name, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+		if (!f || f->write(data) != data.size()) {
+			self.fail("failed to write test file");
+			return;
+		}
+	}
+
+	auto inner = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY);
+
+	if (!inner) {
+		self.fail("failed to open test file");
+		return;
+	}
+	{
+		// small blocks so that the ring wraps around many times, and reads straddle blocks
+		octahedron::readahead_stream stream{std::move(inner), 1000};
+		std::vector<std::byte>       read(data.size() + 1);
+		size_t                       total = 0;
+
+		for (size_t chunk = 1; total < read.size(); chunk = chunk * 3 % 4099 + 1) {
+			size_t n = stream.read(std::span{read.data() + total, std::min(chunk, read.size() - total)});
+
+			if (n == 0)
+				break;
+			total += n;
+			if (stream.tell() != total) {
+				self.fail(fmt::format("tell() returned {}, expected {}", stream.tell(), total));
+				return;
+			}
+		}
+		if (total != data.size() || memcmp(read.data(), data.data(), total) != 0)
+			self.fail(fmt::format("read back {} bytes, expected {}", total, data.size()));
+		if (!stream.eof())
+			self.fail("eof() failed to return true after reading the whole file");
+
+		uint32_t expected_crc = ::crc32(0, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()));
+
+		if (stream.crc32() != expected_crc)
+			self.fail(fmt::format("crc32 after reading: 0x{:X}, expected 0x{:X}", stream.crc32(), expected_crc));
+	}
+	inner = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY);
+	if (!inner) {
+		self.fail("failed to reopen test file");
+		return;
+	}
+	{
+		octahedron::readahead_stream stream{std::move(inner), 1000};
+		std::array<std::byte, 64>    buffer;
+
+		// far or backwards seeks restart the producer, a short hop forwards skips through the ring
+		for (size_t pos : {size_t{12345}, size_t{100}, size_t{5000}, data.size() - 10}) {
+			size_t expected = std::min(buffer.size(), data.size() - pos);
+
+			if (!stream.seek(static_cast<ssize_t>(pos), SEEK_SET) || stream.tell() != pos || stream.read(buffer) != expected ||
+					memcmp(buffer.data(), data.data() + pos, expected) != 0)
+				self.fail(fmt::format("read mismatch after seek({})", pos));
+		}
+	}
+	inner = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY);
+	if (!inner) {
+		self.fail("failed to reopen test file");
+		return;
+	}
+	{
+		std::atomic<size_t>          reads{0};
+		octahedron::readahead_stream stream{std::make_unique<counting_stream>(std::move(inner), reads), 1000};
+		std::array<std::byte, 64>    buffer;
+
+		// nothing is read until the consumer asks for data
+		if (reads != 0)
+			self.fail(fmt::format("constructing the stream read {} times from the underlying stream", reads.load()));
+		for (size_t pos = 0; pos < 3 * buffer.size(); pos += buffer.size()) {
+			if (stream.read(buffer) != buffer.size() || memcmp(buffer.data(), data.data() + pos, buffer.size()) != 0)
+				self.fail(fmt::format("read mismatch at {}", pos));
+			// the first size() stops the producer in the middle of reading, the next read starts it again
+			if (stream.size() != data.size())
+				self.fail(fmt::format("size() returned {} at {}, expected {}", stream.size(), pos, data.size()));
+		}
+		if (reads == 0)
+			self.fail("reading did not read from the underlying stream");
+	}
+});
+
+[[maybe_unused]] test &gz_parallel_test = g_io_tests.make_test("gz_parallel", "Parallel gzip writer", [](test& self) {
+	using octahedron::open_flags;
+
+	constexpr std::string_view file_name = "gz_parallel_test.gz";
+	temp_dir                   dir{"gz_parallel"};
+	octahedron::file_system    fs;
+	octahedron::job_system     jobs{3};
+	std::vector<std::byte>     data(1 << 20);
+
+	fs.set_home_dir(dir.path.string());
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<std::byte>((i / 7) ^ (i * 31 >> 9));
+
+	uint32_t expected_crc = ::crc32(0, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()));
+
+	// on the job system, then on the writing thread alone
+	for (octahedron::job_system *js : {&jobs, static_cast<octahedron::job_system*>(nullptr)}) {
+		std::string_view what = (js ? "job system" : "no job system");
+		uint32_t         written_crc;
+
+		fs.set_job_system(js);
+		{
+			auto f = fs.open_gz(file_name, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY | open_flags::PARALLEL);
+
+			if (!f) {
+				self.fail("failed to open test file for writing");
+				return;
+			}
+			// odd write sizes, with a flush in the middle, so that blocks do not line up with writes
+			for (size_t offset = 0; offset < data.size(); offset += 4099) {
+				size_t size = std::min<size_t>(4099, data.size() - offset);
+
+				if (f->write(std::span{data.data() + offset, size}) != size) {
+					self.fail(fmt::format("{}: write failed at {}", what, offset));
+					return;
+				}
+				if (offset == 4099 * 100 && !f->flush())
+					self.fail(fmt::format("{}: flush failed", what));
+			}
+			written_crc = f->crc32();
+		}
+		if (written_crc != expected_crc)
+			self.fail(fmt::format("{}: crc32 after writing: 0x{:X}, expected 0x{:X}", what, written_crc, expected_crc));
+
+		auto f = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY);
+
+		if (!f) {
+			self.fail("failed to open test file for reading");
+			return;
+		}
+
+		std::vector<std::byte> read(data.size() + 1);
+		size_t                 size = f->read(read);
+
+		if (size != data.size() || memcmp(read.data(), data.data(), size) != 0)
+			self.fail(fmt::format("{}: read back {} bytes, expected {}", what, size, data.size()));
+		if (f->crc32() != expected_crc)
+			self.fail(fmt::format("{}: crc32 after reading: 0x{:X}, expected 0x{:X}", what, f->crc32(), expected_crc));
+
+		// zlib's own reader checks the header, the deflate stream and the trailer
+		gzFile gz = gzopen((dir.path / file_name).string().c_str(), "rb");
+
+		if (!gz) {
+			self.fail(fmt::format("{}: gzopen failed", what));
+			return;
+		}
+		std::fill(read.begin(), read.end(), std::byte{0});
+
+		int  zsize = gzread(gz, read.data(), static_cast<unsigned>(read.size()));
+		int  err;
+		auto message = std::string{gzerror(gz, &err)};
+
+		gzclose(gz);
+		if (err != Z_OK || zsize != static_cast<int>(data.size()) || memcmp(read.data(), data.data(), data.size()) != 0)
+			self.fail(fmt::format("{}: gzread returned {} bytes, expected {} ({})", what, zsize, data.size(), message));
+	}
+});
+
+[[maybe_unused]] test &gz_index_test = g_io_tests.make_test("gz_index", "Gzip seek index", [](test& self) {
+	using octahedron::open_flags;
+
+	constexpr std::string_view file_name = "gz_index_test.gz";
+	constexpr std::string_view index_name = "gz_index_test.gz.idx";
+	temp_dir                   dir{"gz_index"};
+	octahedron::file_system    fs;
+	std::vector<std::byte>     data(5 << 20);
+
+	fs.set_home_dir(dir.path.string());
+
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<std::byte>((i / 13) ^ (i * 2654435761u >> 27));
+	{
+		auto f = fs.open_gz(file_name, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+		if (!f || f->write(data) != data.size()) {
+			self.fail("failed to write test file");
+			return;
+		}
+	}
+
+	auto check_seeks = [&](octahedron::file_stream &f, std::string_view what) {
+		std::array<std::byte, 64> buffer;
+		size_t                    pos = 0;
+
+		for (size_t i = 0; i < 64; ++i) {
+			pos = (pos + 3'600'011) % data.size();
+			if (!f.seek(pos, SEEK_SET) || f.read(buffer) != std::min(buffer.size(), data.size() - pos) ||
+					memcmp(buffer.data(), data.data() + pos, std::min(buffer.size(), data.size() - pos)) != 0) {
+				self.fail(fmt::format("{}: read mismatch after seek({})", what, pos));
+				return;
+			}
+		}
+		if (!f.seek(-16, SEEK_END) || f.tell() != data.size() - 16 || f.read(buffer) != 16 ||
+				memcmp(buffer.data(), data.data() + data.size() - 16, 16) != 0)
+			self.fail(fmt::format("{}: seek(-16, SEEK_END) failed", what));
+	};
+
+	{
+		auto f = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY | open_flags::INDEXED);
+		auto gz = dynamic_cast<octahedron::gz_file_stream*>(f.get());
+
+		if (!gz || !gz->build_index()) {
+			self.fail("failed to build gz index");
+			return;
+		}
+		check_seeks(*gz, "built index");
+
+		auto index = fs.open(index_name, open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+		if (!index || !gz->save_index(*index))
+			self.fail("failed to save gz index");
+	}
+	{
+		// picks up the sidecar index
+		auto f = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY | open_flags::INDEXED);
+
+		if (!f) {
+			self.fail("failed to reopen test file");
+			return;
+		}
+		check_seeks(*f, "loaded index");
+	}
+	{
+		auto f = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY);
+		auto gz = dynamic_cast<octahedron::gz_file_stream*>(f.get());
+
+		// size() only answers when the trailer is enough, compute_size() always does and leaves the position alone
+		if (!gz || (gz->size() != octahedron::error_size && gz->size() != data.size()))
+			self.fail("size() returned a wrong size");
+		else if (gz->compute_size() != data.size() || gz->tell() != 0)
+			self.fail(fmt::format("compute_size() returned {}, expected {}", gz->compute_size(), data.size()));
+	}
+	{
+		auto                   saved = fs.open(index_name, open_flags::INPUT | open_flags::BINARY);
+		std::vector<std::byte> bytes(saved ? saved->size() : 0);
+
+		if (!saved || saved->read(bytes) != bytes.size()) {
+			self.fail("failed to read back the gz index");
+			return;
+		}
+
+		// loads the sidecar with a field overwritten, which must be rejected
+		auto check_rejected = [&](size_t offset, octahedron::uint64 value, std::string_view what) {
+			std::vector<std::byte> bad_bytes = bytes;
+
+			if (bad_bytes.size() < offset + sizeof(value)) {
+				self.fail(fmt::format("gz index too small to corrupt its {}", what));
+				return;
+			}
+			std::memcpy(bad_bytes.data() + offset, &value, sizeof(value));
+			{
+				auto out = fs.open("bad.idx", open_flags::OUTPUT | open_flags::TRUNCATE | open_flags::BINARY);
+
+				if (!out || out->write(bad_bytes) != bad_bytes.size()) {
+					self.fail("failed to write the corrupt gz index");
+					return;
+				}
+			}
+
+			auto f = fs.open_gz(file_name, open_flags::INPUT | open_flags::BINARY | open_flags::INDEXED);
+			auto gz = dynamic_cast<octahedron::gz_file_stream*>(f.get());
+			auto bad = fs.open("bad.idx", open_flags::INPUT | open_flags::BINARY);
+
+			if (!gz || !bad || gz->load_index(*bad))
+				self.fail(fmt::format("loaded a gz index with a corrupt {}", what));
+		};
+
+		constexpr size_t count_offset = 16;
+		constexpr size_t first_out_offset = 24;
+		constexpr size_t first_in_offset = 32;
+
+		// a sidecar claiming more checkpoints than it holds is rejected before anything is allocated for them
+		check_rejected(count_offset, octahedron::uint64{1} << 58, "checkpoint count");
+		// checkpoints out of order would make seeks restore the wrong one
+		check_rejected(first_out_offset, data.size(), "checkpoint order");
+		check_rejected(first_in_offset, octahedron::uint64{1} << 40, "checkpoint raw offset");
+	}
+});
@@ -0,0 +1,116 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <fstream>
+#include <thread>
+
+#include <io/file_stream.h>
+#include <io/file_system.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+struct package_dirs {
+	explicit package_dirs(std::string_view name) :
+		dir{name},
+		root{dir.path} {
+		for (auto path : {"home", "pkg1/textures", "pkg2/textures", "pkg2/sounds"})
+			octahedron::stdfs::create_directories(root / path);
+		touch("pkg1/textures/a.png");
+		touch("pkg2/textures/a.png");
+		touch("pkg2/textures/b.png");
+		touch("pkg2/sounds/c.ogg");
+	}
+
+	void touch(std::string_view path) const {
+		std::ofstream{root / path};
+	}
+
+	temp_dir                dir;
+	octahedron::stdfs::path root;
+};
+} // namespace
+
+[[maybe_unused]] test &package_index_test = g_io_tests.make_test("package_index", "Package directory index", [](test& self) {
+	package_dirs            dirs{"package_index"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir((dirs.root / "home").string());
+	fs.add_package_dir((dirs.root / "pkg1").string());
+	fs.add_package_dir((dirs.root / "pkg2").string());
+
+	auto expect = [&](std::string_view path, std::optional<std::string_view> package) {
+		auto resolved = fs._resolve_path(path);
+
+		if (package.has_value() != resolved.has_value() ||
+				(package && *resolved != octahedron::stdfs::absolute(dirs.root / *package / path).lexically_normal()))
+			self.fail(fmt::format("{} resolved to {}, expected {}", path, resolved ? resolved->string() : "nothing", package.value_or("nothing")));
+	};
+
+	expect("textures/a.png", "pkg1");
+	expect("textures/b.png", "pkg2");
+	expect("textures/../sounds/c.ogg", "pkg2");
+	expect("sounds", "pkg2");
+	expect("textures/d.png", std::nullopt);
+
+	auto stats = fs.get_path_cache_stats();
+
+	if (stats.rebuilds != 1 || stats.hits != 4 || stats.misses != 1)
+		self.fail(fmt::format("unexpected stats: {} rebuilds, {} hits, {} misses", stats.rebuilds, stats.hits, stats.misses));
+
+	// not seen until the index is rebuilt
+	dirs.touch("pkg1/textures/d.png");
+	expect("textures/d.png", std::nullopt);
+	fs.rescan();
+	expect("textures/d.png", "pkg1");
+	if (fs.get_path_cache_stats().rebuilds != 2)
+		self.fail("rescan() did not rebuild the index");
+
+	fs.reset_path_cache_stats();
+	stats = fs.get_path_cache_stats();
+	if (stats.hits != 0 || stats.misses != 0)
+		self.fail("reset_path_cache_stats() did not reset the counters");
+});
+
+[[maybe_unused]] test &package_watch_test = g_io_tests.make_test("package_watch", "Package directory watching", [](test& self) {
+	package_dirs            dirs{"package_watch"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir((dirs.root / "home").string());
+	fs.add_package_dir((dirs.root / "pkg1").string());
+	if (!fs.watch_package_dirs(true))
+		return; // not supported on this platform
+	if (fs._resolve_path("textures/e.png"))
+		self.fail("textures/e.png resolved before being created");
+	dirs.touch("pkg1/textures/e.png");
+	if (!fs._resolve_path("textures/e.png"))
+		self.fail("textures/e.png not found after being created");
+});
+
+[[maybe_unused]] test &package_move_test = g_io_tests.make_test("package_move", "Package directory index of moved file systems", [](test& self) {
+	package_dirs            dirs{"package_move"};
+	octahedron::file_system fs;
+
+	fs.set_home_dir((dirs.root / "home").string());
+	fs.add_package_dir((dirs.root / "pkg1").string());
+
+	octahedron::file_system moved{std::move(fs)};
+
+	if (!moved._resolve_path("textures/a.png"))
+		self.fail("moved file system lost its package directories");
+
+	// the moved-from file system has an index of its own, and can be reused
+	fs.rescan();
+	fs.watch_package_dirs(false);
+	fs.reset_path_cache_stats();
+	fs.set_home_dir((dirs.root / "home").string());
+	fs.add_package_dir((dirs.root / "pkg2").string());
+	if (!fs._resolve_path("sounds/c.ogg") || fs.get_path_cache_stats().rebuilds != 1)
+		self.fail("moved-from file system did not index its new package directory");
+
+	moved = std::move(fs);
+	fs.add_package_dir((dirs.root / "pkg1").string());
+	if (!moved._resolve_path("sounds/c.ogg") || !fs._resolve_path("textures/a.png"))
+		self.fail("move assignment mixed up the package indices");
+});
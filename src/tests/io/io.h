@@ -3,10 +3,51 @@
 
 #include "tests.h"
 
+#include <atomic>
+#include <random>
+
+#include <io/file_system.h>
+
 namespace octahedron::tests {
 
 inline test_suite& g_io_tests = make_test_suite("Input/Output");
 
+/**
+ * \brief Directory a file test works in, removed with everything in it when destroyed.
+ *
+ * Its path is made unique to the instance and to the run of the test binary, so that tests running in parallel,
+ * or several test binaries, never share files.
+ */
+struct temp_dir {
+	explicit temp_dir(std::string_view name) :
+		path{stdfs::temp_directory_path() / fmt::format("octahedron_{}_{:08x}_{}", name, _run_id(), _next_id++)} {
+		std::error_code err;
+
+		stdfs::remove_all(path, err);
+		stdfs::create_directories(path);
+	}
+
+	~temp_dir() {
+		std::error_code err;
+
+		stdfs::remove_all(path, err);
+	}
+
+	temp_dir(const temp_dir &) = delete;
+	temp_dir& operator=(const temp_dir &) = delete;
+
+	stdfs::path path;
+
+private:
+	static uint32 _run_id() {
+		static const uint32 id = std::random_device{}();
+
+		return (id);
+	}
+
+	static inline std::atomic<uint32> _next_id{0};
+};
+
 }
 
 #endif
@@ -0,0 +1,115 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <cstring>
+
+#include <io/serializer.h>
+
+using namespace octahedron::tests;
+
+namespace
+{
+using octahedron::endianness;
+
+struct map_header {
+	char              magic[4];
+	octahedron::int32 version;
+	octahedron::int32 worldsize;
+};
+
+struct position {
+	float x;
+	float y;
+	float z;
+};
+
+enum class kind : octahedron::uint16 {
+	NONE = 0,
+	LIGHT = 3
+};
+
+struct entity_state {
+	position           pos;
+	kind               type;
+	octahedron::uint16 flags;
+};
+
+struct padded {
+	octahedron::uint8  tag;
+	octahedron::uint32 value;
+	octahedron::uint16 extra;
+};
+
+struct surface {
+	octahedron::uint8 verts;
+	octahedron::uint8 numverts;
+};
+
+static_assert(octahedron::is_memcpy_serializable<map_header, endianness::native>);
+static_assert(octahedron::is_memcpy_serializable<position, endianness::native>);
+static_assert(!octahedron::is_memcpy_serializable<position, endianness::swapped>);
+static_assert(octahedron::is_memcpy_serializable<entity_state, endianness::native>);
+static_assert(!octahedron::is_memcpy_serializable<padded, endianness::native>);
+static_assert(octahedron::is_memcpy_serializable<surface, endianness::swapped>);
+static_assert(octahedron::is_pfr_valid<padded> && octahedron::pfr_helper<padded>::packed_size == 7);
+static_assert(!octahedron::is_pfr_valid<int*>);
+
+bool same_bytes(const octahedron::dynamic_buffer &a, const octahedron::dynamic_buffer &b) {
+	return (a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+} // namespace
+
+[[maybe_unused]] test &reflection_test = g_io_tests.make_test("reflection", "Reflected serialization of aggregates", [](test& self) {
+	map_header   header{{'T', 'M', 'A', 'P'}, 1, 1024};
+	entity_state state{{1.5f, -2.0f, 8.25f}, kind::LIGHT, 0x0102};
+	padded       pad{7, 0x0A0B0C0D, 0x0E0F};
+	surface      surf{3, 4};
+
+	octahedron::dynamic_buffer reflected;
+	octahedron::dynamic_buffer manual;
+
+	if (!reflected.put(header) || !reflected.put(state) || !reflected.put(pad) || !reflected.put(surf))
+		self.fail("failed to write the structs");
+	manual.put(std::string_view{header.magic, 4});
+	manual.put_all(header.version, header.worldsize);
+	manual.put_all(state.pos.x, state.pos.y, state.pos.z, state.type, state.flags);
+	manual.put_all(pad.tag, pad.value, pad.extra);
+	manual.put_all(surf.verts, surf.numverts);
+	if (!same_bytes(reflected, manual))
+		self.fail(fmt::format("native: {} bytes written by reflection, {} by hand, or different contents", reflected.size(), manual.size()));
+
+	octahedron::dynamic_buffer reflected_big;
+	octahedron::dynamic_buffer manual_big;
+
+	reflected_big.put<entity_state, endianness::big>(state);
+	reflected_big.put<padded, endianness::big>(pad);
+	reflected_big.put<surface, endianness::big>(surf);
+	manual_big.put_all<endianness::big>(state.pos.x, state.pos.y, state.pos.z, state.type, state.flags);
+	manual_big.put_all<endianness::big>(pad.tag, pad.value, pad.extra);
+	manual_big.put_all<endianness::big>(surf.verts, surf.numverts);
+	if (!same_bytes(reflected_big, manual_big))
+		self.fail(fmt::format("big endian: {} bytes written by reflection, {} by hand, or different contents", reflected_big.size(), manual_big.size()));
+
+	map_header   header_in{};
+	entity_state state_in{};
+	padded       pad_in{};
+	surface      surf_in{};
+
+	reflected.reset();
+	if (!reflected.get(header_in) || !reflected.get(state_in) || !reflected.get(pad_in) || !reflected.get(surf_in))
+		self.fail("failed to read the structs");
+	if (std::memcmp(header_in.magic, "TMAP", 4) != 0 || header_in.version != 1 || header_in.worldsize != 1024)
+		self.fail("read back the wrong header");
+	if (state_in.pos.y != -2.0f || state_in.type != kind::LIGHT || state_in.flags != 0x0102)
+		self.fail("read back the wrong entity state");
+	if (pad_in.tag != 7 || pad_in.value != 0x0A0B0C0D || pad_in.extra != 0x0E0F || surf_in.numverts != 4)
+		self.fail("read back the wrong padded struct");
+
+	state_in = {};
+	pad_in = {};
+	reflected_big.reset();
+	if (!reflected_big.get<entity_state, endianness::big>(state_in) || !reflected_big.get<padded, endianness::big>(pad_in))
+		self.fail("failed to read the big endian structs");
+	if (state_in.pos.z != 8.25f || state_in.type != kind::LIGHT || state_in.flags != 0x0102 || pad_in.value != 0x0A0B0C0D)
+		self.fail("read back the wrong big endian structs");
+});
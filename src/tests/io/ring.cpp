@@ -1,7 +1,10 @@
 #include "io/io.h"
 
 #include <tools/ring.h>
+#include <tools/concurrent_ring.h>
 #include <array>
+#include <thread>
+#include <vector>
 
 using namespace octahedron::tests;
 
@@ -403,6 +406,363 @@ struct ref {
 	}
 });
 
+struct packed_value {
+	uint32_t a;
+	uint16_t b;
+
+	bool operator==(const packed_value&) const = default;
+};
+
+template <typename Ring>
+concept contiguous_access = requires (Ring r) { r.reserve_contiguous(1); r.peek_contiguous(1); };
+
+static_assert(contiguous_access<octahedron::ring<packed_value, 4>>);
+static_assert(!contiguous_access<octahedron::ring<ref, 4>>, "contiguous access requires trivially copyable elements");
+
+/**
+ * \brief Puts `ring` in every state of start and size, reserves or peeks every size and checks the contents against what was written.
+ */
+template <typename Ring, typename Make>
+void check_contiguous(test &self, std::string_view what, Make &&make) {
+	using value_type = typename Ring::value_type;
+
+	constexpr size_t capacity = Ring::capacity();
+
+	auto fill = [&make](Ring &ring, size_t start, size_t size) {
+		// moving the start of the ring by writing then discarding
+		for (size_t i = 0; i < start; ++i)
+			ring.push_back(make(1000 + i));
+		ring.discard(start);
+		for (size_t i = 0; i < size; ++i)
+			ring.push_back(make(i));
+	};
+
+	auto check_contents = [&](Ring &ring, size_t first, size_t count, std::string_view where) {
+		if (ring.size() != count) {
+			self.fail(fmt::format("{} {}: size {} instead of {}", what, where, ring.size(), count));
+			return (false);
+		}
+		for (size_t i = 0; i < count; ++i) {
+			if (!(ring[i] == make(first + i))) {
+				self.fail(fmt::format("{} {}: wrong element {}", what, where, i));
+				return (false);
+			}
+		}
+		return (true);
+	};
+
+	for (size_t start = 0; start < capacity; ++start) {
+		for (size_t size = 0; size <= capacity; ++size) {
+			for (size_t n = 0; n <= capacity + 1; ++n) {
+				auto ring = std::make_unique<Ring>();
+
+				fill(*ring, start, size);
+
+				std::span<value_type> free = ring->reserve_contiguous(n);
+				auto where = fmt::format("reserve_contiguous({}) at start {} size {}", n, start, size);
+
+				if (n > capacity - size) {
+					if (!free.empty())
+						self.fail(fmt::format("{} {}: returned {} elements with {} free", what, where, free.size(), capacity - size));
+					continue;
+				}
+				if (free.size() < n || free.size() > capacity - size) {
+					self.fail(fmt::format("{} {}: returned {} elements", what, where, free.size()));
+					continue;
+				}
+				if (!check_contents(*ring, 0, size, where))
+					continue;
+				for (size_t i = 0; i < free.size(); ++i)
+					free[i] = make(size + i);
+				ring->commit(free.size());
+				if (!check_contents(*ring, 0, size + free.size(), where + " then commit"))
+					continue;
+				// the new elements are consumed like any other
+				ring->discard(size);
+				check_contents(*ring, size, free.size(), where + " then discard");
+			}
+			for (size_t n = 0; n <= capacity; ++n) {
+				auto ring = std::make_unique<Ring>();
+
+				fill(*ring, start, size);
+
+				std::span<value_type> front = ring->peek_contiguous(n);
+				auto where = fmt::format("peek_contiguous({}) at start {} size {}", n, start, size);
+
+				if (front.size() < std::min(n, size) || front.size() > size) {
+					self.fail(fmt::format("{} {}: returned {} elements", what, where, front.size()));
+					continue;
+				}
+				for (size_t i = 0; i < front.size(); ++i) {
+					if (!(front[i] == make(i))) {
+						self.fail(fmt::format("{} {}: wrong element {}", what, where, i));
+						break;
+					}
+				}
+				if (!check_contents(*ring, 0, size, where))
+					continue;
+				ring->discard(front.size());
+				if (!check_contents(*ring, front.size(), size - front.size(), where + " then discard"))
+					continue;
+				// writing after peeking and discarding, in the space the moved elements left
+				while (ring->size() < capacity)
+					ring->push_back(make(size + (ring->size() - (size - front.size()))));
+				check_contents(*ring, front.size(), capacity, where + " then refill");
+			}
+		}
+	}
 }
 
+[[maybe_unused]] test& ring_contiguous_test = g_io_tests.make_test("ring contiguous", "Reserving and peeking contiguous spans of circular buffers", [](test &self) {
+	auto make_char = [](size_t i) { return (static_cast<char>('a' + i % 26)); };
+	auto make_packed = [](size_t i) { return (packed_value{static_cast<uint32_t>(i * 7919), static_cast<uint16_t>(i)}); };
+
+	check_contiguous<octahedron::ring<char, 16>>(self, "ring<char>", make_char);
+	check_contiguous<octahedron::ouroboros<char, 16>>(self, "ouroboros<char>", make_char);
+	check_contiguous<octahedron::ring<packed_value, 13>>(self, "ring<packed_value>", make_packed);
+	check_contiguous<octahedron::ouroboros<packed_value, 13>>(self, "ouroboros<packed_value>", make_packed);
+
+	// streaming through a small ring, with chunks that never line up with its capacity
+	octahedron::ring<char, 16> ring;
+	std::string                in;
+	std::string                out;
+
+	for (size_t i = 0; i < 1000; ++i)
+		in += make_char(i * 3);
+	for (size_t written = 0; out.size() < in.size();) {
+		std::span<char> free = ring.reserve_contiguous(std::min<size_t>(5, ring.capacity() - ring.size()));
+		size_t          n = std::min(free.size(), in.size() - written);
+
+		std::copy_n(in.data() + written, n, free.data());
+		ring.commit(n);
+		written += n;
+
+		std::span<char> front = ring.peek_contiguous(3);
+		size_t          consumed = std::min<size_t>(front.size(), 7);
+
+		out.append(front.data(), consumed);
+		ring.discard(consumed);
+	}
+	if (out != in)
+		self.fail("streaming through reserve_contiguous and peek_contiguous changed the data");
+});
+
+[[maybe_unused]] test& spsc_ring_test = g_io_tests.make_test("spsc_ring", "Single-producer single-consumer ring under contention", [](test &self) {
+	constexpr size_t count = 1 << 20;
+
+	{
+		octahedron::spsc_ring<uint32_t, 256> ring;
+		std::jthread producer{[&ring]() {
+			std::array<uint32_t, 37> batch;
+			uint32_t next = 0;
+
+			while (next < count) {
+				if (next % 3 == 0) {
+					if (ring.push_back(next))
+						++next;
+					else
+						std::this_thread::yield();
+					continue;
+				}
+				size_t n = std::min<size_t>(batch.size(), count - next);
+
+				for (size_t i = 0; i < n; ++i)
+					batch[i] = next + static_cast<uint32_t>(i);
+				if (size_t written = ring.write(batch.data(), n); written > 0)
+					next += static_cast<uint32_t>(written);
+				else
+					std::this_thread::yield();
+			}
+		}};
+		std::array<uint32_t, 64> buf;
+		uint32_t expected = 0;
+
+		while (expected < count) {
+			size_t n = ring.read(buf, expected % 2 ? 1 : buf.size());
+
+			if (n == 0)
+				std::this_thread::yield();
+			for (size_t i = 0; i < n; ++i, ++expected) {
+				if (buf[i] != expected) {
+					self.fail(fmt::format("read {} where {} was expected", buf[i], expected));
+					producer.join();
+					return;
+				}
+			}
+		}
+		if (!ring.empty())
+			self.fail("ring not empty after reading everything");
+	}
+
+	std::array<lifetime_tracker, 4> data;
+	{
+		octahedron::spsc_ring<ref, 64> ring;
+		std::vector<ref> in;
+		std::vector<ref> out;
+
+		for (size_t i = 0; i < 100000; ++i)
+			in.emplace_back(data[i % data.size()]);
+		{
+			std::jthread producer{[&ring, &in]() {
+				for (size_t i = 0; i < in.size();) {
+					size_t batch = std::min<size_t>(1 + i % 7, in.size() - i);
+
+					if (size_t added = ring.append_range(std::ranges::subrange{std::make_move_iterator(in.begin() + i), std::make_move_iterator(in.begin() + i + batch)}); added > 0)
+						i += added;
+					else
+						std::this_thread::yield();
+				}
+			}};
+			std::array<ref, 16> buf;
+
+			while (out.size() < in.size()) {
+				size_t n = ring.read(buf);
+
+				if (n == 0)
+					std::this_thread::yield();
+				for (size_t i = 0; i < n; ++i)
+					out.push_back(std::move(buf[i]));
+			}
+		}
+		for (size_t i = 0; i < out.size(); ++i) {
+			if (out[i].t != &data[i % data.size()]) {
+				self.fail(fmt::format("object {} came out of order", i));
+				break;
+			}
+		}
+		in.clear();
+		for (size_t i = 0; i < data.size(); ++i) {
+			if (data[i].pass())
+				self.fail("objects destroyed while still held");
+		}
+		out.clear();
+
+		ring.emplace_back(data[0]);
+		ring.emplace_back(data[1]);
+		if (!ring.pop_front().has_value())
+			self.fail("pop_front failed on a non-empty ring");
+		if (!data[0].pass())
+			self.fail("pop_front failed to destroy object");
+	}
+	for (size_t i = 0; i < data.size(); ++i) {
+		if (!data[i].pass())
+			self.fail(fmt::format("failed to destroy object {}", i));
+	}
+});
+
+[[maybe_unused]] test& mpsc_ring_test = g_io_tests.make_test("mpsc_ring", "Multiple-producer single-consumer ring under contention", [](test &self) {
+	constexpr size_t producers = 4;
+	constexpr size_t per_producer = 1 << 18;
+
+	{
+		octahedron::mpsc_ring<uint64_t, 1024> ring;
+		std::vector<std::jthread> threads;
+
+		for (uint64_t id = 0; id < producers; ++id) {
+			threads.emplace_back([&ring, id]() {
+				std::array<uint64_t, 13> batch;
+				uint64_t next = 0;
+
+				while (next < per_producer) {
+					if (next % 2 == 0) {
+						if (ring.push_back((id << 32) | next))
+							++next;
+						else
+							std::this_thread::yield();
+						continue;
+					}
+					size_t n = std::min<size_t>(batch.size(), per_producer - next);
+
+					for (size_t i = 0; i < n; ++i)
+						batch[i] = (id << 32) | (next + i);
+					if (size_t written = ring.write(batch.data(), n); written > 0)
+						next += written;
+					else
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		std::array<uint64_t, producers> expected{};
+		std::array<uint64_t, 100> buf;
+		size_t total = 0;
+
+		while (total < producers * per_producer) {
+			size_t n = ring.read(buf);
+
+			if (n == 0)
+				std::this_thread::yield();
+			for (size_t i = 0; i < n; ++i) {
+				uint64_t id = buf[i] >> 32;
+
+				if (id >= producers || (buf[i] & 0xFFFFFFFF) != expected[id]) {
+					self.fail(fmt::format("producer {} value {} came out of order", id, buf[i] & 0xFFFFFFFF));
+					return;
+				}
+				++expected[id];
+			}
+			total += n;
+		}
+		if (!ring.empty())
+			self.fail("ring not empty after reading everything");
+	}
+
+	std::array<lifetime_tracker, producers> data;
+	{
+		octahedron::mpsc_ring<ref, 64> ring;
+		std::array<std::vector<ref>, producers> in;
+		std::vector<ref> out;
+
+		for (size_t id = 0; id < producers; ++id) {
+			for (size_t i = 0; i < 20000; ++i)
+				in[id].emplace_back(data[id]);
+		}
+		{
+			std::vector<std::jthread> threads;
+
+			for (size_t id = 0; id < producers; ++id) {
+				threads.emplace_back([&ring, &refs = in[id]]() {
+					for (size_t i = 0; i < refs.size();) {
+						size_t added;
+
+						if (i % 2 == 0) {
+							added = ring.push_back(std::move(refs[i]));
+						} else {
+							size_t batch = std::min<size_t>(1 + i % 5, refs.size() - i);
+
+							added = ring.append_range(std::ranges::subrange{std::make_move_iterator(refs.begin() + i), std::make_move_iterator(refs.begin() + i + batch)});
+						}
+						if (added > 0)
+							i += added;
+						else
+							std::this_thread::yield();
+					}
+				});
+			}
+			while (out.size() < producers * in[0].size()) {
+				if (auto r = ring.pop_front())
+					out.push_back(std::move(*r));
+				else
+					std::this_thread::yield();
+			}
+		}
+		for (auto &r : out) {
+			if (r.t == nullptr) {
+				self.fail("received a moved-from object");
+				break;
+			}
+		}
+		for (auto &refs : in)
+			refs.clear();
+		out.clear();
+
+		ring.emplace_back(data[0]);
+		ring.emplace_back(data[1]);
+	}
+	for (size_t i = 0; i < data.size(); ++i) {
+		if (!data[i].pass())
+			self.fail(fmt::format("failed to destroy object {}", i));
+	}
+});
 
+}
@@ -0,0 +1,91 @@
+#include "io/io.h"
+#include "tests.h"
+
+#include <array>
+#include <numeric>
+
+#include <io/serializer.h>
+
+using namespace octahedron::tests;
+
+[[maybe_unused]] test &chained_serializer_test = g_io_tests.make_test("chained_serializer", "Serializing across scattered buffers", [](test& self) {
+	using octahedron::endianness;
+
+	// odd sizes so that most values straddle a segment boundary
+	std::array<unsigned char, 3>  a{};
+	std::array<unsigned char, 5>  b{};
+	std::array<unsigned char, 1>  c{};
+	std::array<unsigned char, 16> d{};
+
+	octahedron::chained_serializer<unsigned char> out{std::span{a}, std::span{b}, std::span<unsigned char>{}, std::span{c}, std::span{d}};
+
+	if (out.size() != 25 || out.segments().size() != 4)
+		self.fail(fmt::format("size {} with {} segments instead of 25 with 4", out.size(), out.segments().size()));
+	if (!out.put(octahedron::uint16{0x0102}))
+		self.fail("failed to write a uint16");
+	if (!out.put<octahedron::uint32, endianness::big>(0x03040506u))
+		self.fail("failed to write a big endian uint32");
+	if (!out.put(1.5f))
+		self.fail("failed to write a float");
+	if (!out.put(std::array<char, 4>{'a', 'b', 'c', 'd'}))
+		self.fail("failed to write an array");
+	if (out.tell() != 14 || out.bytes_available() != 11)
+		self.fail(fmt::format("position {} with {} bytes left instead of 14 with 11", out.tell(), out.bytes_available()));
+	if (a[0] != 0x02 || a[1] != 0x01 || a[2] != 0x03 || b[0] != 0x04 || b[2] != 0x06 || d[3] != 'c')
+		self.fail("bytes did not land in the expected segments");
+
+	std::array<std::byte, 16> big;
+
+	std::ranges::fill(big, std::byte{0xFF});
+	if (out.write(std::span<const std::byte>{big}) != 11 || out.bytes_available() != 0)
+		self.fail("write past the last segment was not truncated");
+	if (out.put(octahedron::uint8{0}))
+		self.fail("write succeeded at the end of the last segment");
+
+	std::array<unsigned char, 2> e{};
+
+	out.append(std::span{e});
+	if (!out.put(octahedron::uint16{0x0708}) || e[0] != 0x08 || e[1] != 0x07)
+		self.fail("write to an appended segment failed");
+
+	octahedron::chained_serializer<const unsigned char> in{std::array<std::span<const unsigned char>, 5>{a, b, c, d, e}};
+	octahedron::uint16                                  u16{};
+	octahedron::uint32                                  u32{};
+	float                                               f{};
+	std::array<char, 4>                                 chars{};
+
+	if (!in.get(u16) || u16 != 0x0102)
+		self.fail(fmt::format("read uint16 {:#x} instead of 0x102", u16));
+	if (!in.get<octahedron::uint32, endianness::big>(u32) || u32 != 0x03040506u)
+		self.fail(fmt::format("read big endian uint32 {:#x} instead of 0x3040506", u32));
+	if (!in.get(f) || f != 1.5f)
+		self.fail(fmt::format("read float {} instead of 1.5", f));
+	if (!in.get(chars) || std::string_view{chars.data(), chars.size()} != "abcd")
+		self.fail("read the wrong array");
+
+	if (!in.seek(-2, SEEK_END) || !in.get(u16) || u16 != 0x0708)
+		self.fail("seek from the end failed");
+	if (!in.seek(-13, SEEK_CUR) || in.tell() != 14 || !in.get(u32) || u32 != 0xFFFFFFFF)
+		self.fail("relative seek failed");
+	if (!in.seek(100) || in.tell() != in.size() || in.get(u16))
+		self.fail("seek past the end was not clamped");
+	in.reset();
+	if (in.tell() != 0 || !in.get(u16) || u16 != 0x0102)
+		self.fail("reset failed");
+});
+
+[[maybe_unused]] test &serializer_test = g_io_tests.make_test("serializer", "Serializing into a contiguous buffer", [](test& self) {
+	std::array<unsigned char, 8> storage{};
+	octahedron::ucharbuf         buf{storage.data(), storage.size()};
+
+	if (!buf.put(octahedron::uint32{42}) || buf.tell() != 4 || buf.bytes_available() != 4)
+		self.fail(fmt::format("position {} with {} bytes left instead of 4 with 4", buf.tell(), buf.bytes_available()));
+	if (!buf.put(octahedron::uint32{43}) || buf.put(octahedron::uint8{0}))
+		self.fail("write past the end of the span was not refused");
+	buf.reset();
+
+	octahedron::uint32 value{};
+
+	if (!buf.get(value) || value != 42 || !buf.get(value) || value != 43)
+		self.fail("read back the wrong values");
+});
@@ -4,6 +4,8 @@
 #include <thread>
 #include <atomic>
 #include <condition_variable>
+#include <cstdlib>
+#include <mutex>
 
 #include <tools/math.h>
 
@@ -15,76 +17,265 @@ using timepoint = std::chrono::time_point<clock>;
 
 constexpr inline auto timeout_duration = std::chrono::seconds{60};
 
-struct dthread : std::thread {
-	using thread::thread;
-	using thread::operator=;
+struct options {
+	std::string          filter;
+	size_t               jobs{max(std::thread::hardware_concurrency(), 1u)};
+	std::chrono::seconds timeout{timeout_duration};
+};
 
-	~dthread(){
-		if (joinable())
-			detach();
-	}
+/**
+ * \brief A test picked to run, written by the worker running it and read by the main thread.
+ */
+struct test_run {
+	test                     *t{nullptr};
+	const test_suite         *suite{nullptr};
+	// deadline since the clock's epoch, 0 until the test starts
+	std::atomic<clock::rep>   deadline{0};
+	std::atomic<test::status> result{test::status::not_executed};
+	std::atomic<bool>         done{false};
+	// only used by the main thread
+	bool                      timed_out{false};
+};
+
+/**
+ * \brief State shared by the main thread and the workers.
+ *
+ * Never freed: a worker stuck in a test that timed out is abandoned, and may still refer to it when the process exits.
+ */
+struct runner {
+	std::deque<test_run>    runs;
+	// indices in `runs`, tests which can run in parallel first, then exclusive tests
+	std::vector<size_t>     order;
+	std::atomic<size_t>     next{0};
+	std::mutex              mutex;
+	std::condition_variable cv;
+	size_t                  completed{0};
+	std::chrono::seconds    timeout{timeout_duration};
 };
 
+/**
+ * \brief Runs the tests of `r.order` up to `end`, until there is none left to start.
+ */
+void work(runner &r, size_t end) {
+	size_t k = r.next.load();
+
+	// an abandoned worker may come back in a later phase, it must not take tests past the end of its own
+	while (k < end) {
+		if (!r.next.compare_exchange_weak(k, k + 1))
+			continue;
+
+		test_run &run = r.runs[r.order[k]];
+
+		run.deadline = (clock::now() + r.timeout).time_since_epoch().count();
+		run.t->run();
+		run.result = run.t->get_status();
+		run.done = true;
+		{
+			std::scoped_lock lock{r.mutex};
+
+			++r.completed;
+		}
+		r.cv.notify_all();
+		k = r.next.load();
+	}
+}
+
+/**
+ * \brief Matches `text` against a pattern where '*' is any sequence of characters and '?' any character.
+ */
+bool glob_match(std::string_view pattern, std::string_view text) {
+	size_t p = 0;
+	size_t t = 0;
+	size_t star = std::string_view::npos;
+	size_t star_text = 0;
+
+	while (t < text.size()) {
+		if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+			++p;
+			++t;
+		} else if (p < pattern.size() && pattern[p] == '*') {
+			star = p++;
+			star_text = t;
+		} else if (star != std::string_view::npos) {
+			p = star + 1;
+			t = ++star_text;
+		} else
+			return (false);
+	}
+	while (p < pattern.size() && pattern[p] == '*')
+		++p;
+	return (p == pattern.size());
+}
+
+/**
+ * \brief Returns whether a test is selected by the filter, matched against "name" and "suite/name".
+ *
+ * A filter without wildcards selects the tests containing it.
+ */
+bool is_selected(const options &opts, const test_suite &suite, const test &t) {
+	if (opts.filter.empty())
+		return (true);
+
+	std::string pattern = opts.filter;
+
+	if (pattern.find_first_of("*?") == std::string::npos)
+		pattern = "*" + pattern + "*";
+	return (glob_match(pattern, t.get_name()) || glob_match(pattern, suite.name + "/" + t.get_name()));
+}
+
+std::optional<options> parse_options(int argc, char *argv[]) {
+	options ret;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg{argv[i]};
+		bool             has_value = i + 1 < argc;
+
+		if (arg == "--filter" && has_value)
+			ret.filter = argv[++i];
+		else if (arg == "--jobs" && has_value)
+			ret.jobs = max(static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10)), size_t{1});
+		else if (arg == "--timeout" && has_value)
+			ret.timeout = std::chrono::seconds{max(std::strtol(argv[++i], nullptr, 10), 1l)};
+		else {
+			std::cerr << "usage: tests [--filter <pattern>] [--jobs <threads>] [--timeout <seconds per test>]\n";
+			return (std::nullopt);
+		}
+	}
+	return (ret);
+}
+
 }
 
 namespace tests = octahedron::tests;
 
 
-int main() {
+int main(int argc, char *argv[]) {
 	using tests::g_logger;
+	using octahedron::log_level;
+
 	g_logger.emplace(std::cout);
 
-	tests::timepoint start = tests::clock::now();
-	std::atomic max_time = (start + tests::timeout_duration).time_since_epoch().count();
-	std::atomic finished = false;
-	std::condition_variable cv;
+	auto opts = tests::parse_options(argc, argv);
+
+	if (!opts)
+		return (1);
 
-	auto th = tests::dthread([&] {
-		for (tests::test_suite &suite : tests::g_tests) {
-			for (tests::test &t : suite.tests) {
-				if (finished) { // aborted
-					return;
+	auto &r = *new tests::runner;
+
+	r.timeout = opts->timeout;
+	for (tests::test_suite &suite : tests::g_tests) {
+		for (tests::test &t : suite.tests) {
+			if (!tests::is_selected(*opts, suite, t))
+				continue;
+
+			auto &run = r.runs.emplace_back();
+
+			run.t = &t;
+			run.suite = &suite;
+		}
+	}
+	for (bool exclusive : {false, true}) {
+		for (size_t i = 0; i < r.runs.size(); ++i) {
+			if (r.runs[i].t->is_exclusive() == exclusive)
+				r.order.push_back(i);
+		}
+	}
+
+	size_t printed = 0;
+	size_t abandoned = 0;
+
+	// output is printed in registration order, as soon as a test and every test before it are done
+	auto print_ready = [&]() {
+		for (; printed < r.runs.size(); ++printed) {
+			tests::test_run &run = r.runs[printed];
+
+			if (run.timed_out) {
+				g_logger->log(log_level::BASIC, "{} {}: no result after {}s", tests::timeout, run.t->get_name(), r.timeout.count());
+				continue;
+			}
+			if (!run.done)
+				break;
+			for (const std::string &line : run.t->get_output())
+				g_logger->log(log_level::BASIC, line);
+		}
+	};
+
+	auto run_phase = [&](size_t begin, size_t end, size_t jobs) {
+		std::vector<std::thread> workers;
+		size_t                   timed_out = 0;
+		size_t                   seen = 0;
+
+		r.next = begin;
+		for (size_t i = 0; i < octahedron::min(jobs, end - begin); ++i)
+			workers.emplace_back(tests::work, std::ref(r), end);
+		while (true) {
+			{
+				std::unique_lock lock{r.mutex};
+
+				r.cv.wait_for(lock, std::chrono::milliseconds{100}, [&]() { return (r.completed != seen); });
+				seen = r.completed;
+			}
+
+			auto   now = tests::clock::now().time_since_epoch().count();
+			size_t finished = 0;
+
+			for (size_t k = begin; k < end; ++k) {
+				tests::test_run &run = r.runs[r.order[k]];
+
+				if (run.done || run.timed_out) {
+					++finished;
+					continue;
+				}
+
+				auto deadline = run.deadline.load();
+
+				if (deadline != 0 && now > deadline) {
+					// the worker is stuck in the test, it is left behind and replaced
+					run.timed_out = true;
+					++finished;
+					++timed_out;
+					workers.emplace_back(tests::work, std::ref(r), end);
 				}
-				max_time = (tests::clock::now() + tests::timeout_duration).time_since_epoch().count();
-				t.run();
 			}
+			print_ready();
+			if (finished == end - begin)
+				break;
 		}
-		finished = true;
-		cv.notify_all();
-	});
-
-	std::mutex m;
-	std::unique_lock l{m};
-	tests::timepoint timeout;
-
-	do {
-		timeout = tests::timepoint{tests::clock::duration{max_time.load()}};
-		cv.wait_until(l, timeout, [&]() -> bool {
-			return finished;
-		});
-	} while (!finished && tests::clock::now() < timeout);
-	if (!finished) {
-		finished = true;
-		g_logger->log(octahedron::log_level::BASIC, "Timing out suite");
-		std::this_thread::sleep_for(std::chrono::seconds(5));
-	}
+		for (std::thread &worker : workers) {
+			if (timed_out > 0)
+				worker.detach();
+			else
+				worker.join();
+		}
+		abandoned += timed_out;
+	};
 
-	using octahedron::log_level;
+	size_t parallel_count = 0;
+
+	while (parallel_count < r.order.size() && !r.runs[r.order[parallel_count]].t->is_exclusive())
+		++parallel_count;
+	run_phase(0, parallel_count, opts->jobs);
+	run_phase(parallel_count, r.order.size(), 1);
+	print_ready();
 
 	size_t total_failed = 0;
 	size_t total_count = 0;
+	size_t next_run = 0;
 	for (const tests::test_suite &suite : tests::g_tests) {
-		if (suite.tests.size() == 0)
-			continue;
 		size_t count = 0;
 		size_t failed = 0;
-		g_logger->log(log_level::BASIC, "\nSuite {}:", suite.name);
-		for (const tests::test &t : suite.tests) {
+
+		for (; next_run < r.runs.size() && r.runs[next_run].suite == &suite; ++next_run) {
 			static constexpr char fmt_str[] = "  {: <20}{: <24}{}";
 			using enum tests::test::status;
 
+			const tests::test_run &run = r.runs[next_run];
+			const tests::test     &t = *run.t;
+
+			if (count == 0)
+				g_logger->log(log_level::BASIC, "\nSuite {}:", suite.name);
 			++count;
-			switch (t.get_status()) {
+			switch (run.timed_out ? timeout : run.result.load()) {
 				case not_executed:
 					g_logger->log(log_level::BASIC, fmt_str, tests::not_executed, t.get_name(), t.get_description());
 					++failed;
@@ -110,6 +301,8 @@ int main() {
 					break;
 			}
 		}
+		if (count == 0)
+			continue;
 		g_logger->log(log_level::BASIC, "Completed {}: {:.2f}% success [{}/{}]\n", suite.name, octahedron::ratio{count - failed, count}.get_percent(), count - failed, count);
 		total_failed += failed;
 		total_count += count;
@@ -125,5 +318,10 @@ int main() {
 			total_count
 		);
 	}
+	if (abandoned > 0) {
+		// threads stuck in tests cannot be stopped, exiting without destroying the globals they may be using
+		std::cout.flush();
+		std::_Exit(static_cast<int>(total_failed));
+	}
 	return (total_failed);
 }
@@ -8,10 +8,10 @@ void tests::test::fail(std::string reason, const std::source_location &where) {
 	std::filesystem::path filepath{where.file_name()};
 
 	if (reason.empty()) {
-		g_logger->log(log_level::BASIC, "{} {} ({}/{}:{})", failure, name, filepath.parent_path().stem(), filepath.filename(), where.line());
+		log("{} {} ({}/{}:{})", failure, name, filepath.parent_path().stem(), filepath.filename(), where.line());
 	}
 	else {
-		g_logger->log(log_level::BASIC, "{} {} ({}/{}:{}): {}", failure, name, filepath.parent_path().stem(), filepath.filename(), where.line(), reason);
+		log("{} {} ({}/{}:{}): {}", failure, name, filepath.parent_path().stem(), filepath.filename(), where.line(), reason);
 	}
 	state = status::failure;
 }
@@ -19,31 +19,34 @@ void tests::test::fail(std::string reason, const std::source_location &where) {
 void tests::test::skip(){
 	if (state == status::not_executed || state == status::started) {
 		state = status::skipped;
-		g_logger->log(log_level::BASIC, "{} {}", skipped, name);
+		log("{} {}", skipped, name);
 	}
 }
 
 void tests::test::success() {
 	if (state != status::failure) {
 		state = status::success;
-		g_logger->log(log_level::BASIC, "{} {}", tests::success, name);
+		log("{} {}", tests::success, name);
 	}
 }
 
 void tests::test::run() {
 	if (state == status::skipped)
 		return;
-		g_logger->log(log_level::BASIC, "{} {}", tests::starting, name);
+	log("{} {}", tests::starting, name);
 	state = status::started;
 	try {
 		fun(*this);
 		success();
 	} catch (const test_failure_exception &e) {
-		g_logger->log(log_level::BASIC, "{} {}: {}", failure, name, e.format());
+		log("{} {}: {}", failure, name, e.format());
+		state = status::failure;
 	} catch (const std::exception &e) {
-		g_logger->log(log_level::BASIC, "{} {}: exception `{}`", failure, name, e.what());
+		log("{} {}: exception `{}`", failure, name, e.what());
+		state = status::failure;
 	} catch (...) {
-		g_logger->log(log_level::BASIC, "{} {}: exception (unknown)", failure, name);
+		log("{} {}: exception (unknown)", failure, name);
+		state = status::failure;
 	}
 }
 
@@ -60,6 +63,19 @@ auto tests::test::get_status() const noexcept -> status {
 	return (state);
 }
 
+auto tests::test::get_output() const noexcept -> const std::vector<std::string>& {
+	return (output);
+}
+
+auto tests::test::set_exclusive(bool value) noexcept -> test& {
+	exclusive = value;
+	return (*this);
+}
+
+bool tests::test::is_exclusive() const noexcept {
+	return (exclusive);
+}
+
 
 
 auto tests::make_test_suite(std::string name) -> test_suite & {
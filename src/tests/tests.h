@@ -1,6 +1,7 @@
 #ifndef OCTAHEDRON_TESTS_H_
 #define OCTAHEDRON_TESTS_H_
 
+#include <deque>
 #include <vector>
 #include <string_view>
 #include <string>
@@ -53,6 +54,16 @@ public:
 
 	~test() = default;
 
+	/**
+	 * \brief Adds a line to the output of the test, which is printed with the others in order once the test is done.
+	 *
+	 * Tests run in parallel, this is how they should log rather than through g_logger.
+	 */
+	template <typename... Args>
+	void log(fmt::format_string<Args...> fmt, Args&&... args) {
+		output.push_back(fmt::format(fmt, std::forward<Args>(args)...));
+	}
+
 	void fail(std::string reason = {}, const std::source_location &where = std::source_location::current());
 
 	void success();
@@ -67,11 +78,24 @@ public:
 
 	const std::string& get_description() const noexcept;
 
+	const std::vector<std::string>& get_output() const noexcept;
+
+	/**
+	 * \brief Makes the test run alone, after the others, for tests measuring time or changing process-wide state.
+	 *
+	 * Other tests run in parallel, so those working with files must do so in a temp_dir of their own.
+	 */
+	test& set_exclusive(bool value = true) noexcept;
+
+	bool is_exclusive() const noexcept;
+
 private:
 	std::string name = {};
 	std::string description = {};
 	std::function<void(test&)> fun = {};
 	status state = status::not_executed;
+	std::vector<std::string> output = {};
+	bool exclusive = false;
 };
 
 struct test_suite {
@@ -96,7 +120,8 @@ struct test_suite {
 	}
 };
 
-inline std::vector<test_suite> g_tests;
+// suites are referenced by the globals they are created into, a deque keeps them in place when more are added
+inline std::deque<test_suite> g_tests;
 
 inline std::optional<logger<std::ostream&>> g_logger;
 